@@ -5,20 +5,43 @@
 
 #pragma once
 
+#include "fplus/aggregate.h"
+#include "fplus/ascii.h"
+#include "fplus/bitvector.h"
 #include "fplus/compare.h"
 #include "fplus/composition.h"
 #include "fplus/container_common.h"
 #include "fplus/container_properties.h"
 #include "fplus/container_traits.h"
+#include "fplus/copy_audit.h"
+#include "fplus/copy_audit_macros.h"
+#include "fplus/eytzinger_index.h"
 #include "fplus/filter.h"
+#include "fplus/flat_hash_map.h"
+#include "fplus/flat_map.h"
 #include "fplus/generate.h"
+#include "fplus/joins.h"
 #include "fplus/maps.h"
 #include "fplus/maybe.h"
+#include "fplus/memoize.h"
 #include "fplus/numeric.h"
 #include "fplus/pairs.h"
+#include "fplus/parallel.h"
+#include "fplus/pipeline.h"
+#include "fplus/profiling.h"
+#include "fplus/profiling_macros.h"
 #include "fplus/replace.h"
+#include "fplus/rolling.h"
 #include "fplus/search.h"
+#include "fplus/serialize.h"
+#include "fplus/sets.h"
 #include "fplus/show.h"
+#include "fplus/simd.h"
+#include "fplus/small_vector.h"
+#include "fplus/soa_vector.h"
 #include "fplus/split.h"
+#include "fplus/static_vector.h"
+#include "fplus/string_pool.h"
 #include "fplus/string_tools.h"
+#include "fplus/top_k.h"
 #include "fplus/transform.h"
\ No newline at end of file
@@ -0,0 +1,188 @@
+// Copyright Tobias Hermann 2015.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include "container_common.h"
+#include "function_traits.h"
+#include "parallel.h"
+
+#include <iterator>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace fplus
+{
+
+// Streams the elements of [itBegin, itEnd) into the accumulators
+// of their keys, starting every new key with init.
+template <typename KeyF, typename FoldF, typename Acc,
+    typename MapOut, typename InputIt>
+void group_fold_on_into(KeyF& key_fn, FoldF& fold_fn, const Acc& init,
+    MapOut& result, InputIt itBegin, InputIt itEnd)
+{
+    for (auto it = itBegin; it != itEnd; ++it)
+    {
+        auto key = key_fn(*it);
+        auto found = result.find(key);
+        if (found == std::end(result))
+            found = result.emplace(std::move(key), init).first;
+        found->second = fold_fn(found->second, *it);
+    }
+}
+
+// group_fold_on(isEven, (+), 0, [1,2,3,4,5]) == {(false, 9), (true, 6)}
+// Hash aggregation: Every element is folded into the accumulator
+// of its key in one pass, without sorting or grouping beforehand.
+// The elements of every key are folded in input order,
+// so the result is the same as folding every group of
+// stable_sort_on(key_fn, xs) that has equal keys,
+// but the order of the keys in the map is unspecified for unordered maps.
+template <typename KeyF, typename FoldF, typename Acc, typename ContainerIn,
+    typename Key = std::remove_const_t<std::remove_reference_t<
+        typename utils::function_traits<KeyF>::result_type>>,
+    typename MapOut = std::unordered_map<Key, Acc>>
+MapOut group_fold_on(KeyF key_fn, FoldF fold_fn, const Acc& init,
+    const ContainerIn& xs)
+{
+    static_assert(utils::function_traits<KeyF>::arity == 1, "Wrong arity.");
+    static_assert(utils::function_traits<FoldF>::arity == 2, "Wrong arity.");
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
+    MapOut result;
+    group_fold_on_into(key_fn, fold_fn, init, result,
+        std::begin(xs), std::end(xs));
+    FPLUS_PROFILE_OUTPUT(size_of_cont(result));
+    return result;
+}
+
+// Multithreaded version of group_fold_on.
+// The input is cut into chunks, every chunk is aggregated
+// into its own partial table on the default work-stealing pool,
+// and the partial tables are combined with merge_fn (Acc, Acc) -> Acc
+// in the order of the chunks.
+// merge_fn must be associative and init has to be its neutral element,
+// e.g. (+) and 0.
+template <typename KeyF, typename FoldF, typename MergeF,
+    typename Acc, typename ContainerIn,
+    typename Key = std::remove_const_t<std::remove_reference_t<
+        typename utils::function_traits<KeyF>::result_type>>,
+    typename MapOut = std::unordered_map<Key, Acc>>
+MapOut group_fold_on_parallelly(KeyF key_fn, FoldF fold_fn, MergeF merge_fn,
+    const Acc& init, const ContainerIn& xs)
+{
+    static_assert(utils::function_traits<KeyF>::arity == 1, "Wrong arity.");
+    static_assert(utils::function_traits<FoldF>::arity == 2, "Wrong arity.");
+    static_assert(utils::function_traits<MergeF>::arity == 2, "Wrong arity.");
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
+    typedef typename ContainerIn::const_iterator It;
+    work_stealing_pool& pool = default_work_stealing_pool();
+    const std::size_t count = size_of_cont(xs);
+    const std::size_t chunkCount = std::max<std::size_t>(1,
+        std::min(count / 4096, 4 * pool.size()));
+    std::vector<It> bounds;
+    bounds.reserve(chunkCount + 1);
+    auto it = std::begin(xs);
+    for (std::size_t i = 0; i < chunkCount; ++i)
+    {
+        bounds.push_back(it);
+        std::advance(it, static_cast<std::ptrdiff_t>(
+            count / chunkCount + (i < count % chunkCount ? 1 : 0)));
+    }
+    bounds.push_back(std::end(xs));
+
+    std::vector<MapOut> partials(chunkCount);
+    parallel_for_idx(pool, chunkCount, 1, [&](std::size_t i)
+    {
+        KeyF chunkKeyF = key_fn;
+        FoldF chunkFoldF = fold_fn;
+        group_fold_on_into(chunkKeyF, chunkFoldF, init, partials[i],
+            bounds[i], bounds[i + 1]);
+    });
+
+    MapOut result = std::move(partials.front());
+    for (std::size_t i = 1; i < chunkCount; ++i)
+    {
+        for (auto& keyAndAcc : partials[i])
+        {
+            auto found = result.find(keyAndAcc.first);
+            if (found == std::end(result))
+                result.emplace(keyAndAcc.first, std::move(keyAndAcc.second));
+            else
+                found->second = merge_fn(found->second, keyAndAcc.second);
+        }
+    }
+    FPLUS_PROFILE_OUTPUT(size_of_cont(result));
+    return result;
+}
+
+// count_by_key(isEven, [1,2,3,4,5]) == {(false, 3), (true, 2)}
+template <typename KeyF, typename ContainerIn,
+    typename Key = std::remove_const_t<std::remove_reference_t<
+        typename utils::function_traits<KeyF>::result_type>>,
+    typename MapOut = std::unordered_map<Key, std::size_t>>
+MapOut count_by_key(KeyF key_fn, const ContainerIn& xs)
+{
+    typedef typename ContainerIn::value_type T;
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
+    auto count_one = [](std::size_t acc, const T&) { return acc + 1; };
+    return group_fold_on<KeyF, decltype(count_one), std::size_t,
+        ContainerIn, Key, MapOut>(key_fn, count_one, 0, xs);
+}
+
+// sum_by_key(fst, snd, [(1, 2), (2, 3), (1, 4)]) == {(1, 6), (2, 3)}
+template <typename KeyF, typename ValF, typename ContainerIn,
+    typename Key = std::remove_const_t<std::remove_reference_t<
+        typename utils::function_traits<KeyF>::result_type>>,
+    typename Val = std::remove_const_t<std::remove_reference_t<
+        typename utils::function_traits<ValF>::result_type>>,
+    typename MapOut = std::unordered_map<Key, Val>>
+MapOut sum_by_key(KeyF key_fn, ValF value_fn, const ContainerIn& xs)
+{
+    static_assert(utils::function_traits<ValF>::arity == 1, "Wrong arity.");
+    typedef typename ContainerIn::value_type T;
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
+    auto add_one = [value_fn](const Val& acc, const T& x)
+        { return acc + value_fn(x); };
+    return group_fold_on<KeyF, decltype(add_one), Val,
+        ContainerIn, Key, MapOut>(key_fn, add_one, Val(), xs);
+}
+
+// Multithreaded version of count_by_key.
+template <typename KeyF, typename ContainerIn,
+    typename Key = std::remove_const_t<std::remove_reference_t<
+        typename utils::function_traits<KeyF>::result_type>>,
+    typename MapOut = std::unordered_map<Key, std::size_t>>
+MapOut count_by_key_parallelly(KeyF key_fn, const ContainerIn& xs)
+{
+    typedef typename ContainerIn::value_type T;
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
+    auto count_one = [](std::size_t acc, const T&) { return acc + 1; };
+    auto add = [](std::size_t a, std::size_t b) { return a + b; };
+    return group_fold_on_parallelly<KeyF, decltype(count_one), decltype(add),
+        std::size_t, ContainerIn, Key, MapOut>(key_fn, count_one, add, 0, xs);
+}
+
+// Multithreaded version of sum_by_key.
+template <typename KeyF, typename ValF, typename ContainerIn,
+    typename Key = std::remove_const_t<std::remove_reference_t<
+        typename utils::function_traits<KeyF>::result_type>>,
+    typename Val = std::remove_const_t<std::remove_reference_t<
+        typename utils::function_traits<ValF>::result_type>>,
+    typename MapOut = std::unordered_map<Key, Val>>
+MapOut sum_by_key_parallelly(KeyF key_fn, ValF value_fn, const ContainerIn& xs)
+{
+    static_assert(utils::function_traits<ValF>::arity == 1, "Wrong arity.");
+    typedef typename ContainerIn::value_type T;
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
+    auto add_one = [value_fn](const Val& acc, const T& x)
+        { return acc + value_fn(x); };
+    auto add = [](const Val& a, const Val& b) { return a + b; };
+    return group_fold_on_parallelly<KeyF, decltype(add_one), decltype(add),
+        Val, ContainerIn, Key, MapOut>(key_fn, add_one, add, Val(), xs);
+}
+
+} // namespace fplus
@@ -0,0 +1,196 @@
+// Copyright Tobias Hermann 2015.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include "bitvector.h"
+#include "simd.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace fplus
+{
+
+// Character classes of the std::string fast paths in string_tools.h.
+// Bytes outside of ASCII belong to none of them,
+// like with the generic predicates.
+enum class ascii_class
+{
+    whitespace,
+    letter_or_digit,
+    line_break
+};
+
+template <ascii_class Class>
+bool ascii_is_in_class(char c)
+{
+    switch (Class)
+    {
+        case ascii_class::whitespace:
+            return c == ' ' || (c >= 9 && c < 14);
+        case ascii_class::letter_or_digit:
+            return (c >= '0' && c <= '9') || (c >= 'A' && c <= 'Z') ||
+                (c >= 'a' && c <= 'z');
+        case ascii_class::line_break:
+            return c == '\n' || c == '\r';
+    }
+    return false;
+}
+
+#ifdef FPLUS_SSE2
+// 0xff for the bytes in [low, low + count), 0 for the others.
+// SSE2 only compares signed bytes, so the range is shifted to start at -128.
+inline __m128i ascii_in_range_sse2(__m128i v, char low, int count)
+{
+    const __m128i shifted = _mm_xor_si128(
+        _mm_sub_epi8(v, _mm_set1_epi8(low)),
+        _mm_set1_epi8(static_cast<char>(-128)));
+    return _mm_cmplt_epi8(shifted, _mm_set1_epi8(static_cast<char>(count - 128)));
+}
+
+template <ascii_class Class>
+__m128i ascii_class_mask_sse2(__m128i v)
+{
+    switch (Class)
+    {
+        case ascii_class::whitespace:
+            return _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')),
+                ascii_in_range_sse2(v, 9, 5));
+        case ascii_class::letter_or_digit:
+            return _mm_or_si128(ascii_in_range_sse2(v, '0', 10),
+                ascii_in_range_sse2(_mm_or_si128(v, _mm_set1_epi8(0x20)), 'a', 26));
+        case ascii_class::line_break:
+            return _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\n')),
+                _mm_cmpeq_epi8(v, _mm_set1_epi8('\r')));
+    }
+    return _mm_setzero_si128();
+}
+
+// Bit i is set if the i-th of the 16 bytes is in the class.
+template <ascii_class Class>
+unsigned ascii_class_bits_16(const char* data)
+{
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+    return static_cast<unsigned>(_mm_movemask_epi8(ascii_class_mask_sse2<Class>(v)));
+}
+#endif
+
+// Bit i is set if data[i] is in the class, for count <= 64 bytes.
+template <ascii_class Class>
+std::uint64_t ascii_class_bits(const char* data, std::size_t count)
+{
+    std::uint64_t bits = 0;
+    std::size_t i = 0;
+#ifdef FPLUS_SSE2
+    for (; i + 16 <= count; i += 16)
+        bits |= std::uint64_t(ascii_class_bits_16<Class>(data + i)) << i;
+#endif
+    for (; i < count; ++i)
+        bits |= std::uint64_t(ascii_is_in_class<Class>(data[i]) ? 1 : 0) << i;
+    return bits;
+}
+
+// Calls f(runBegin, runEnd) for every maximal run of bytes of the class
+// in [data, data + size), classifying 64 bytes per step.
+template <ascii_class Class, typename F>
+void ascii_for_each_run(const char* data, std::size_t size, F f)
+{
+    bool inRun = false;
+    std::size_t runBegin = 0;
+    for (std::size_t base = 0; base < size; base += 64)
+    {
+        const std::size_t count = std::min<std::size_t>(64, size - base);
+        // The bits behind the end are zero, so they end a pending run.
+        const std::uint64_t inClass = ascii_class_bits<Class>(data + base, count);
+        std::size_t i = 0;
+        while (i < 64)
+        {
+            const std::uint64_t rest = (inRun ? ~inClass : inClass) >> i;
+            if (rest == 0)
+                break;
+            i += bitvector::count_trailing_zeros(rest);
+            if (inRun)
+                f(data + runBegin, data + base + i);
+            else
+                runBegin = base + i;
+            inRun = !inRun;
+        }
+    }
+    if (inRun)
+        f(data + runBegin, data + size);
+}
+
+// Index of the first byte in [first, size) that is (IsInClass)
+// or is not (!IsInClass) in the class, size if there is none.
+template <ascii_class Class, bool IsInClass>
+std::size_t ascii_find_first(const char* data, std::size_t first,
+    std::size_t size)
+{
+    std::size_t i = first;
+#ifdef FPLUS_SSE2
+    for (; i + 16 <= size; i += 16)
+    {
+        unsigned bits = ascii_class_bits_16<Class>(data + i);
+        if (!IsInClass)
+            bits = ~bits & 0xffff;
+        if (bits != 0)
+            return i + bitvector::count_trailing_zeros(bits);
+    }
+#endif
+    for (; i < size; ++i)
+    {
+        if (ascii_is_in_class<Class>(data[i]) == IsInClass)
+            return i;
+    }
+    return size;
+}
+
+// One past the index of the last byte in [0, size)
+// that is not in the class, 0 if there is none.
+template <ascii_class Class>
+std::size_t ascii_find_last_not_end(const char* data, std::size_t size)
+{
+    std::size_t i = size;
+#ifdef FPLUS_SSE2
+    for (; i >= 16; i -= 16)
+    {
+        if (ascii_class_bits_16<Class>(data + i - 16) != 0xffff)
+            break;
+    }
+#endif
+    for (; i > 0; --i)
+    {
+        if (!ascii_is_in_class<Class>(data[i - 1]))
+            return i;
+    }
+    return 0;
+}
+
+// Adds delta to the bytes in [low, low + 26), i.e. ASCII letters
+// of one case, leaving all other bytes unchanged.
+inline void ascii_shift_letters(char* data, std::size_t size,
+    char low, char delta)
+{
+    std::size_t i = 0;
+#ifdef FPLUS_SSE2
+    for (; i + 16 <= size; i += 16)
+    {
+        __m128i* ptr = reinterpret_cast<__m128i*>(data + i);
+        const __m128i v = _mm_loadu_si128(ptr);
+        const __m128i isLetter = ascii_in_range_sse2(v, low, 26);
+        _mm_storeu_si128(ptr, _mm_add_epi8(v,
+            _mm_and_si128(isLetter, _mm_set1_epi8(delta))));
+    }
+#endif
+    for (; i < size; ++i)
+    {
+        if (data[i] >= low && data[i] < low + 26)
+            data[i] = static_cast<char>(data[i] + delta);
+    }
+}
+
+} // namespace fplus
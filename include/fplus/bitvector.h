@@ -0,0 +1,332 @@
+// Copyright Tobias Hermann 2015.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <vector>
+
+namespace fplus
+{
+
+// Sequence of bools packed into 64-bit words.
+// all, any, none and count work on whole words (using popcount),
+// and the bitwise operators combine 64 elements per step,
+// so big boolean masks can be queried and merged
+// much faster than a std::vector<bool> bit by bit.
+// The bits behind size() in the last word are always zero.
+// transform_convert<bitvector>(is_even, [1, 2, 4]) == [false, true, true]
+class bitvector
+{
+public:
+    typedef bool value_type;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef std::uint64_t word_type;
+
+    // Random access like the iterators of std::vector<bool>,
+    // but dereferencing yields a plain bool instead of a real reference.
+    class const_iterator
+    {
+    public:
+        typedef std::random_access_iterator_tag iterator_category;
+        typedef bool value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const bool* pointer;
+        typedef bool reference;
+
+        const_iterator() : xs_(nullptr), idx_(0) {}
+        const_iterator(const bitvector* xs, std::size_t idx) :
+            xs_(xs), idx_(idx) {}
+
+        bool operator*() const { return (*xs_)[idx_]; }
+        bool operator[](difference_type n) const
+        {
+            return (*xs_)[idx_ + static_cast<std::size_t>(n)];
+        }
+        const_iterator& operator++() { ++idx_; return *this; }
+        const_iterator operator++(int) { auto old = *this; ++idx_; return old; }
+        const_iterator& operator--() { --idx_; return *this; }
+        const_iterator operator--(int) { auto old = *this; --idx_; return old; }
+        const_iterator& operator+=(difference_type n)
+        {
+            idx_ = static_cast<std::size_t>(
+                static_cast<difference_type>(idx_) + n);
+            return *this;
+        }
+        const_iterator& operator-=(difference_type n) { return *this += -n; }
+        const_iterator operator+(difference_type n) const
+        {
+            auto result = *this;
+            return result += n;
+        }
+        const_iterator operator-(difference_type n) const
+        {
+            auto result = *this;
+            return result -= n;
+        }
+        difference_type operator-(const const_iterator& other) const
+        {
+            return static_cast<difference_type>(idx_) -
+                static_cast<difference_type>(other.idx_);
+        }
+        bool operator==(const const_iterator& other) const
+        {
+            return idx_ == other.idx_;
+        }
+        bool operator!=(const const_iterator& other) const
+        {
+            return idx_ != other.idx_;
+        }
+        bool operator<(const const_iterator& other) const
+        {
+            return idx_ < other.idx_;
+        }
+        bool operator>(const const_iterator& other) const
+        {
+            return idx_ > other.idx_;
+        }
+        bool operator<=(const const_iterator& other) const
+        {
+            return idx_ <= other.idx_;
+        }
+        bool operator>=(const const_iterator& other) const
+        {
+            return idx_ >= other.idx_;
+        }
+        friend const_iterator operator+(difference_type n,
+            const const_iterator& it)
+        {
+            return it + n;
+        }
+
+    private:
+        const bitvector* xs_;
+        std::size_t idx_;
+    };
+    typedef const_iterator iterator;
+
+    static std::size_t word_bits() { return 64; }
+
+    static std::size_t word_count_for(std::size_t n)
+    {
+        return (n + word_bits() - 1) / word_bits();
+    }
+
+    bitvector() : words_(), size_(0) {}
+
+    explicit bitvector(std::size_t n, bool value = false) :
+        words_(word_count_for(n), value ? ~word_type(0) : word_type(0)),
+        size_(n)
+    {
+        clear_unused_bits();
+    }
+
+    bitvector(std::initializer_list<bool> xs) : bitvector()
+    {
+        reserve(xs.size());
+        for (bool x : xs)
+            push_back(x);
+    }
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, size_); }
+
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    void reserve(std::size_t n) { words_.reserve(word_count_for(n)); }
+
+    void clear()
+    {
+        words_.clear();
+        size_ = 0;
+    }
+
+    bool operator[](std::size_t i) const
+    {
+        return (words_[i / word_bits()] >> (i % word_bits())) & 1;
+    }
+
+    void set(std::size_t i, bool value)
+    {
+        const word_type bit = word_type(1) << (i % word_bits());
+        if (value)
+            words_[i / word_bits()] |= bit;
+        else
+            words_[i / word_bits()] &= ~bit;
+    }
+
+    void push_back(bool x)
+    {
+        if (size_ % word_bits() == 0)
+            words_.push_back(0);
+        words_.back() |= word_type(x ? 1 : 0) << (size_ % word_bits());
+        ++size_;
+    }
+
+    // Appends the lowest bitCount bits of word.
+    void push_back_word(word_type word, std::size_t bitCount)
+    {
+        assert(bitCount <= word_bits());
+        if (bitCount == 0)
+            return;
+        if (bitCount < word_bits())
+            word &= (word_type(1) << bitCount) - 1;
+        const std::size_t offset = size_ % word_bits();
+        if (offset == 0)
+            words_.push_back(word);
+        else
+        {
+            words_.back() |= word << offset;
+            if (offset + bitCount > word_bits())
+                words_.push_back(word >> (word_bits() - offset));
+        }
+        size_ += bitCount;
+    }
+
+    const std::vector<word_type>& words() const { return words_; }
+
+    // Number of set bits.
+    std::size_t count() const
+    {
+        std::size_t result = 0;
+        for (word_type word : words_)
+            result += popcount(word);
+        return result;
+    }
+
+    bool all() const
+    {
+        const std::size_t fullWords = size_ / word_bits();
+        for (std::size_t i = 0; i < fullWords; ++i)
+        {
+            if (words_[i] != ~word_type(0))
+                return false;
+        }
+        return size_ % word_bits() == 0 ||
+            words_.back() == tail_mask();
+    }
+
+    bool any() const
+    {
+        for (word_type word : words_)
+        {
+            if (word != 0)
+                return true;
+        }
+        return false;
+    }
+
+    bool none() const { return !any(); }
+
+    bitvector& operator&=(const bitvector& other)
+    {
+        assert(size_ == other.size_);
+        for (std::size_t i = 0; i < words_.size(); ++i)
+            words_[i] &= other.words_[i];
+        return *this;
+    }
+
+    bitvector& operator|=(const bitvector& other)
+    {
+        assert(size_ == other.size_);
+        for (std::size_t i = 0; i < words_.size(); ++i)
+            words_[i] |= other.words_[i];
+        return *this;
+    }
+
+    bitvector& operator^=(const bitvector& other)
+    {
+        assert(size_ == other.size_);
+        for (std::size_t i = 0; i < words_.size(); ++i)
+            words_[i] ^= other.words_[i];
+        return *this;
+    }
+
+    bitvector operator~() const
+    {
+        bitvector result = *this;
+        for (word_type& word : result.words_)
+            word = ~word;
+        result.clear_unused_bits();
+        return result;
+    }
+
+    bool operator==(const bitvector& other) const
+    {
+        return size_ == other.size_ && words_ == other.words_;
+    }
+
+    bool operator!=(const bitvector& other) const
+    {
+        return !(*this == other);
+    }
+
+    static std::size_t popcount(word_type word)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<std::size_t>(__builtin_popcountll(word));
+#else
+        word = word - ((word >> 1) & 0x5555555555555555ULL);
+        word = (word & 0x3333333333333333ULL) +
+            ((word >> 2) & 0x3333333333333333ULL);
+        word = (word + (word >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+        return static_cast<std::size_t>((word * 0x0101010101010101ULL) >> 56);
+#endif
+    }
+
+    static std::size_t count_trailing_zeros(word_type word)
+    {
+        assert(word != 0);
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<std::size_t>(__builtin_ctzll(word));
+#else
+        std::size_t result = 0;
+        while ((word & 1) == 0)
+        {
+            word >>= 1;
+            ++result;
+        }
+        return result;
+#endif
+    }
+
+private:
+    word_type tail_mask() const
+    {
+        return (word_type(1) << (size_ % word_bits())) - 1;
+    }
+
+    void clear_unused_bits()
+    {
+        if (size_ % word_bits() != 0)
+            words_.back() &= tail_mask();
+    }
+
+    std::vector<word_type> words_;
+    std::size_t size_;
+};
+
+inline bitvector operator&(bitvector xs, const bitvector& ys)
+{
+    return xs &= ys;
+}
+
+inline bitvector operator|(bitvector xs, const bitvector& ys)
+{
+    return xs |= ys;
+}
+
+inline bitvector operator^(bitvector xs, const bitvector& ys)
+{
+    return xs ^= ys;
+}
+
+} // namespace fplus
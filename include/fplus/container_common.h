@@ -8,10 +8,16 @@
 #include "container_traits.h"
 #include "maybe.h"
 #include "compare.h"
+#include "composition.h"
+#include "copy_audit_macros.h"
+#include "profiling_macros.h"
+#include "radix_sort.h"
 
 #include <algorithm>
 #include <cassert>
 #include <iterator>
+#include <utility>
+#include <vector>
 
 namespace fplus
 {
@@ -40,6 +46,16 @@ void check_binary_predicate_for_container()
     check_binary_predicate_for_type<BinaryPredicate, typename Container::value_type>();
 }
 
+// For results whose size is only known at runtime.
+// Filling a std::array from the front would leave the rest of it
+// default-initialized, so a static_vector has to be used instead.
+template <typename Container>
+void check_resizable_container()
+{
+    static_assert(!is_std_array<Container>::value,
+        "std::array can not shrink, use fplus::static_vector instead.");
+}
+
 // PrepareContainer and BackInserter are overloaded
 // to increase performance on std::vector and std::string
 // by using std::vector<T>::reserve
@@ -60,6 +76,44 @@ void prepare_container(std::vector<Y>& ys, std::size_t size)
     ys.reserve(size);
 }
 
+template <typename Y, std::size_t N>
+void prepare_container(static_vector<Y, N>& ys, std::size_t size)
+{
+    ys.reserve(size);
+}
+
+template <typename Y, std::size_t N>
+void prepare_container(small_vector<Y, N>& ys, std::size_t size)
+{
+    ys.reserve(size);
+}
+
+inline void prepare_container(bitvector& ys, std::size_t size)
+{
+    ys.reserve(size);
+}
+
+template <typename Key, typename Val, typename Hash, typename KeyEqual,
+    typename Alloc>
+void prepare_container(std::unordered_map<Key, Val, Hash, KeyEqual, Alloc>& ys,
+    std::size_t size)
+{
+    ys.reserve(size);
+}
+
+template <typename Key, typename Val, typename Compare>
+void prepare_container(flat_map<Key, Val, Compare>& ys, std::size_t size)
+{
+    ys.reserve(size);
+}
+
+template <typename Key, typename Val, typename Hash, typename KeyEqual>
+void prepare_container(flat_hash_map<Key, Val, Hash, KeyEqual>& ys,
+    std::size_t size)
+{
+    ys.reserve(size);
+}
+
 template <typename Container>
 void prepare_container(Container&, std::size_t)
 {
@@ -77,6 +131,69 @@ std::back_insert_iterator<Container> get_back_inserter(std::vector<Y>& ys)
     return std::back_inserter(ys);
 }
 
+template <typename Container, typename Y, std::size_t N>
+std::back_insert_iterator<Container> get_back_inserter(static_vector<Y, N>& ys)
+{
+    return std::back_inserter(ys);
+}
+
+template <typename Container, typename Y, std::size_t N>
+std::back_insert_iterator<Container> get_back_inserter(small_vector<Y, N>& ys)
+{
+    return std::back_inserter(ys);
+}
+
+template <typename Container = bitvector>
+std::back_insert_iterator<bitvector> get_back_inserter(bitvector& ys)
+{
+    return std::back_inserter(ys);
+}
+
+// std::array can not grow, so "inserting" at the back
+// means filling it from the front, one element after another.
+template <typename Y, std::size_t N>
+class array_back_insert_iterator
+{
+public:
+    typedef std::output_iterator_tag iterator_category;
+    typedef void value_type;
+    typedef void difference_type;
+    typedef void pointer;
+    typedef void reference;
+    explicit array_back_insert_iterator(std::array<Y, N>& ys) :
+        ys_(&ys), idx_(0) {}
+    array_back_insert_iterator& operator = (const Y& y)
+    {
+        assert(idx_ < N);
+        (*ys_)[idx_++] = y;
+        return *this;
+    }
+    array_back_insert_iterator& operator = (Y&& y)
+    {
+        assert(idx_ < N);
+        (*ys_)[idx_++] = std::move(y);
+        return *this;
+    }
+    array_back_insert_iterator& operator*() { return *this; }
+    array_back_insert_iterator& operator++() { return *this; }
+    array_back_insert_iterator& operator++(int) { return *this; }
+private:
+    std::array<Y, N>* ys_;
+    std::size_t idx_;
+};
+
+template <typename Container, typename Y, std::size_t N>
+array_back_insert_iterator<Y, N> get_back_inserter(std::array<Y, N>& ys)
+{
+    return array_back_insert_iterator<Y, N>(ys);
+}
+
+template <typename Y, std::size_t N>
+array_back_insert_iterator<Y, N> get_back_inserter(std::array<Y, N>& ys)
+{
+    return array_back_insert_iterator<Y, N>(ys);
+}
+
 template <typename Container>
 std::insert_iterator<Container> get_back_inserter(Container& ys)
 {
@@ -110,6 +227,7 @@ template <typename NewT, typename ContainerIn,
 ContainerOut convert_elems(const ContainerIn& xs)
 {
     static_assert(std::is_constructible<NewT, typename ContainerIn::value_type>::value, "Elements not convertible.");
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
     ContainerOut ys;
     prepare_container(ys, size_of_cont(xs));
     auto it = get_back_inserter<ContainerOut>(ys);
@@ -120,6 +238,7 @@ ContainerOut convert_elems(const ContainerIn& xs)
     {
         *it = NewT(x);
     }
+    FPLUS_PROFILE_OUTPUT(size_of_cont(ys));
     return ys;
 }
 
@@ -132,10 +251,12 @@ ContainerOut convert_container(const ContainerIn& xs)
     typedef typename ContainerOut::value_type DestElem;
     static_assert(std::is_same<DestElem, SourceElem>::value,
         "ConvertContainer: Source and dest container must have the same value_type");
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
     ContainerOut ys;
     prepare_container(ys, size_of_cont(xs));
     auto itOut = get_back_inserter<ContainerOut>(ys);
     std::copy(std::begin(xs), std::end(xs), itOut);
+    FPLUS_PROFILE_OUTPUT(size_of_cont(ys));
     return ys;
 }
 
@@ -147,6 +268,7 @@ ContainerOut convert(const ContainerIn& xs)
 {
     static_assert(std::is_convertible<typename ContainerIn::value_type, typename ContainerOut::value_type>::value, "Elements not convertible.");
     typedef typename ContainerOut::value_type DestElem;
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
     ContainerOut ys;
     prepare_container(ys, size_of_cont(xs));
     auto it = get_back_inserter<ContainerOut>(ys);
@@ -154,6 +276,7 @@ ContainerOut convert(const ContainerIn& xs)
     {
         *it = DestElem(x);
     }
+    FPLUS_PROFILE_OUTPUT(size_of_cont(ys));
     return ys;
 }
 
@@ -164,12 +287,14 @@ Container get_range
 {
     assert(idxBegin <= idxEnd);
     assert(idxEnd <= size_of_cont(xs));
+    FPLUS_PROFILE_SCOPE(idxEnd - idxBegin);
     Container result;
     auto itBegin = std::begin(xs);
     std::advance(itBegin, idxBegin);
     auto itEnd = itBegin;
     std::advance(itEnd, idxEnd - idxBegin);
     std::copy(itBegin, itEnd, get_back_inserter(result));
+    FPLUS_PROFILE_OUTPUT(idxEnd - idxBegin);
     return result;
 }
 
@@ -179,6 +304,8 @@ Container set_range
         (std::size_t idxBegin, Container& token, const Container& xs)
 {
     assert(idxBegin + size_of_cont(token) < size_of_cont(xs));
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
+    FPLUS_AUDIT_COPY(xs);
     Container result = xs;
     auto itBegin = std::begin(result);
     std::advance(itBegin, idxBegin);
@@ -193,6 +320,7 @@ Container remove_range
 {
     assert(idxBegin <= idxEnd);
     assert(idxEnd <= size_of_cont(xs));
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
 
     Container result;
     std::size_t length = idxEnd - idxBegin;
@@ -206,6 +334,7 @@ Container remove_range
     std::advance(secondBreakIt, length);
     std::copy(secondBreakIt, std::end(xs), get_back_inserter(result));
 
+    FPLUS_PROFILE_OUTPUT(size_of_cont(result));
     return result;
 }
 
@@ -215,6 +344,7 @@ Container insert_at(std::size_t idxBegin,
         const Container& token, const Container& xs)
 {
     assert(idxBegin <= size_of_cont(xs));
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs) + size_of_cont(token));
 
     Container result;
     prepare_container(result, size_of_cont(xs) + size_of_cont(token));
@@ -225,6 +355,7 @@ Container insert_at(std::size_t idxBegin,
     std::copy(std::begin(token), std::end(token), get_back_inserter(result));
     std::copy(breakIt, std::end(xs), get_back_inserter(result));
 
+    FPLUS_PROFILE_OUTPUT(size_of_cont(result));
     return result;
 }
 
@@ -234,6 +365,7 @@ Container replace_range(std::size_t idxBegin,
         const Container& token, const Container& xs)
 {
     std::size_t idxEnd = idxBegin + size_of_cont(token);
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
     return insert_at(idxBegin, token, remove_range(idxBegin, idxEnd, xs));
 }
 
@@ -251,8 +383,11 @@ template <typename Container>
 Container reverse(const Container& xs)
 {
     static_assert(has_order<Container>::value, "Reverse: Container has no order.");
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
+    FPLUS_AUDIT_COPY(xs);
     Container ys = xs;
     std::reverse(std::begin(ys), std::end(ys));
+    FPLUS_PROFILE_OUTPUT(size_of_cont(ys));
     return ys;
 }
 
@@ -263,11 +398,13 @@ template <typename F, typename Container,
     typename Acc = typename utils::function_traits<F>::template arg<0>::type>
 Acc fold_left(F f, const Acc& init, const Container& xs)
 {
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
     Acc acc = init;
     for (const auto& x : xs)
     {
         acc = f(acc, x);
     }
+    FPLUS_PROFILE_OUTPUT(1);
     return acc;
 }
 
@@ -278,6 +415,8 @@ template <typename F, typename Container,
     typename Acc = typename utils::function_traits<F>::template arg<1>::type>
 Acc fold_right(F f, const Acc& init, const Container& xs)
 {
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
+    FPLUS_AUDIT_COPY_SCOPE();
     return fold_left(flip(f), init, reverse(xs));
 }
 
@@ -289,6 +428,7 @@ template <typename F, typename ContainerIn,
     typename ContainerOut = typename same_cont_new_t<ContainerIn, Acc>::type>
 ContainerOut scan_left(F f, const Acc& init, const ContainerIn& xs)
 {
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
     ContainerOut result;
     prepare_container(result, size_of_cont(xs));
     auto itOut = get_back_inserter(result);
@@ -299,6 +439,7 @@ ContainerOut scan_left(F f, const Acc& init, const ContainerIn& xs)
         acc = f(acc, x);
         *itOut = acc;
     }
+    FPLUS_PROFILE_OUTPUT(size_of_cont(result));
     return result;
 }
 
@@ -310,6 +451,8 @@ template <typename F, typename ContainerIn,
     typename ContainerOut = typename same_cont_new_t<ContainerIn, Acc>::type>
 ContainerOut scan_right(F f, const Acc& init, const ContainerIn& xs)
 {
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
+    FPLUS_AUDIT_COPY_SCOPE();
     return reverse(scan_left(flip(f), init, reverse(xs)));
 }
 
@@ -317,12 +460,14 @@ ContainerOut scan_right(F f, const Acc& init, const ContainerIn& xs)
 template <typename Container>
 Container append(const Container& xs, const Container& ys)
 {
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs) + size_of_cont(ys));
     Container result;
     prepare_container(result, size_of_cont(xs) + size_of_cont(ys));
     std::copy(std::begin(xs), std::end(xs),
         get_back_inserter(result));
     std::copy(std::begin(ys), std::end(ys),
         get_back_inserter(result));
+    FPLUS_PROFILE_OUTPUT(size_of_cont(result));
     return result;
 }
 
@@ -332,19 +477,48 @@ template <typename ContainerIn,
     typename ContainerOut = typename ContainerIn::value_type>
 ContainerOut concat(const ContainerIn& xss)
 {
-    auto append_one = [](
-            const ContainerOut& acc,
-            const typename ContainerIn::value_type& xs)
-        { return append(acc, xs); };
-    return fold_left(append_one, ContainerOut(), xss);
+    std::size_t length = 0;
+    for (const auto& xs : xss)
+    {
+        length += size_of_cont(xs);
+    }
+    FPLUS_PROFILE_SCOPE(length);
+    ContainerOut result;
+    prepare_container(result, length);
+    auto itOut = get_back_inserter(result);
+    for (const auto& xs : xss)
+    {
+        itOut = std::copy(std::begin(xs), std::end(xs), itOut);
+    }
+    FPLUS_PROFILE_OUTPUT(length);
+    return result;
+}
+
+template <typename Container>
+void sort_in_place(Container& xs)
+{
+    std::sort(std::begin(xs), std::end(xs));
+}
+
+// Vectors of numbers and strings are radix sorted if they are large enough.
+template <typename T, typename Alloc>
+void sort_in_place(std::vector<T, Alloc>& xs)
+{
+    if (is_radix_sortable<T>::value && xs.size() >= radix_sort_min_size())
+        radix_sort_vector_if_possible(xs, is_radix_sortable<T>());
+    else
+        std::sort(std::begin(xs), std::end(xs));
 }
 
 // sort by std::less
 template <typename Container>
 Container sort(const Container& xs)
 {
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
+    FPLUS_AUDIT_COPY(xs);
     auto result = xs;
-    std::sort(std::begin(result), std::end(result));
+    sort_in_place(result);
+    FPLUS_PROFILE_OUTPUT(size_of_cont(result));
     return result;
 }
 
@@ -352,8 +526,11 @@ Container sort(const Container& xs)
 template <typename Compare, typename Container>
 Container sort_by(Compare comp, const Container& xs)
 {
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
+    FPLUS_AUDIT_COPY(xs);
     auto result = xs;
     std::sort(std::begin(result), std::end(result), comp);
+    FPLUS_PROFILE_OUTPUT(size_of_cont(result));
     return result;
 }
 
@@ -361,9 +538,12 @@ Container sort_by(Compare comp, const Container& xs)
 template <typename Container>
 Container unique(const Container& xs)
 {
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
+    FPLUS_AUDIT_COPY(xs);
     auto result = xs;
     auto last = std::unique(std::begin(result), std::end(result));
     result.erase(last, std::end(result));
+    FPLUS_PROFILE_OUTPUT(size_of_cont(result));
     return result;
 }
 
@@ -371,9 +551,12 @@ Container unique(const Container& xs)
 template <typename Container, typename BinaryPredicate>
 Container unique_by(BinaryPredicate p, const Container& xs)
 {
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
+    FPLUS_AUDIT_COPY(xs);
     auto result = xs;
     auto last = std::unique(std::begin(result), std::end(result), p);
     result.erase(last, std::end(result));
+    FPLUS_PROFILE_OUTPUT(size_of_cont(result));
     return result;
 }
 
@@ -382,6 +565,7 @@ template <typename Container,
     typename X = typename Container::value_type>
 Container intersperse(const X& value, const Container& xs)
 {
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
     if (xs.empty())
         return Container();
     if (size_of_cont(xs) == 1)
@@ -395,6 +579,7 @@ Container intersperse(const X& value, const Container& xs)
         *it = value;
     });
     *it = xs.back();
+    FPLUS_PROFILE_OUTPUT(size_of_cont(result));
     return result;
 }
 
@@ -404,6 +589,7 @@ template <typename Container,
     typename X = typename Container::value_type>
 X join(const X& separator, const Container& xs)
 {
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
     return concat(intersperse(separator, xs));
 }
 
@@ -427,6 +613,7 @@ bool contains(const typename Container::value_type& x, const Container& xs)
 template <typename Container, typename BinaryPredicate>
 Container nub_by(BinaryPredicate p, const Container& xs)
 {
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
     Container result;
     auto itOut = get_back_inserter(result);
     for (const auto &x : xs)
@@ -437,6 +624,7 @@ Container nub_by(BinaryPredicate p, const Container& xs)
             *itOut = x;
         }
     }
+    FPLUS_PROFILE_OUTPUT(size_of_cont(result));
     return result;
 }
 
@@ -448,4 +636,130 @@ Container nub(const Container& xs)
     return nub_by(pred, xs);
 }
 
-} // namespace fplus
\ No newline at end of file
+// Pairs of the key of every element and an iterator to the element.
+// The key function is called exactly once per element.
+template <typename F, typename Container,
+    typename Key = std::remove_const_t<std::remove_reference_t<
+        typename utils::function_traits<F>::result_type>>>
+std::vector<std::pair<Key, typename Container::const_iterator>>
+decorate_with_keys(F key_fn, const Container& xs)
+{
+    static_assert(utils::function_traits<F>::arity == 1, "Wrong arity.");
+    std::vector<std::pair<Key, typename Container::const_iterator>> result;
+    result.reserve(size_of_cont(xs));
+    for (auto it = std::begin(xs); it != std::end(xs); ++it)
+        result.emplace_back(key_fn(*it), it);
+    return result;
+}
+
+// Copies the elements the decorated iterators point to,
+// in the order of the decoration.
+template <typename Container, typename Decorated>
+Container undecorate_keys(const Decorated& decorated)
+{
+    Container result;
+    prepare_container(result, decorated.size());
+    auto itOut = get_back_inserter(result);
+    for (const auto& keyAndIt : decorated)
+        *itOut = *keyAndIt.second;
+    return result;
+}
+
+template <typename Decorated>
+bool is_less_by_decoration_key(const Decorated& x, const Decorated& y)
+{
+    return x.first < y.first;
+}
+
+// sort_on(size, ["abc", "d", "ef"]) == ["d", "ef", "abc"]
+// Sorts by the keys key_fn returns for the elements.
+// Unlike with sort_by(is_less_by(key_fn), xs), the key is calculated
+// only once per element, and during sorting only the keys are moved.
+template <typename F, typename Container>
+Container sort_on(F key_fn, const Container& xs)
+{
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
+    auto decorated = decorate_with_keys(key_fn, xs);
+    std::sort(std::begin(decorated), std::end(decorated),
+        is_less_by_decoration_key<typename decltype(decorated)::value_type>);
+    FPLUS_PROFILE_OUTPUT(decorated.size());
+    return undecorate_keys<Container>(decorated);
+}
+
+// stable_sort_on(size, ["ab", "c", "de", "f"]) == ["c", "f", "ab", "de"]
+// Like sort_on, but elements with equal keys keep their order.
+template <typename F, typename Container>
+Container stable_sort_on(F key_fn, const Container& xs)
+{
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
+    auto decorated = decorate_with_keys(key_fn, xs);
+    std::stable_sort(std::begin(decorated), std::end(decorated),
+        is_less_by_decoration_key<typename decltype(decorated)::value_type>);
+    FPLUS_PROFILE_OUTPUT(decorated.size());
+    return undecorate_keys<Container>(decorated);
+}
+
+// unique_on(abs, [1,-1,2,3,-3,1]) == [1,2,3,1]
+// Removes consecutive elements with the same key,
+// calculating the key only once per element.
+template <typename F, typename Container>
+Container unique_on(F key_fn, const Container& xs)
+{
+    static_assert(utils::function_traits<F>::arity == 1, "Wrong arity.");
+    typedef std::remove_const_t<std::remove_reference_t<
+        typename utils::function_traits<F>::result_type>> Key;
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
+    Container result;
+    if (is_empty(xs))
+        return result;
+    auto itOut = get_back_inserter(result);
+    auto it = std::begin(xs);
+    Key lastKey = key_fn(*it);
+    *itOut = *it;
+    for (++it; it != std::end(xs); ++it)
+    {
+        Key key = key_fn(*it);
+        if (!(key == lastKey))
+        {
+            *itOut = *it;
+            lastKey = std::move(key);
+        }
+    }
+    FPLUS_PROFILE_OUTPUT(size_of_cont(result));
+    return result;
+}
+
+// nub_on(abs, [1,-1,2,-2,3,1]) == [1,2,3]
+// Keeps only the first element of every key, calculating the key
+// only once per element. Keys must be comparable with operator<.
+// Runs in O(n * log(n)) instead of the O(n^2) of nub_by.
+template <typename F, typename Container>
+Container nub_on(F key_fn, const Container& xs)
+{
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
+    auto decorated = decorate_with_keys(key_fn, xs);
+    const std::size_t count = decorated.size();
+    std::vector<std::size_t> idxs(count);
+    for (std::size_t i = 0; i < count; ++i)
+        idxs[i] = i;
+    std::stable_sort(std::begin(idxs), std::end(idxs),
+        [&decorated](std::size_t a, std::size_t b)
+        { return decorated[a].first < decorated[b].first; });
+    std::vector<bool> keep(count, false);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        keep[idxs[i]] = i == 0 ||
+            decorated[idxs[i - 1]].first < decorated[idxs[i]].first;
+    }
+    Container result;
+    auto itOut = get_back_inserter(result);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        if (keep[i])
+            *itOut = *decorated[i].second;
+    }
+    FPLUS_PROFILE_OUTPUT(size_of_cont(result));
+    return result;
+}
+
+} // namespace fplus
@@ -67,6 +67,11 @@ bool none(const Container& xs)
     return none_by(identity<T>, xs);
 }
 
+// Word-wise versions for packed bits.
+inline bool all(const bitvector& xs) { return xs.all(); }
+inline bool any(const bitvector& xs) { return xs.any(); }
+inline bool none(const bitvector& xs) { return xs.none(); }
+
 // minimum_by(length, ["123", "12", "1234", "123"]) -> "12"
 template <typename Compare, typename Container>
 typename Container::value_type minimum_by(Compare comp,
@@ -124,6 +129,9 @@ template <typename X>
 X median(std::vector<X> xs)
 {
     assert(is_not_empty(xs));
+    FPLUS_AUDIT_COPY_SCOPE();
+    // xs is taken by value.
+    FPLUS_AUDIT_COPY(xs);
 
     if (size_of_cont(xs) == 1)
         return xs.front();
@@ -290,4 +298,12 @@ std::size_t count
     return size_of_cont(find_all_idxs_of(x, xs));
 }
 
+// count(true, bitvector([true, false, true])) == 2
+// Uses popcount on whole words.
+inline std::size_t count(bool x, const bitvector& xs)
+{
+    const std::size_t setCount = xs.count();
+    return x ? setCount : xs.size() - setCount;
+}
+
 } // namespace fplus
\ No newline at end of file
@@ -5,6 +5,12 @@
 
 #pragma once
 
+#include "bitvector.h"
+#include "flat_hash_map.h"
+#include "flat_map.h"
+#include "small_vector.h"
+#include "static_vector.h"
+
 #include <array>
 #include <deque>
 #include <forward_list>
@@ -14,6 +20,7 @@
 #include <queue>
 #include <set>
 #include <stack>
+#include <string>
 #include <vector>
 
 namespace fplus
@@ -29,6 +36,13 @@ template<class T, class Container> struct has_order<std::stack<T, Container>> :
 template<class T, class Container> struct has_order<std::queue<T, Container>> : public std::true_type {};
 template<class T, class Container, class Compare> struct has_order<std::priority_queue<T, Container, Compare>> : public std::false_type {};
 template<class CharT, class Traits, class Alloc> struct has_order<std::basic_string<CharT, Traits, Alloc>> : public std::true_type {};
+template<class T, std::size_t N> struct has_order<static_vector<T, N>> : public std::true_type {};
+template<class T, std::size_t N> struct has_order<small_vector<T, N>> : public std::true_type {};
+template<> struct has_order<bitvector> : public std::true_type {};
+
+// std::array can not change its size.
+template<class T> struct is_std_array : public std::false_type {};
+template<class T, std::size_t N> struct is_std_array<std::array<T, N>> : public std::true_type {};
 
 //http://stackoverflow.com/a/33828321/1866775
 template <class T, class NewP>
@@ -37,10 +51,41 @@ template <template <class...> class T, class... TPs, class NewP>
 struct same_cont_new_t<T<TPs...>, NewP> {
     using type = T<NewP>;
 };
+// Containers with a compile-time size keep it.
+template <class T, std::size_t N, class NewP>
+struct same_cont_new_t<std::array<T, N>, NewP> {
+    using type = std::array<NewP, N>;
+};
+template <class T, std::size_t N, class NewP>
+struct same_cont_new_t<static_vector<T, N>, NewP> {
+    using type = static_vector<NewP, N>;
+};
+template <class T, std::size_t N, class NewP>
+struct same_cont_new_t<small_vector<T, N>, NewP> {
+    using type = small_vector<NewP, N>;
+};
+// Bits stay packed, other elements need a normal vector.
+template <class NewP>
+struct same_cont_new_t<bitvector, NewP> {
+    using type = std::vector<NewP>;
+};
+template <>
+struct same_cont_new_t<bitvector, bool> {
+    using type = bitvector;
+};
 
 template<class Cont, class NewKey, class NewVal> struct SameMapTypeNewTypes : public std::false_type {};
 template<class Key, class T, class Compare, class Alloc, class NewKey, class NewVal> struct SameMapTypeNewTypes<std::map<Key, T, Compare, Alloc>, NewKey, NewVal> { typedef typename std::map<NewKey, NewVal> type; };
 template<class Key, class T, class Compare, class Alloc, class NewKey, class NewVal> struct SameMapTypeNewTypes<std::unordered_map<Key, T, Compare, Alloc>, NewKey, NewVal> { typedef typename std::unordered_map<NewKey, NewVal> type; };
+template<class Key, class T, class Compare, class NewKey, class NewVal> struct SameMapTypeNewTypes<flat_map<Key, T, Compare>, NewKey, NewVal> { typedef flat_map<NewKey, NewVal> type; };
+template<class Key, class T, class Hash, class KeyEqual, class NewKey, class NewVal> struct SameMapTypeNewTypes<flat_hash_map<Key, T, Hash, KeyEqual>, NewKey, NewVal> { typedef flat_hash_map<NewKey, NewVal> type; };
+
+// Keeps the comparator or hasher, since the key type does not change.
+template<class Cont, class NewVal> struct SameMapTypeNewVal : public std::false_type {};
+template<class Key, class T, class Compare, class Alloc, class NewVal> struct SameMapTypeNewVal<std::map<Key, T, Compare, Alloc>, NewVal> { typedef typename std::map<Key, NewVal, Compare> type; };
+template<class Key, class T, class Hash, class KeyEqual, class Alloc, class NewVal> struct SameMapTypeNewVal<std::unordered_map<Key, T, Hash, KeyEqual, Alloc>, NewVal> { typedef typename std::unordered_map<Key, NewVal, Hash, KeyEqual> type; };
+template<class Key, class T, class Compare, class NewVal> struct SameMapTypeNewVal<flat_map<Key, T, Compare>, NewVal> { typedef flat_map<Key, NewVal, Compare> type; };
+template<class Key, class T, class Hash, class KeyEqual, class NewVal> struct SameMapTypeNewVal<flat_hash_map<Key, T, Hash, KeyEqual>, NewVal> { typedef flat_hash_map<Key, NewVal, Hash, KeyEqual> type; };
 
 template<
     typename ContIn,
@@ -0,0 +1,211 @@
+// Copyright Tobias Hermann 2015.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include "copy_audit_macros.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace fplus
+{
+
+inline bool copy_audit_enabled()
+{
+#ifdef FPLUS_AUDIT_COPIES
+    return true;
+#else
+    return false;
+#endif
+}
+
+// bytes counts the elements shallowly, i.e. elements * sizeof(element).
+struct copy_audit_entry
+{
+    std::size_t copies;
+    std::size_t elements;
+    std::size_t bytes;
+};
+
+// Outermost audited function currently running on this thread,
+// so copies made by helpers are attributed to the call that caused them,
+// e.g. "trim_right > reverse".
+inline const char*& copy_audit_outer_function()
+{
+    static thread_local const char* name = nullptr;
+    return name;
+}
+
+// Copies recorded on this thread, used by copy_budget.
+inline copy_audit_entry& copy_audit_thread_totals()
+{
+    static thread_local copy_audit_entry totals = {0, 0, 0};
+    return totals;
+}
+
+class copy_audit_scope
+{
+public:
+    explicit copy_audit_scope(const char* function) :
+        isOuter_(copy_audit_outer_function() == nullptr)
+    {
+        if (isOuter_)
+            copy_audit_outer_function() = function;
+    }
+    copy_audit_scope(const copy_audit_scope&) = delete;
+    copy_audit_scope& operator=(const copy_audit_scope&) = delete;
+    ~copy_audit_scope()
+    {
+        if (isOuter_)
+            copy_audit_outer_function() = nullptr;
+    }
+
+private:
+    bool isOuter_;
+};
+
+// Thread-safe tally of the whole-container copies per function.
+// Copies of containers smaller than the threshold are ignored.
+class copy_audit_log
+{
+public:
+    copy_audit_log() : mutex_(), entries_(), threshold_(1024) {}
+    copy_audit_log(const copy_audit_log&) = delete;
+    copy_audit_log& operator=(const copy_audit_log&) = delete;
+
+    void set_threshold(std::size_t minElements)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        threshold_ = minElements;
+    }
+
+    std::size_t threshold() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return threshold_;
+    }
+
+    template <typename Container>
+    void record(const char* function, const Container& xs)
+    {
+        record_copy(function, xs.size(),
+            xs.size() * sizeof(typename Container::value_type));
+    }
+
+    void record_copy(const char* function,
+        std::size_t elements, std::size_t bytes)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (elements < threshold_)
+            return;
+        const char* outer = copy_audit_outer_function();
+        std::string name = outer && std::string(outer) != function ?
+            std::string(outer) + " > " + function : std::string(function);
+        add(entries_[name], elements, bytes);
+        add(copy_audit_thread_totals(), elements, bytes);
+    }
+
+    std::map<std::string, copy_audit_entry> entries() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return entries_;
+    }
+
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries_.clear();
+    }
+
+    // One line per function, the most copied elements first.
+    std::string report() const
+    {
+        const auto byName = entries();
+        std::vector<std::pair<std::string, copy_audit_entry>> rows(
+            std::begin(byName), std::end(byName));
+        std::stable_sort(std::begin(rows), std::end(rows),
+            [](const auto& x, const auto& y)
+            { return x.second.elements > y.second.elements; });
+        std::ostringstream out;
+        out << std::left << std::setw(40) << "function" << std::right
+            << std::setw(10) << "copies" << std::setw(16) << "elements"
+            << std::setw(16) << "bytes" << "\n";
+        for (const auto& row : rows)
+        {
+            out << std::left << std::setw(40) << row.first << std::right
+                << std::setw(10) << row.second.copies
+                << std::setw(16) << row.second.elements
+                << std::setw(16) << row.second.bytes << "\n";
+        }
+        return out.str();
+    }
+
+private:
+    static void add(copy_audit_entry& entry,
+        std::size_t elements, std::size_t bytes)
+    {
+        entry.copies += 1;
+        entry.elements += elements;
+        entry.bytes += bytes;
+    }
+
+    mutable std::mutex mutex_;
+    std::map<std::string, copy_audit_entry> entries_;
+    std::size_t threshold_;
+};
+
+inline copy_audit_log& default_copy_audit_log()
+{
+    static copy_audit_log log;
+    return log;
+}
+
+// Counts the copies recorded on the current thread during its lifetime,
+// so tests can assert copy budgets of pipelines:
+// copy_budget budget(2);
+// run_pipeline(xs);
+// assert(!budget.exceeded());
+// Without FPLUS_AUDIT_COPIES no copies are recorded,
+// so every budget holds.
+class copy_budget
+{
+public:
+    explicit copy_budget(std::size_t maxCopies,
+            std::size_t maxElements = std::numeric_limits<std::size_t>::max()) :
+        maxCopies_(maxCopies), maxElements_(maxElements),
+        start_(copy_audit_thread_totals())
+    {
+    }
+
+    std::size_t copies() const
+    {
+        return copy_audit_thread_totals().copies - start_.copies;
+    }
+
+    std::size_t elements() const
+    {
+        return copy_audit_thread_totals().elements - start_.elements;
+    }
+
+    bool exceeded() const
+    {
+        return copies() > maxCopies_ || elements() > maxElements_;
+    }
+
+private:
+    std::size_t maxCopies_;
+    std::size_t maxElements_;
+    copy_audit_entry start_;
+};
+
+} // namespace fplus
@@ -0,0 +1,22 @@
+// Copyright Tobias Hermann 2015.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+// Compiling with FPLUS_AUDIT_COPIES defined makes the fplus functions
+// that copy their whole input report these copies
+// to the default_copy_audit_log (see copy_audit.h).
+// Without it the macros expand to nothing,
+// and the log is not included.
+#ifdef FPLUS_AUDIT_COPIES
+#include "copy_audit.h"
+#define FPLUS_AUDIT_COPY(xs) \
+    ::fplus::default_copy_audit_log().record(__func__, (xs))
+#define FPLUS_AUDIT_COPY_SCOPE() \
+    ::fplus::copy_audit_scope fplus_copy_audit_scope_(__func__)
+#else
+#define FPLUS_AUDIT_COPY(xs) ((void)0)
+#define FPLUS_AUDIT_COPY_SCOPE() ((void)0)
+#endif
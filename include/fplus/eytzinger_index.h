@@ -0,0 +1,136 @@
+// Copyright Tobias Hermann 2015.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include "maybe.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+namespace fplus
+{
+
+// Frozen search index over a sorted container.
+// The elements are stored in Eytzinger (breadth-first) order:
+// the root at position 1, the children of k at 2k and 2k+1.
+// The first levels of the search all fall into the same few cache lines,
+// the loop has no data-dependent branches,
+// and the nodes four levels below are prefetched while comparing,
+// which makes lookups in big tables considerably faster
+// than std::lower_bound on the sorted array.
+// eytzinger_index<int> idx([1, 3, 4, 4, 9]);
+// idx.lower_bound_idx(4) == 2
+// idx.find_idx(5) == Nothing
+template <typename T>
+class eytzinger_index
+{
+public:
+    eytzinger_index() : tree_(1), sortedIdxs_(1) {}
+
+    // xs must be sorted by operator<.
+    template <typename Container>
+    explicit eytzinger_index(const Container& xs) :
+        tree_(1), sortedIdxs_(1)
+    {
+        assert(std::is_sorted(std::begin(xs), std::end(xs)));
+        std::vector<T> sorted(std::begin(xs), std::end(xs));
+        tree_.resize(sorted.size() + 1);
+        sortedIdxs_.resize(sorted.size() + 1);
+        std::size_t i = 0;
+        fill(sorted, i, 1);
+    }
+
+    std::size_t size() const { return tree_.size() - 1; }
+
+    // Index the first element not less than x had in the sorted input,
+    // or size() if there is none.
+    std::size_t lower_bound_idx(const T& x) const
+    {
+        const std::size_t k = lower_bound_pos(x);
+        return k == 0 ? size() : sortedIdxs_[k];
+    }
+
+    bool contains(const T& x) const
+    {
+        const std::size_t k = lower_bound_pos(x);
+        return k != 0 && !(x < tree_[k]);
+    }
+
+    // Index of the first occurrence of x in the sorted input, if any.
+    maybe<std::size_t> find_idx(const T& x) const
+    {
+        const std::size_t k = lower_bound_pos(x);
+        if (k == 0 || x < tree_[k])
+            return nothing<std::size_t>();
+        return just(sortedIdxs_[k]);
+    }
+
+private:
+    // In-order traversal of the implicit tree
+    // assigns the sorted elements to the positions.
+    void fill(const std::vector<T>& sorted, std::size_t& i, std::size_t k)
+    {
+        if (k >= tree_.size())
+            return;
+        fill(sorted, i, 2 * k);
+        tree_[k] = sorted[i];
+        sortedIdxs_[k] = i;
+        ++i;
+        fill(sorted, i, 2 * k + 1);
+    }
+
+    // Number of descendants 4 levels down, sharing one cache line
+    // if T is 4 bytes.
+    static std::size_t prefetch_distance() { return 16; }
+
+    static std::size_t count_trailing_ones(std::size_t k)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<std::size_t>(__builtin_ctzll(
+            ~static_cast<unsigned long long>(k)));
+#else
+        std::size_t count = 0;
+        while (k & 1)
+        {
+            k >>= 1;
+            ++count;
+        }
+        return count;
+#endif
+    }
+
+    // Position of the lower bound in the tree, 0 if there is none.
+    std::size_t lower_bound_pos(const T& x) const
+    {
+        const std::size_t n = size();
+        const T* tree = tree_.data();
+        std::size_t k = 1;
+        while (k <= n)
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            // Computed as integer, since the address may lie
+            // behind the end of the tree near the leaves.
+            // Prefetching invalid addresses does no harm.
+            __builtin_prefetch(reinterpret_cast<const void*>(
+                reinterpret_cast<std::uintptr_t>(tree) +
+                prefetch_distance() * k * sizeof(T)));
+#endif
+            k = 2 * k + static_cast<std::size_t>(tree[k] < x);
+        }
+        // The path went right after the last node not less than x,
+        // so cancel the trailing right turns and the final left one.
+        return k >> (count_trailing_ones(k) + 1);
+    }
+
+    std::vector<T> tree_;
+    std::vector<std::size_t> sortedIdxs_;
+};
+
+} // namespace fplus
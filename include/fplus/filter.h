@@ -5,9 +5,13 @@
 
 #pragma once
 
+#include "copy_audit_macros.h"
 #include "maybe.h"
+#include "profiling_macros.h"
 
 #include <algorithm>
+#include <cassert>
+#include <iterator>
 
 namespace fplus
 {
@@ -18,9 +22,12 @@ template <typename Pred, typename Container>
 Container keep_if(Pred pred, const Container& xs)
 {
     check_unary_predicate_for_container<Pred, Container>();
+    check_resizable_container<Container>();
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
     Container result;
     auto it = get_back_inserter<Container>(result);
     std::copy_if(std::begin(xs), std::end(xs), it, pred);
+    FPLUS_PROFILE_OUTPUT(size_of_cont(result));
     return result;
 }
 
@@ -48,6 +55,8 @@ template <typename Pred, typename Container>
 Container keep_if_with_idx(Pred pred, const Container& xs)
 {
     check_index_with_type_predicate_for_container<Pred, Container>();
+    check_resizable_container<Container>();
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
     Container ys;
     auto it = get_back_inserter<Container>(ys);
     std::size_t idx = 0;
@@ -56,6 +65,7 @@ Container keep_if_with_idx(Pred pred, const Container& xs)
         if (pred(idx++, x))
             *it = x;
     }
+    FPLUS_PROFILE_OUTPUT(size_of_cont(ys));
     return ys;
 }
 
@@ -73,6 +83,8 @@ template <typename UnaryPredicate, typename Container>
 Container keep_by_idx(UnaryPredicate pred, const Container& xs)
 {
     check_unary_predicate_for_type<UnaryPredicate, std::size_t>();
+    check_resizable_container<Container>();
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
     Container ys;
     auto it = get_back_inserter<Container>(ys);
     std::size_t idx = 0;
@@ -81,6 +93,7 @@ Container keep_by_idx(UnaryPredicate pred, const Container& xs)
         if (pred(idx++))
             *it = x;
     }
+    FPLUS_PROFILE_OUTPUT(size_of_cont(ys));
     return ys;
 }
 
@@ -92,6 +105,43 @@ Container drop_by_idx(UnaryPredicate pred, const Container& xs)
     return keep_by_idx(logical_not(pred), xs);
 }
 
+// keep_if_by_mask([true, false, true], [1, 2, 3]) == [1, 3]
+// Keeps the elements whose bit in the mask is set.
+// Only the set bits are visited, so sparse masks are cheap.
+template <typename Container>
+Container keep_if_by_mask(const bitvector& mask, const Container& xs)
+{
+    check_resizable_container<Container>();
+    assert(mask.size() == size_of_cont(xs));
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
+    Container ys;
+    prepare_container(ys, mask.count());
+    auto itOut = get_back_inserter<Container>(ys);
+    auto itIn = std::begin(xs);
+    std::size_t itInIdx = 0;
+    const auto& words = mask.words();
+    for (std::size_t w = 0; w < words.size(); ++w)
+    {
+        for (auto word = words[w]; word != 0; word &= word - 1)
+        {
+            const std::size_t idx = w * bitvector::word_bits() +
+                bitvector::count_trailing_zeros(word);
+            std::advance(itIn, static_cast<std::ptrdiff_t>(idx - itInIdx));
+            itInIdx = idx;
+            *itOut = *itIn;
+        }
+    }
+    FPLUS_PROFILE_OUTPUT(size_of_cont(ys));
+    return ys;
+}
+
+// drop_if_by_mask([true, false, true], [1, 2, 3]) == [2]
+template <typename Container>
+Container drop_if_by_mask(const bitvector& mask, const Container& xs)
+{
+    return keep_if_by_mask(~mask, xs);
+}
+
 // From a Container filled with Maybe<T> the nothings are dropped
 // and the values inside the justs are returned in a new container.
 template <typename ContainerIn,
@@ -100,12 +150,14 @@ template <typename ContainerIn,
 ContainerOut justs(const ContainerIn& xs)
 {
     typedef typename ContainerIn::value_type::type T;
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
     auto justsInMaybes = keep_if(is_just<T>, xs);
     ContainerOut ys;
     prepare_container(ys, fplus::size_of_cont(justsInMaybes));
     auto itOut = get_back_inserter<ContainerOut>(ys);
     std::transform(std::begin(justsInMaybes), std::end(justsInMaybes),
         itOut, unsafe_get_just<T>);
+    FPLUS_PROFILE_OUTPUT(size_of_cont(ys));
     return ys;
 }
 
@@ -114,6 +166,7 @@ template <typename Container, typename UnaryPredicate>
 Container trim_left(UnaryPredicate p, const Container& xs)
 {
     check_unary_predicate_for_container<UnaryPredicate, Container>();
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
     auto itFirstNot = std::find_if_not(std::begin(xs), std::end(xs), p);
     if (itFirstNot == std::end(xs))
         return Container();
@@ -125,6 +178,8 @@ template <typename Container, typename UnaryPredicate>
 Container trim_right(UnaryPredicate p, const Container& xs)
 {
     check_unary_predicate_for_container<UnaryPredicate, Container>();
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
+    FPLUS_AUDIT_COPY_SCOPE();
     return reverse(trim_left(p, reverse(xs)));
 }
 
@@ -133,6 +188,8 @@ template <typename Container, typename UnaryPredicate>
 Container trim(UnaryPredicate p, const Container& xs)
 {
     check_unary_predicate_for_container<UnaryPredicate, Container>();
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
+    FPLUS_AUDIT_COPY_SCOPE();
     return trim_right(p, trim_left(p, xs));
 }
 
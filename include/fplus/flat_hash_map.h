@@ -0,0 +1,420 @@
+// Copyright Tobias Hermann 2015.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace fplus
+{
+
+// Transparent string hash (FNV-1a).
+// std::string keys and C strings hash equally,
+// so a flat_hash_map<std::string, V, string_hash, std::equal_to<>>
+// can be searched with a const char* without creating a std::string.
+struct string_hash
+{
+    typedef void is_transparent;
+
+    std::size_t operator()(const char* str) const
+    {
+        std::uint64_t h = 14695981039346656037ULL;
+        for (; *str != '\0'; ++str)
+            h = (h ^ static_cast<unsigned char>(*str)) * 1099511628211ULL;
+        return static_cast<std::size_t>(h);
+    }
+
+    std::size_t operator()(const std::string& str) const
+    {
+        return hash_chars(str.data(), str.size());
+    }
+
+    static std::size_t hash_chars(const char* data, std::size_t size)
+    {
+        std::uint64_t h = 14695981039346656037ULL;
+        for (std::size_t i = 0; i < size; ++i)
+            h = (h ^ static_cast<unsigned char>(data[i])) * 1099511628211ULL;
+        return static_cast<std::size_t>(h);
+    }
+};
+
+// Hash map with open addressing.
+// The entries live densely in one vector in insertion order,
+// the table only holds their indices and is probed linearly.
+// So there is one allocation for all entries instead of one per node,
+// iteration is a linear scan, and a lookup usually touches
+// one slot and one entry.
+// Erasing moves the last entry into the gap,
+// so it changes the iteration order.
+// Iterators are invalidated by every insertion and erasure.
+// Keys must not be changed through iterators.
+template <typename Key, typename Val,
+    typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+class flat_hash_map
+{
+public:
+    typedef Key key_type;
+    typedef Val mapped_type;
+    typedef std::pair<Key, Val> value_type;
+    typedef Hash hasher;
+    typedef KeyEqual key_equal;
+    typedef std::vector<value_type> storage_t;
+    typedef typename storage_t::size_type size_type;
+    typedef typename storage_t::difference_type difference_type;
+    typedef value_type& reference;
+    typedef const value_type& const_reference;
+    typedef typename storage_t::iterator iterator;
+    typedef typename storage_t::const_iterator const_iterator;
+
+    flat_hash_map() : entries_(), slots_(), hash_(), equal_() {}
+
+    // Keeps the first entry of every key.
+    template <typename InputIt>
+    flat_hash_map(InputIt first, InputIt last) : flat_hash_map()
+    {
+        typedef typename std::iterator_traits<InputIt>::iterator_category cat;
+        reserve_for_range(first, last, cat());
+        for (; first != last; ++first)
+            insert(*first);
+    }
+
+    flat_hash_map(std::initializer_list<value_type> entries) :
+        flat_hash_map(std::begin(entries), std::end(entries))
+    {}
+
+    iterator begin() { return entries_.begin(); }
+    iterator end() { return entries_.end(); }
+    const_iterator begin() const { return entries_.begin(); }
+    const_iterator end() const { return entries_.end(); }
+    const_iterator cbegin() const { return entries_.cbegin(); }
+    const_iterator cend() const { return entries_.cend(); }
+
+    bool empty() const { return entries_.empty(); }
+    size_type size() const { return entries_.size(); }
+
+    void clear()
+    {
+        entries_.clear();
+        std::fill(std::begin(slots_), std::end(slots_), no_idx());
+    }
+
+    void reserve(size_type n)
+    {
+        entries_.reserve(n);
+        if (n > max_size_for_slots(slots_.size()))
+            rehash(slot_count_for(n));
+    }
+
+    iterator find(const Key& key)
+    {
+        const std::size_t idx = entries_.empty() ? no_idx() : find_idx(key);
+        return idx == no_idx() ? end() : begin() + static_cast<difference_type>(idx);
+    }
+    const_iterator find(const Key& key) const
+    {
+        const std::size_t idx = entries_.empty() ? no_idx() : find_idx(key);
+        return idx == no_idx() ? end() : begin() + static_cast<difference_type>(idx);
+    }
+    size_type count(const Key& key) const
+    {
+        return find(key) == end() ? 0 : 1;
+    }
+
+    // Heterogeneous lookups, e.g. with a const char* for std::string keys,
+    // are available if Hash and KeyEqual are both transparent,
+    // like string_hash and std::equal_to<>.
+    template <typename K, typename H = Hash, typename E = KeyEqual,
+        typename = typename H::is_transparent,
+        typename = typename E::is_transparent>
+    iterator find(const K& key)
+    {
+        const std::size_t idx = entries_.empty() ? no_idx() : find_idx(key);
+        return idx == no_idx() ? end() : begin() + static_cast<difference_type>(idx);
+    }
+    template <typename K, typename H = Hash, typename E = KeyEqual,
+        typename = typename H::is_transparent,
+        typename = typename E::is_transparent>
+    const_iterator find(const K& key) const
+    {
+        const std::size_t idx = entries_.empty() ? no_idx() : find_idx(key);
+        return idx == no_idx() ? end() : begin() + static_cast<difference_type>(idx);
+    }
+    template <typename K, typename H = Hash, typename E = KeyEqual,
+        typename = typename H::is_transparent,
+        typename = typename E::is_transparent>
+    size_type count(const K& key) const
+    {
+        return find(key) == end() ? 0 : 1;
+    }
+
+    Val& at(const Key& key)
+    {
+        auto it = find(key);
+        if (it == end())
+            throw std::out_of_range("fplus::flat_hash_map::at");
+        return it->second;
+    }
+    const Val& at(const Key& key) const
+    {
+        auto it = find(key);
+        if (it == end())
+            throw std::out_of_range("fplus::flat_hash_map::at");
+        return it->second;
+    }
+
+    // The functions inserting an entry look up its key first.
+    // Only if it is missing, the table grows and the entry is constructed,
+    // so accessing a present key neither copies it nor allocates.
+    Val& operator[](const Key& key)
+    {
+        return try_emplace(key).first->second;
+    }
+    Val& operator[](Key&& key)
+    {
+        return try_emplace(std::move(key)).first->second;
+    }
+
+    // Like std::unordered_map::try_emplace of C++17:
+    // Constructs the value from args only if the key is missing.
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args)
+    {
+        return insert_if_missing(key, std::piecewise_construct,
+            std::forward_as_tuple(key),
+            std::forward_as_tuple(std::forward<Args>(args)...));
+    }
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(Key&& key, Args&&... args)
+    {
+        return insert_if_missing(key, std::piecewise_construct,
+            std::forward_as_tuple(std::move(key)),
+            std::forward_as_tuple(std::forward<Args>(args)...));
+    }
+
+    std::pair<iterator, bool> insert(const value_type& entry)
+    {
+        return insert_if_missing(entry.first, entry);
+    }
+    std::pair<iterator, bool> insert(value_type&& entry)
+    {
+        return insert_if_missing(entry.first, std::move(entry));
+    }
+
+    // The hint is ignored. It only exists for std::inserter.
+    iterator insert(const_iterator, const value_type& entry)
+    {
+        return insert(entry).first;
+    }
+    iterator insert(const_iterator, value_type&& entry)
+    {
+        return insert(std::move(entry)).first;
+    }
+
+    // The key is only known after constructing the entry.
+    // Use try_emplace to avoid that for present keys.
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(Args&&... args)
+    {
+        return insert(value_type(std::forward<Args>(args)...));
+    }
+
+    size_type erase(const Key& key)
+    {
+        if (entries_.empty())
+            return 0;
+        const std::size_t slot = find_slot(key);
+        if (slots_[slot] == no_idx())
+            return 0;
+        erase_at_slot(slot);
+        return 1;
+    }
+
+    const storage_t& entries() const { return entries_; }
+
+private:
+    static std::size_t no_idx()
+    {
+        return std::numeric_limits<std::size_t>::max();
+    }
+
+    // At most 3/4 of the slots are used.
+    static std::size_t max_size_for_slots(std::size_t slotCount)
+    {
+        return slotCount / 4 * 3;
+    }
+
+    static std::size_t slot_count_for(std::size_t n)
+    {
+        std::size_t slotCount = 16;
+        while (max_size_for_slots(slotCount) < n)
+            slotCount *= 2;
+        return slotCount;
+    }
+
+    template <typename InputIt>
+    void reserve_for_range(InputIt first, InputIt last,
+        std::forward_iterator_tag)
+    {
+        reserve(static_cast<size_type>(std::distance(first, last)));
+    }
+
+    template <typename InputIt>
+    void reserve_for_range(InputIt, InputIt, std::input_iterator_tag)
+    {
+    }
+
+    std::size_t mask() const { return slots_.size() - 1; }
+
+    // Weak hashes like the identity of std::hash<int>
+    // would cluster badly with linear probing and power-of-two tables,
+    // so the bits are mixed before masking.
+    template <typename K>
+    std::size_t slot_of(const K& key) const
+    {
+        std::uint64_t h = static_cast<std::uint64_t>(hash_(key));
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        return static_cast<std::size_t>(h) & mask();
+    }
+
+    // The slot holding the key,
+    // or the empty slot that ends its probe sequence.
+    template <typename K>
+    std::size_t find_slot(const K& key) const
+    {
+        std::size_t slot = slot_of(key);
+        while (slots_[slot] != no_idx() &&
+                !equal_(entries_[slots_[slot]].first, key))
+            slot = (slot + 1) & mask();
+        return slot;
+    }
+
+    template <typename K>
+    std::size_t find_idx(const K& key) const
+    {
+        return slots_[find_slot(key)];
+    }
+
+    // args construct the entry, and its key has to equal key.
+    // The entry is added before its slot is taken,
+    // so the map stays unchanged if constructing it throws.
+    template <typename... Args>
+    std::pair<iterator, bool> insert_if_missing(const Key& key,
+        Args&&... args)
+    {
+        std::size_t slot = no_idx();
+        if (!slots_.empty())
+        {
+            slot = find_slot(key);
+            if (slots_[slot] != no_idx())
+                return std::make_pair(
+                    begin() + static_cast<difference_type>(slots_[slot]),
+                    false);
+        }
+        if (entries_.size() + 1 > max_size_for_slots(slots_.size()))
+        {
+            rehash(slot_count_for(entries_.size() + 1));
+            slot = find_slot(key);
+        }
+        entries_.emplace_back(std::forward<Args>(args)...);
+        slots_[slot] = entries_.size() - 1;
+        return std::make_pair(std::prev(end()), true);
+    }
+
+    void rehash(std::size_t slotCount)
+    {
+        slots_.assign(slotCount, no_idx());
+        for (std::size_t i = 0; i < entries_.size(); ++i)
+        {
+            std::size_t slot = slot_of(entries_[i].first);
+            while (slots_[slot] != no_idx())
+                slot = (slot + 1) & mask();
+            slots_[slot] = i;
+        }
+    }
+
+    std::size_t slot_pointing_to(std::size_t idx) const
+    {
+        std::size_t slot = slot_of(entries_[idx].first);
+        while (slots_[slot] != idx)
+            slot = (slot + 1) & mask();
+        return slot;
+    }
+
+    void erase_at_slot(std::size_t slot)
+    {
+        // Move the last entry into the gap to keep the entries dense.
+        const std::size_t idx = slots_[slot];
+        const std::size_t lastIdx = entries_.size() - 1;
+        if (idx != lastIdx)
+        {
+            slots_[slot_pointing_to(lastIdx)] = idx;
+            entries_[idx] = std::move(entries_[lastIdx]);
+        }
+        entries_.pop_back();
+
+        // Backward-shift deletion, so no tombstones are needed:
+        // Later members of the probe sequence move into the hole
+        // if their home slot does not lie cyclically between it and them.
+        std::size_t hole = slot;
+        std::size_t next = (hole + 1) & mask();
+        while (slots_[next] != no_idx())
+        {
+            const std::size_t home = slot_of(entries_[slots_[next]].first);
+            const std::size_t distHome = (next - home) & mask();
+            const std::size_t distHole = (next - hole) & mask();
+            if (distHome >= distHole)
+            {
+                slots_[hole] = slots_[next];
+                hole = next;
+            }
+            next = (next + 1) & mask();
+        }
+        slots_[hole] = no_idx();
+    }
+
+    storage_t entries_;
+    std::vector<std::size_t> slots_;
+    Hash hash_;
+    KeyEqual equal_;
+};
+
+// Equal if both contain the same key-value pairs,
+// independent of the insertion order.
+template <typename Key, typename Val, typename Hash, typename KeyEqual>
+bool operator == (const flat_hash_map<Key, Val, Hash, KeyEqual>& x,
+    const flat_hash_map<Key, Val, Hash, KeyEqual>& y)
+{
+    if (x.size() != y.size())
+        return false;
+    for (const auto& entry : x)
+    {
+        auto it = y.find(entry.first);
+        if (it == y.end() || !(it->second == entry.second))
+            return false;
+    }
+    return true;
+}
+
+template <typename Key, typename Val, typename Hash, typename KeyEqual>
+bool operator != (const flat_hash_map<Key, Val, Hash, KeyEqual>& x,
+    const flat_hash_map<Key, Val, Hash, KeyEqual>& y)
+{
+    return !(x == y);
+}
+
+} // namespace fplus
@@ -0,0 +1,229 @@
+// Copyright Tobias Hermann 2015.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace fplus
+{
+
+// Map storing its entries as a vector of pairs sorted by key.
+// Lookups are binary searches over contiguous memory,
+// and there is no per-entry allocation or pointer overhead,
+// so it is well suited for read-mostly tables.
+// Inserting in the middle is O(n), appending keys in ascending order
+// and bulk construction from a range are cheap.
+// Keys must not be changed through iterators.
+template <typename Key, typename Val, typename Compare = std::less<Key>>
+class flat_map
+{
+public:
+    typedef Key key_type;
+    typedef Val mapped_type;
+    typedef std::pair<Key, Val> value_type;
+    typedef Compare key_compare;
+    typedef std::vector<value_type> storage_t;
+    typedef typename storage_t::size_type size_type;
+    typedef typename storage_t::difference_type difference_type;
+    typedef value_type& reference;
+    typedef const value_type& const_reference;
+    typedef typename storage_t::iterator iterator;
+    typedef typename storage_t::const_iterator const_iterator;
+
+    flat_map() : entries_(), comp_() {}
+    explicit flat_map(const Compare& comp) : entries_(), comp_(comp) {}
+
+    // Bulk construction: sorts once and keeps the first entry
+    // of every key, like inserting the pairs one by one would.
+    template <typename InputIt>
+    flat_map(InputIt first, InputIt last) : entries_(first, last), comp_()
+    {
+        std::stable_sort(std::begin(entries_), std::end(entries_),
+            [this](const value_type& a, const value_type& b)
+            { return comp_(a.first, b.first); });
+        auto last_unique = std::unique(std::begin(entries_), std::end(entries_),
+            [this](const value_type& a, const value_type& b)
+            { return !comp_(a.first, b.first); });
+        entries_.erase(last_unique, std::end(entries_));
+    }
+
+    flat_map(std::initializer_list<value_type> entries) :
+        flat_map(std::begin(entries), std::end(entries))
+    {}
+
+    iterator begin() { return entries_.begin(); }
+    iterator end() { return entries_.end(); }
+    const_iterator begin() const { return entries_.begin(); }
+    const_iterator end() const { return entries_.end(); }
+    const_iterator cbegin() const { return entries_.cbegin(); }
+    const_iterator cend() const { return entries_.cend(); }
+
+    bool empty() const { return entries_.empty(); }
+    size_type size() const { return entries_.size(); }
+    void reserve(size_type n) { entries_.reserve(n); }
+    void clear() { entries_.clear(); }
+    key_compare key_comp() const { return comp_; }
+
+    iterator lower_bound(const Key& key)
+    {
+        return lower_bound_impl(entries_, key);
+    }
+    const_iterator lower_bound(const Key& key) const
+    {
+        return lower_bound_impl(entries_, key);
+    }
+    iterator find(const Key& key)
+    {
+        return find_impl(entries_, key);
+    }
+    const_iterator find(const Key& key) const
+    {
+        return find_impl(entries_, key);
+    }
+    size_type count(const Key& key) const
+    {
+        return find(key) == end() ? 0 : 1;
+    }
+
+    // Heterogeneous lookups, e.g. with a const char* for std::string keys,
+    // are available if the comparator is transparent, like std::less<>.
+    template <typename K, typename C = Compare,
+        typename = typename C::is_transparent>
+    iterator lower_bound(const K& key)
+    {
+        return lower_bound_impl(entries_, key);
+    }
+    template <typename K, typename C = Compare,
+        typename = typename C::is_transparent>
+    const_iterator lower_bound(const K& key) const
+    {
+        return lower_bound_impl(entries_, key);
+    }
+    template <typename K, typename C = Compare,
+        typename = typename C::is_transparent>
+    iterator find(const K& key)
+    {
+        return find_impl(entries_, key);
+    }
+    template <typename K, typename C = Compare,
+        typename = typename C::is_transparent>
+    const_iterator find(const K& key) const
+    {
+        return find_impl(entries_, key);
+    }
+    template <typename K, typename C = Compare,
+        typename = typename C::is_transparent>
+    size_type count(const K& key) const
+    {
+        return find(key) == end() ? 0 : 1;
+    }
+
+    Val& at(const Key& key)
+    {
+        auto it = find(key);
+        if (it == end())
+            throw std::out_of_range("fplus::flat_map::at");
+        return it->second;
+    }
+    const Val& at(const Key& key) const
+    {
+        auto it = find(key);
+        if (it == end())
+            throw std::out_of_range("fplus::flat_map::at");
+        return it->second;
+    }
+
+    Val& operator[](const Key& key)
+    {
+        auto it = lower_bound(key);
+        if (it == end() || comp_(key, it->first))
+            it = entries_.emplace(it, key, Val());
+        return it->second;
+    }
+
+    std::pair<iterator, bool> insert(const value_type& entry)
+    {
+        auto it = lower_bound(entry.first);
+        if (it != end() && !comp_(entry.first, it->first))
+            return std::make_pair(it, false);
+        return std::make_pair(entries_.insert(it, entry), true);
+    }
+
+    // If the key belongs right before hint, no search is needed.
+    // This makes std::inserter(m, m.end()) with ascending keys O(1).
+    iterator insert(const_iterator hint, const value_type& entry)
+    {
+        const bool fitsBeforeHint =
+            (hint == cbegin() || comp_(std::prev(hint)->first, entry.first)) &&
+            (hint == cend() || comp_(entry.first, hint->first));
+        if (fitsBeforeHint)
+            return entries_.insert(hint, entry);
+        return insert(entry).first;
+    }
+
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(Args&&... args)
+    {
+        return insert(value_type(std::forward<Args>(args)...));
+    }
+
+    size_type erase(const Key& key)
+    {
+        auto it = find(key);
+        if (it == end())
+            return 0;
+        entries_.erase(it);
+        return 1;
+    }
+    iterator erase(const_iterator it)
+    {
+        return entries_.erase(it);
+    }
+
+    const storage_t& entries() const { return entries_; }
+
+private:
+    template <typename Storage, typename K>
+    auto lower_bound_impl(Storage& entries, const K& key) const
+    {
+        return std::lower_bound(std::begin(entries), std::end(entries), key,
+            [this](const value_type& entry, const K& k)
+            { return comp_(entry.first, k); });
+    }
+
+    template <typename Storage, typename K>
+    auto find_impl(Storage& entries, const K& key) const
+    {
+        auto it = lower_bound_impl(entries, key);
+        return it != std::end(entries) && !comp_(key, it->first) ?
+            it : std::end(entries);
+    }
+
+    storage_t entries_;
+    Compare comp_;
+};
+
+template <typename Key, typename Val, typename Compare>
+bool operator == (const flat_map<Key, Val, Compare>& x,
+    const flat_map<Key, Val, Compare>& y)
+{
+    return x.entries() == y.entries();
+}
+
+template <typename Key, typename Val, typename Compare>
+bool operator != (const flat_map<Key, Val, Compare>& x,
+    const flat_map<Key, Val, Compare>& y)
+{
+    return !(x == y);
+}
+
+} // namespace fplus
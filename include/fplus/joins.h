@@ -0,0 +1,404 @@
+// Copyright Tobias Hermann 2015.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include "container_common.h"
+#include "function_traits.h"
+#include "maybe.h"
+
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace fplus
+{
+
+// The key types both key functions of a join return.
+template <typename KeyFA, typename KeyFB>
+struct join_key_type
+{
+    typedef std::remove_const_t<std::remove_reference_t<
+        typename utils::function_traits<KeyFA>::result_type>> type;
+    static_assert(std::is_same<type, std::remove_const_t<std::remove_reference_t<
+        typename utils::function_traits<KeyFB>::result_type>>>::value,
+        "Both key functions must return the same type.");
+    static_assert(utils::function_traits<KeyFA>::arity == 1, "Wrong arity.");
+    static_assert(utils::function_traits<KeyFB>::arity == 1, "Wrong arity.");
+};
+
+// Open-addressing hash index over the keys of the right side of a join.
+// Every slot holds the index of the first element with a given key,
+// further elements with the same key are chained via next_idx.
+// No allocation per element, in contrast to std::unordered_map.
+template <typename Key>
+class join_hash_index
+{
+public:
+    template <typename KeyF, typename PtrContainer>
+    join_hash_index(KeyF& key_fn, const PtrContainer& ptrs) :
+        keys_(),
+        nextIdx_(ptrs.size(), no_idx()),
+        slots_(),
+        mask_(0)
+    {
+        std::size_t slotCount = 16;
+        while (slotCount < 2 * ptrs.size())
+            slotCount *= 2;
+        slots_.assign(slotCount, no_idx());
+        mask_ = slotCount - 1;
+        keys_.reserve(ptrs.size());
+        for (const auto& ptr : ptrs)
+            keys_.push_back(key_fn(*ptr));
+        for (std::size_t i = keys_.size(); i > 0; --i)
+        {
+            const std::size_t idx = i - 1;
+            std::size_t& slot = slots_[find_slot(keys_[idx])];
+            if (slot != no_idx())
+                nextIdx_[idx] = slot;
+            slot = idx;
+        }
+    }
+    static std::size_t no_idx() { return static_cast<std::size_t>(-1); }
+    // Index of the first element with this key or no_idx().
+    std::size_t first_idx(const Key& key) const
+    {
+        return slots_[find_slot(key)];
+    }
+    std::size_t next_idx(std::size_t idx) const
+    {
+        return nextIdx_[idx];
+    }
+private:
+    std::size_t find_slot(const Key& key) const
+    {
+        std::size_t h = std::hash<Key>()(key);
+        // std::hash often is the identity, so mix the bits
+        // before only using the lower ones.
+        h ^= h >> 16;
+        h *= static_cast<std::size_t>(0x45d9f3b);
+        h ^= h >> 16;
+        std::size_t slot = h & mask_;
+        while (slots_[slot] != no_idx() && !(keys_[slots_[slot]] == key))
+            slot = (slot + 1) & mask_;
+        return slot;
+    }
+    std::vector<Key> keys_;
+    std::vector<std::size_t> nextIdx_;
+    std::vector<std::size_t> slots_;
+    std::size_t mask_;
+};
+
+// Hash join: Builds a hash index over the keys of bs
+// and probes it with every element of as.
+// on_match(a, b) is called for every matching pair, in the order of as
+// and, for equal keys, in the order of bs.
+// on_a_only(a) is called for elements of as without a partner,
+// on_b_only(b) at the end for all elements of bs never matched.
+template <typename KeyFA, typename KeyFB, typename ContainerA,
+    typename ContainerB, typename OnMatch, typename OnAOnly, typename OnBOnly>
+void hash_join_visit(KeyFA key_a, KeyFB key_b,
+    const ContainerA& as, const ContainerB& bs,
+    OnMatch on_match, OnAOnly on_a_only, OnBOnly on_b_only,
+    bool visitUnmatchedBs)
+{
+    typedef typename join_key_type<KeyFA, KeyFB>::type Key;
+    typedef typename ContainerB::value_type B;
+    typedef join_hash_index<Key> index_t;
+    std::vector<const B*> bPtrs;
+    bPtrs.reserve(size_of_cont(bs));
+    for (const auto& b : bs)
+        bPtrs.push_back(&b);
+    const index_t index(key_b, bPtrs);
+    std::vector<bool> bMatched(visitUnmatchedBs ? bPtrs.size() : 0, false);
+    for (const auto& a : as)
+    {
+        std::size_t idx = index.first_idx(key_a(a));
+        if (idx == index_t::no_idx())
+        {
+            on_a_only(a);
+            continue;
+        }
+        for (; idx != index_t::no_idx(); idx = index.next_idx(idx))
+        {
+            on_match(a, *bPtrs[idx]);
+            if (visitUnmatchedBs)
+                bMatched[idx] = true;
+        }
+    }
+    if (visitUnmatchedBs)
+    {
+        for (std::size_t idx = 0; idx < bPtrs.size(); ++idx)
+            if (!bMatched[idx])
+                on_b_only(*bPtrs[idx]);
+    }
+}
+
+// Sort-merge join: Both inputs must already be sorted
+// ascending by their keys. Walks through both once.
+// on_match(a, b) is called for every matching pair in key order,
+// for equal keys in the order of as and then bs.
+// on_a_only(a) and on_b_only(b) are called in key order
+// for elements without partner.
+template <typename KeyFA, typename KeyFB, typename ContainerA,
+    typename ContainerB, typename OnMatch, typename OnAOnly, typename OnBOnly>
+void merge_join_visit(KeyFA key_a, KeyFB key_b,
+    const ContainerA& as, const ContainerB& bs,
+    OnMatch on_match, OnAOnly on_a_only, OnBOnly on_b_only)
+{
+    typedef typename join_key_type<KeyFA, KeyFB>::type Key;
+    auto itA = std::begin(as);
+    auto itB = std::begin(bs);
+    while (itA != std::end(as) && itB != std::end(bs))
+    {
+        const Key keyA = key_a(*itA);
+        const Key keyB = key_b(*itB);
+        if (keyA < keyB)
+        {
+            on_a_only(*itA);
+            ++itA;
+        }
+        else if (keyB < keyA)
+        {
+            on_b_only(*itB);
+            ++itB;
+        }
+        else
+        {
+            auto itBEnd = itB;
+            do
+            {
+                ++itBEnd;
+            } while (itBEnd != std::end(bs) && !(keyA < key_b(*itBEnd)));
+            do
+            {
+                for (auto it = itB; it != itBEnd; ++it)
+                    on_match(*itA, *it);
+                ++itA;
+            } while (itA != std::end(as) && !(keyB < key_a(*itA)));
+            itB = itBEnd;
+        }
+    }
+    for (; itA != std::end(as); ++itA)
+        on_a_only(*itA);
+    for (; itB != std::end(bs); ++itB)
+        on_b_only(*itB);
+}
+
+// join_on_with(f, key_a, key_b, as, bs)
+// == [f(a, b) | a <- as, b <- bs, key_a(a) == key_b(b)]
+// Inner join combining every matching pair with f.
+// The result follows the order of as, ties in the order of bs.
+template <typename F, typename KeyFA, typename KeyFB,
+    typename ContainerA, typename ContainerB,
+    typename FOut = std::remove_const_t<std::remove_reference_t<
+        typename utils::function_traits<F>::result_type>>,
+    typename ContainerOut = std::vector<FOut>>
+ContainerOut join_on_with(F f, KeyFA key_a, KeyFB key_b,
+    const ContainerA& as, const ContainerB& bs)
+{
+    FPLUS_PROFILE_SCOPE(size_of_cont(as) + size_of_cont(bs));
+    typedef typename ContainerA::value_type A;
+    typedef typename ContainerB::value_type B;
+    ContainerOut result;
+    prepare_container(result, size_of_cont(as));
+    auto itOut = get_back_inserter(result);
+    hash_join_visit(key_a, key_b, as, bs,
+        [&](const A& a, const B& b) { *itOut = f(a, b); },
+        [](const A&) {}, [](const B&) {}, false);
+    FPLUS_PROFILE_OUTPUT(size_of_cont(result));
+    return result;
+}
+
+// join_on(fst, fst, [(1,"a"),(2,"b")], [(2,"x"),(3,"y")])
+// == [((2,"b"),(2,"x"))]
+// Inner join of as and bs on equal keys using a hash table over bs.
+template <typename KeyFA, typename KeyFB,
+    typename ContainerA, typename ContainerB,
+    typename A = typename ContainerA::value_type,
+    typename B = typename ContainerB::value_type,
+    typename ContainerOut = std::vector<std::pair<A, B>>>
+ContainerOut join_on(KeyFA key_a, KeyFB key_b,
+    const ContainerA& as, const ContainerB& bs)
+{
+    FPLUS_PROFILE_SCOPE(size_of_cont(as) + size_of_cont(bs));
+    auto make_pair = [](const A& a, const B& b) { return std::make_pair(a, b); };
+    return join_on_with<decltype(make_pair), KeyFA, KeyFB, ContainerA, ContainerB,
+        std::pair<A, B>, ContainerOut>(make_pair, key_a, key_b, as, bs);
+}
+
+// left_join_on_with(f, key_a, key_b, as, bs)
+// Like join_on_with, but also calls f(a, nothing)
+// for the elements of as without matching element in bs.
+template <typename F, typename KeyFA, typename KeyFB,
+    typename ContainerA, typename ContainerB,
+    typename FOut = std::remove_const_t<std::remove_reference_t<
+        typename utils::function_traits<F>::result_type>>,
+    typename ContainerOut = std::vector<FOut>>
+ContainerOut left_join_on_with(F f, KeyFA key_a, KeyFB key_b,
+    const ContainerA& as, const ContainerB& bs)
+{
+    FPLUS_PROFILE_SCOPE(size_of_cont(as) + size_of_cont(bs));
+    typedef typename ContainerA::value_type A;
+    typedef typename ContainerB::value_type B;
+    ContainerOut result;
+    prepare_container(result, size_of_cont(as));
+    auto itOut = get_back_inserter(result);
+    hash_join_visit(key_a, key_b, as, bs,
+        [&](const A& a, const B& b) { *itOut = f(a, just(b)); },
+        [&](const A& a) { *itOut = f(a, nothing<B>()); },
+        [](const B&) {}, false);
+    FPLUS_PROFILE_OUTPUT(size_of_cont(result));
+    return result;
+}
+
+// left_join_on(fst, fst, [(1,"a"),(2,"b")], [(2,"x"),(3,"y")])
+// == [((1,"a"),nothing), ((2,"b"),just((2,"x")))]
+template <typename KeyFA, typename KeyFB,
+    typename ContainerA, typename ContainerB,
+    typename A = typename ContainerA::value_type,
+    typename B = typename ContainerB::value_type,
+    typename ContainerOut = std::vector<std::pair<A, maybe<B>>>>
+ContainerOut left_join_on(KeyFA key_a, KeyFB key_b,
+    const ContainerA& as, const ContainerB& bs)
+{
+    FPLUS_PROFILE_SCOPE(size_of_cont(as) + size_of_cont(bs));
+    auto make_pair = [](const A& a, const maybe<B>& b) { return std::make_pair(a, b); };
+    return left_join_on_with<decltype(make_pair), KeyFA, KeyFB, ContainerA,
+        ContainerB, std::pair<A, maybe<B>>, ContainerOut>(
+            make_pair, key_a, key_b, as, bs);
+}
+
+// outer_join_on_with(f, key_a, key_b, as, bs)
+// Like left_join_on_with, but additionally calls f(nothing, b)
+// for all elements of bs without partner, after the other results.
+template <typename F, typename KeyFA, typename KeyFB,
+    typename ContainerA, typename ContainerB,
+    typename FOut = std::remove_const_t<std::remove_reference_t<
+        typename utils::function_traits<F>::result_type>>,
+    typename ContainerOut = std::vector<FOut>>
+ContainerOut outer_join_on_with(F f, KeyFA key_a, KeyFB key_b,
+    const ContainerA& as, const ContainerB& bs)
+{
+    FPLUS_PROFILE_SCOPE(size_of_cont(as) + size_of_cont(bs));
+    typedef typename ContainerA::value_type A;
+    typedef typename ContainerB::value_type B;
+    ContainerOut result;
+    prepare_container(result, size_of_cont(as) + size_of_cont(bs));
+    auto itOut = get_back_inserter(result);
+    hash_join_visit(key_a, key_b, as, bs,
+        [&](const A& a, const B& b) { *itOut = f(just(a), just(b)); },
+        [&](const A& a) { *itOut = f(just(a), nothing<B>()); },
+        [&](const B& b) { *itOut = f(nothing<A>(), just(b)); }, true);
+    FPLUS_PROFILE_OUTPUT(size_of_cont(result));
+    return result;
+}
+
+// outer_join_on(fst, fst, [(1,"a"),(2,"b")], [(2,"x"),(3,"y")])
+// == [(just((1,"a")),nothing), (just((2,"b")),just((2,"x"))),
+//     (nothing,just((3,"y")))]
+template <typename KeyFA, typename KeyFB,
+    typename ContainerA, typename ContainerB,
+    typename A = typename ContainerA::value_type,
+    typename B = typename ContainerB::value_type,
+    typename ContainerOut = std::vector<std::pair<maybe<A>, maybe<B>>>>
+ContainerOut outer_join_on(KeyFA key_a, KeyFB key_b,
+    const ContainerA& as, const ContainerB& bs)
+{
+    FPLUS_PROFILE_SCOPE(size_of_cont(as) + size_of_cont(bs));
+    auto make_pair = [](const maybe<A>& a, const maybe<B>& b)
+        { return std::make_pair(a, b); };
+    return outer_join_on_with<decltype(make_pair), KeyFA, KeyFB, ContainerA,
+        ContainerB, std::pair<maybe<A>, maybe<B>>, ContainerOut>(
+            make_pair, key_a, key_b, as, bs);
+}
+
+// Like join_on_with, but for inputs already sorted by their keys.
+// Uses a sort-merge join, which needs no hash table
+// and only requires operator< on the keys.
+template <typename F, typename KeyFA, typename KeyFB,
+    typename ContainerA, typename ContainerB,
+    typename FOut = std::remove_const_t<std::remove_reference_t<
+        typename utils::function_traits<F>::result_type>>,
+    typename ContainerOut = std::vector<FOut>>
+ContainerOut join_on_with_sorted(F f, KeyFA key_a, KeyFB key_b,
+    const ContainerA& as, const ContainerB& bs)
+{
+    FPLUS_PROFILE_SCOPE(size_of_cont(as) + size_of_cont(bs));
+    typedef typename ContainerA::value_type A;
+    typedef typename ContainerB::value_type B;
+    ContainerOut result;
+    prepare_container(result, size_of_cont(as));
+    auto itOut = get_back_inserter(result);
+    merge_join_visit(key_a, key_b, as, bs,
+        [&](const A& a, const B& b) { *itOut = f(a, b); },
+        [](const A&) {}, [](const B&) {});
+    FPLUS_PROFILE_OUTPUT(size_of_cont(result));
+    return result;
+}
+
+// Like join_on, but for inputs already sorted by their keys.
+template <typename KeyFA, typename KeyFB,
+    typename ContainerA, typename ContainerB,
+    typename A = typename ContainerA::value_type,
+    typename B = typename ContainerB::value_type,
+    typename ContainerOut = std::vector<std::pair<A, B>>>
+ContainerOut join_on_sorted(KeyFA key_a, KeyFB key_b,
+    const ContainerA& as, const ContainerB& bs)
+{
+    FPLUS_PROFILE_SCOPE(size_of_cont(as) + size_of_cont(bs));
+    auto make_pair = [](const A& a, const B& b) { return std::make_pair(a, b); };
+    return join_on_with_sorted<decltype(make_pair), KeyFA, KeyFB,
+        ContainerA, ContainerB, std::pair<A, B>, ContainerOut>(
+            make_pair, key_a, key_b, as, bs);
+}
+
+// Like left_join_on, but for inputs already sorted by their keys.
+template <typename KeyFA, typename KeyFB,
+    typename ContainerA, typename ContainerB,
+    typename A = typename ContainerA::value_type,
+    typename B = typename ContainerB::value_type,
+    typename ContainerOut = std::vector<std::pair<A, maybe<B>>>>
+ContainerOut left_join_on_sorted(KeyFA key_a, KeyFB key_b,
+    const ContainerA& as, const ContainerB& bs)
+{
+    FPLUS_PROFILE_SCOPE(size_of_cont(as) + size_of_cont(bs));
+    ContainerOut result;
+    prepare_container(result, size_of_cont(as));
+    auto itOut = get_back_inserter(result);
+    merge_join_visit(key_a, key_b, as, bs,
+        [&](const A& a, const B& b) { *itOut = std::make_pair(a, just(b)); },
+        [&](const A& a) { *itOut = std::make_pair(a, nothing<B>()); },
+        [](const B&) {});
+    FPLUS_PROFILE_OUTPUT(size_of_cont(result));
+    return result;
+}
+
+// Like outer_join_on, but for inputs already sorted by their keys.
+// The result is ordered by key, so unmatched elements of bs
+// are not moved to the end.
+template <typename KeyFA, typename KeyFB,
+    typename ContainerA, typename ContainerB,
+    typename A = typename ContainerA::value_type,
+    typename B = typename ContainerB::value_type,
+    typename ContainerOut = std::vector<std::pair<maybe<A>, maybe<B>>>>
+ContainerOut outer_join_on_sorted(KeyFA key_a, KeyFB key_b,
+    const ContainerA& as, const ContainerB& bs)
+{
+    FPLUS_PROFILE_SCOPE(size_of_cont(as) + size_of_cont(bs));
+    ContainerOut result;
+    prepare_container(result, size_of_cont(as) + size_of_cont(bs));
+    auto itOut = get_back_inserter(result);
+    merge_join_visit(key_a, key_b, as, bs,
+        [&](const A& a, const B& b)
+            { *itOut = std::make_pair(just(a), just(b)); },
+        [&](const A& a) { *itOut = std::make_pair(just(a), nothing<B>()); },
+        [&](const B& b) { *itOut = std::make_pair(nothing<A>(), just(b)); });
+    FPLUS_PROFILE_OUTPUT(size_of_cont(result));
+    return result;
+}
+
+} // namespace fplus
@@ -10,17 +10,27 @@
 #include "transform.h"
 #include "pairs.h"
 
+#include <cstddef>
+#include <iterator>
 #include <map>
+#include <type_traits>
 #include <unordered_map>
+#include <utility>
 
 namespace fplus
 {
 
 // Converts a Container of pairs (key, value) into a dictionary.
+// If a key occurs more than once, its first value is kept.
+// The map is built from the whole range at once,
+// which lets flat maps sort only once instead of inserting one by one.
 template <typename MapOut, typename ContainerIn>
 MapOut pairs_to_map(const ContainerIn& pairs)
 {
-    return convert<MapOut>(pairs);
+    FPLUS_PROFILE_SCOPE(size_of_cont(pairs));
+    MapOut result(std::begin(pairs), std::end(pairs));
+    FPLUS_PROFILE_OUTPUT(size_of_cont(result));
+    return result;
 }
 
 // Converts a dictionary into a Container of pairs (key, value).
@@ -35,28 +45,168 @@ ContainerOut map_to_pairs(const MapType& dict)
     return convert<ContainerOut>(dict);
 }
 
+// get_map_keys({(1, "a"), (2, "b")}) == [1, 2]
 template <typename MapType,
     typename ContainerOut = std::vector<std::remove_const_t<typename MapType::key_type>>>
 ContainerOut get_map_keys(const MapType& dict)
 {
-    auto pairs = map_to_pairs(dict);
-    typedef typename decltype(pairs)::value_type::first_type FirstType;
-    typedef typename decltype(pairs)::value_type::second_type SecondType;
-    return transform(fst<FirstType, SecondType>, map_to_pairs(dict));
+    FPLUS_PROFILE_SCOPE(size_of_cont(dict));
+    ContainerOut result;
+    prepare_container(result, size_of_cont(dict));
+    auto itOut = get_back_inserter<ContainerOut>(result);
+    for (const auto& keyAndVal : dict)
+    {
+        *itOut = keyAndVal.first;
+    }
+    return result;
 }
 
+// get_map_values({(1, "a"), (2, "b")}) == ["a", "b"]
 template <typename MapType,
     typename ContainerOut = std::vector<std::remove_const_t<typename MapType::mapped_type>>>
 ContainerOut get_map_values(const MapType& dict)
 {
-    auto pairs = map_to_pairs(dict);
-    typedef typename decltype(pairs)::value_type::first_type FirstType;
-    typedef typename decltype(pairs)::value_type::second_type SecondType;
-    return transform(snd<FirstType, SecondType>, map_to_pairs(dict));
+    FPLUS_PROFILE_SCOPE(size_of_cont(dict));
+    ContainerOut result;
+    prepare_container(result, size_of_cont(dict));
+    auto itOut = get_back_inserter<ContainerOut>(result);
+    for (const auto& keyAndVal : dict)
+    {
+        *itOut = keyAndVal.second;
+    }
+    return result;
+}
+
+// Iterator over the keys or the values of a map,
+// depending on Select.
+template <typename MapIt, typename Select>
+class map_projection_iterator
+{
+public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef std::remove_const_t<std::remove_reference_t<
+        decltype(Select::get(*std::declval<MapIt>()))>> value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const value_type* pointer;
+    typedef const value_type& reference;
+
+    map_projection_iterator() : it_() {}
+    explicit map_projection_iterator(MapIt it) : it_(it) {}
+
+    reference operator*() const { return Select::get(*it_); }
+    pointer operator->() const { return &Select::get(*it_); }
+    map_projection_iterator& operator++() { ++it_; return *this; }
+    map_projection_iterator operator++(int)
+    {
+        map_projection_iterator old = *this;
+        ++it_;
+        return old;
+    }
+    bool operator == (const map_projection_iterator& other) const
+    {
+        return it_ == other.it_;
+    }
+    bool operator != (const map_projection_iterator& other) const
+    {
+        return it_ != other.it_;
+    }
+
+private:
+    MapIt it_;
+};
+
+struct map_select_key
+{
+    template <typename Pair>
+    static const typename Pair::first_type& get(const Pair& p)
+    {
+        return p.first;
+    }
+};
+
+struct map_select_value
+{
+    template <typename Pair>
+    static const typename Pair::second_type& get(const Pair& p)
+    {
+        return p.second;
+    }
+};
+
+// Non-owning range over the keys or the values of a map.
+// Nothing is copied, so the map must outlive the view
+// and must not be modified while the view is used.
+template <typename MapType, typename Select>
+class map_projection_view
+{
+public:
+    typedef map_projection_iterator<typename MapType::const_iterator, Select>
+        const_iterator;
+    typedef const_iterator iterator;
+    typedef typename const_iterator::value_type value_type;
+    typedef std::size_t size_type;
+
+    explicit map_projection_view(const MapType& dict) : dict_(&dict) {}
+
+    const_iterator begin() const { return const_iterator(dict_->begin()); }
+    const_iterator end() const { return const_iterator(dict_->end()); }
+    size_type size() const { return dict_->size(); }
+    bool empty() const { return dict_->empty(); }
+
+private:
+    const MapType* dict_;
+};
+
+// Keys of a map without copying them.
+// sum(convert_container<std::vector<int>>(map_keys_view({(1, "a"), (2, "b")}))) == 3
+template <typename MapType>
+map_projection_view<MapType, map_select_key> map_keys_view(const MapType& dict)
+{
+    return map_projection_view<MapType, map_select_key>(dict);
+}
+
+// Values of a map without copying them.
+template <typename MapType>
+map_projection_view<MapType, map_select_value> map_values_view(
+    const MapType& dict)
+{
+    return map_projection_view<MapType, map_select_value>(dict);
+}
+
+template <class MapType> struct is_flat_map : public std::false_type {};
+template <class Key, class Val, class Compare>
+struct is_flat_map<flat_map<Key, Val, Compare>> : public std::true_type {};
+
+template <typename MapOut, typename MapIn>
+MapOut swap_keys_and_values_dispatch(const MapIn& dict, std::false_type)
+{
+    MapOut result;
+    prepare_container(result, size_of_cont(dict));
+    for (const auto& keyAndVal : dict)
+    {
+        result.insert(typename MapOut::value_type(
+            keyAndVal.second, keyAndVal.first));
+    }
+    return result;
+}
+
+// Inserting the unordered new keys one by one would be quadratic,
+// so the flat_map is sorted once from all pairs instead.
+template <typename MapOut, typename MapIn>
+MapOut swap_keys_and_values_dispatch(const MapIn& dict, std::true_type)
+{
+    typename MapOut::storage_t swapped;
+    swapped.reserve(size_of_cont(dict));
+    for (const auto& keyAndVal : dict)
+    {
+        swapped.emplace_back(keyAndVal.second, keyAndVal.first);
+    }
+    return pairs_to_map<MapOut>(swapped);
 }
 
 // Swaps keys and Values of a dict:
 // swap_keys_and_values({(1, "a"), (2, "b")}) == {("a", 1), ("b", 2)}
+// If a value occurs more than once, the first of its keys is kept.
 template <typename MapIn,
     typename MapInPair = typename MapIn::value_type,
     typename InKey = typename MapInPair::first_type,
@@ -66,9 +216,148 @@ template <typename MapIn,
     typename MapOut = typename SameMapTypeNewTypes<MapIn, OutKey, OutVal>::type>
 MapOut swap_keys_and_values(const MapIn& dict)
 {
-    auto inAsPairs = map_to_pairs(dict);
-    auto outAsPairs = transform(swap_pair_elems<InKey, InVal>, inAsPairs);
-    return pairs_to_map<MapOut>(outAsPairs);
+    FPLUS_PROFILE_SCOPE(size_of_cont(dict));
+    return swap_keys_and_values_dispatch<MapOut>(dict, is_flat_map<MapOut>());
+}
+
+// An empty MapOut that orders or hashes its keys like dict,
+// if both use the same comparator or hasher type.
+template <typename MapOut, typename MapIn>
+auto empty_map_like(const MapIn& dict, int)
+    -> std::enable_if_t<std::is_same<typename MapOut::key_compare,
+            typename MapIn::key_compare>::value,
+        decltype(MapOut(dict.key_comp()))>
+{
+    return MapOut(dict.key_comp());
+}
+
+template <typename MapOut, typename MapIn>
+auto empty_map_like(const MapIn& dict, int)
+    -> std::enable_if_t<std::is_same<typename MapOut::hasher,
+            typename MapIn::hasher>::value &&
+        std::is_same<typename MapOut::key_equal,
+            typename MapIn::key_equal>::value,
+        decltype(MapOut(0, dict.hash_function(), dict.key_eq()))>
+{
+    return MapOut(0, dict.hash_function(), dict.key_eq());
+}
+
+template <typename MapOut, typename MapIn>
+MapOut empty_map_like(const MapIn&, long)
+{
+    return MapOut();
+}
+
+// transform_map_values((*2), {(1, 2), (3, 4)}) == {(1, 4), (3, 8)}
+// The keys stay the same, so the result keeps the comparator or hasher
+// of the input, and ordered results are appended at their end
+// without searching.
+template <typename F, typename MapIn,
+    typename MapInPair = typename MapIn::value_type,
+    typename Key = std::remove_const_t<typename MapInPair::first_type>,
+    typename InVal = typename MapInPair::second_type,
+    typename OutVal = std::remove_const_t<std::remove_reference_t<
+        std::result_of_t<F&(const InVal&)>>>,
+    typename MapOut = typename SameMapTypeNewVal<MapIn, OutVal>::type>
+MapOut transform_map_values(F f, const MapIn& dict)
+{
+    FPLUS_PROFILE_SCOPE(size_of_cont(dict));
+    MapOut result = empty_map_like<MapOut>(dict, 0);
+    prepare_container(result, size_of_cont(dict));
+    for (const auto& keyAndVal : dict)
+    {
+        result.insert(std::end(result),
+            typename MapOut::value_type(keyAndVal.first, f(keyAndVal.second)));
+    }
+    return result;
+}
+
+// map_keep_if(is_upper_case, {a: 1, b: 2, A: 3, C: 4}) == {A: 3, C: 4}
+template <typename Pred, typename MapType>
+MapType map_keep_if(Pred pred, const MapType& dict)
+{
+    FPLUS_PROFILE_SCOPE(size_of_cont(dict));
+    MapType result;
+    for (const auto& keyAndVal : dict)
+    {
+        if (pred(keyAndVal.first))
+            result.insert(std::end(result), keyAndVal);
+    }
+    FPLUS_PROFILE_OUTPUT(size_of_cont(result));
+    return result;
+}
+
+// map_drop_if(is_lower_case, {a: 1, b: 2, A: 3, C: 4}) == {A: 3, C: 4}
+template <typename Pred, typename MapType>
+MapType map_drop_if(Pred pred, const MapType& dict)
+{
+    return map_keep_if(logical_not(pred), dict);
+}
+
+template <class MapType> struct has_sorted_keys : public std::false_type {};
+template <class Key, class Val, class Compare, class Alloc>
+struct has_sorted_keys<std::map<Key, Val, Compare, Alloc>> : public std::true_type {};
+template <class Key, class Val, class Compare>
+struct has_sorted_keys<flat_map<Key, Val, Compare>> : public std::true_type {};
+
+// Both maps are walked in key order like in a merge,
+// so every entry is appended at the end of the result.
+template <typename F, typename MapType>
+MapType map_union_with_dispatch(F f, const MapType& dict1,
+    const MapType& dict2, std::true_type)
+{
+    const auto comp = dict1.key_comp();
+    MapType result;
+    prepare_container(result, size_of_cont(dict1) + size_of_cont(dict2));
+    auto it1 = std::begin(dict1);
+    auto it2 = std::begin(dict2);
+    while (it1 != std::end(dict1) && it2 != std::end(dict2))
+    {
+        if (comp(it1->first, it2->first))
+            result.insert(std::end(result), *it1++);
+        else if (comp(it2->first, it1->first))
+            result.insert(std::end(result), *it2++);
+        else
+        {
+            result.insert(std::end(result), typename MapType::value_type(
+                it1->first, f(it1->second, it2->second)));
+            ++it1;
+            ++it2;
+        }
+    }
+    for (; it1 != std::end(dict1); ++it1)
+        result.insert(std::end(result), *it1);
+    for (; it2 != std::end(dict2); ++it2)
+        result.insert(std::end(result), *it2);
+    return result;
+}
+
+template <typename F, typename MapType>
+MapType map_union_with_dispatch(F f, const MapType& dict1,
+    const MapType& dict2, std::false_type)
+{
+    MapType result = dict1;
+    prepare_container(result, size_of_cont(dict1) + size_of_cont(dict2));
+    for (const auto& keyAndVal : dict2)
+    {
+        auto it = result.find(keyAndVal.first);
+        if (it == std::end(result))
+            result.insert(keyAndVal);
+        else
+            it->second = f(it->second, keyAndVal.second);
+    }
+    return result;
+}
+
+// Combines the values of keys present in both maps with f.
+// map_union_with((+), {(0, 1), (1, 2)}, {(1, 3), (2, 4)}) == {(0, 1), (1, 5), (2, 4)}
+template <typename F, typename MapType>
+MapType map_union_with(F f, const MapType& dict1, const MapType& dict2)
+{
+    static_assert(utils::function_traits<F>::arity == 2, "Wrong arity.");
+    FPLUS_PROFILE_SCOPE(size_of_cont(dict1) + size_of_cont(dict2));
+    return map_union_with_dispatch(f, dict1, dict2,
+        has_sorted_keys<MapType>());
 }
 
 // create_map([1,2,3], ["one", "two"]) == { {1,"one"}, {2,"two"} }
@@ -78,6 +367,7 @@ template <typename ContainerIn1, typename ContainerIn2,
     typename MapOut = std::map<Key, Val>>
 MapOut create_map(const ContainerIn1& keys, const ContainerIn2& values)
 {
+    FPLUS_PROFILE_SCOPE(size_of_cont(keys));
     auto pairs = zip(keys, values);
     return pairs_to_map<MapOut>(pairs);
 }
@@ -91,6 +381,33 @@ MapOut create_unordered_map(
     const ContainerIn1& keys,
     const ContainerIn2& values)
 {
+    FPLUS_PROFILE_SCOPE(size_of_cont(keys));
+    auto pairs = zip(keys, values);
+    return pairs_to_map<MapOut>(pairs);
+}
+
+// create_flat_map([1,2,3], ["one", "two"]) == { {1,"one"}, {2,"two"} }
+template <typename ContainerIn1, typename ContainerIn2,
+    typename Key = std::remove_const_t<typename ContainerIn1::value_type>,
+    typename Val = std::remove_const_t<typename ContainerIn2::value_type>,
+    typename MapOut = flat_map<Key, Val>>
+MapOut create_flat_map(const ContainerIn1& keys, const ContainerIn2& values)
+{
+    FPLUS_PROFILE_SCOPE(size_of_cont(keys));
+    auto pairs = zip(keys, values);
+    return pairs_to_map<MapOut>(pairs);
+}
+
+// create_flat_hash_map([1,2,3], ["one", "two"]) == { {1,"one"}, {2,"two"} }
+template <typename ContainerIn1, typename ContainerIn2,
+    typename Key = std::remove_const_t<typename ContainerIn1::value_type>,
+    typename Val = std::remove_const_t<typename ContainerIn2::value_type>,
+    typename MapOut = flat_hash_map<Key, Val>>
+MapOut create_flat_hash_map(
+    const ContainerIn1& keys,
+    const ContainerIn2& values)
+{
+    FPLUS_PROFILE_SCOPE(size_of_cont(keys));
     auto pairs = zip(keys, values);
     return pairs_to_map<MapOut>(pairs);
 }
@@ -126,4 +443,68 @@ bool map_contains(const MapType& map, const Key& key)
     return it != std::end(map);
 }
 
+// Returns a pointer to the value of a key if key is present.
+// Otherwise returns a null pointer.
+// In contrast to get_from_map nothing is copied,
+// and with a transparent comparator (std::less<>)
+// or transparent hash and equality (string_hash, std::equal_to<>)
+// the key can be of another type, e.g. a const char* for std::string keys.
+// The pointer is valid as long as the entry is in the map
+// (for flat maps: until the next modification).
+// *get_ptr_from_map({(1, "a"), (2, "b")}, 2) == "b"
+template <typename MapType, typename Key,
+    typename Val = typename MapType::mapped_type>
+const Val* get_ptr_from_map(const MapType& map, const Key& key)
+{
+    auto it = map.find(key);
+    return it == std::end(map) ? nullptr : &it->second;
+}
+
+// Non-const version of get_ptr_from_map, allowing to change the value.
+template <typename MapType, typename Key,
+    typename Val = typename MapType::mapped_type>
+Val* get_ptr_from_map(MapType& map, const Key& key)
+{
+    auto it = map.find(key);
+    return it == std::end(map) ? nullptr : &it->second;
+}
+
+template <typename MapType, typename Key, typename Val>
+typename MapType::mapped_type& get_from_map_or_insert_dispatch(
+    MapType& map, const Key& key, const Val& defVal, std::true_type)
+{
+    auto it = map.lower_bound(key);
+    if (it == std::end(map) || map.key_comp()(key, it->first))
+        it = map.insert(it, typename MapType::value_type(key, defVal));
+    return it->second;
+}
+
+template <typename MapType, typename Key, typename Val>
+typename MapType::mapped_type& get_from_map_or_insert_dispatch(
+    MapType& map, const Key& key, const Val& defVal, std::false_type)
+{
+    auto it = map.find(key);
+    if (it == std::end(map))
+        it = map.emplace(key, defVal).first;
+    return it->second;
+}
+
+// Returns a reference to the value of a key,
+// inserting defVal for it before if key is not present.
+// A present key is found with a single lookup,
+// and neither key nor defVal is copied for it.
+// Only a missing key creates an entry:
+// ordered maps insert it at the position found by lower_bound,
+// hash maps emplace it after find did not find the key.
+// get_from_map_or_insert({(1, 2)}, 3, 0) == 0, and the map becomes {(1, 2), (3, 0)}
+template <typename MapType,
+    typename Key = typename MapType::key_type,
+    typename Val = typename MapType::mapped_type>
+typename MapType::mapped_type& get_from_map_or_insert(
+    MapType& map, const Key& key, const Val& defVal)
+{
+    return get_from_map_or_insert_dispatch(map, key, defVal,
+        has_sorted_keys<MapType>());
+}
+
 } // namespace fplus
\ No newline at end of file
@@ -10,6 +10,7 @@
 #include <cassert>
 #include <functional>
 #include <memory>
+#include <utility>
 
 namespace fplus
 {
@@ -21,7 +22,19 @@ class maybe
 public:
     maybe() {}
     maybe(const maybe<T>& other) : ptr_(other.get() ? std::make_unique<T>(*other.get()) : ptr_t()) {}
+    maybe(maybe<T>&& other) noexcept : ptr_(std::move(other.ptr_)) {}
     explicit maybe(const T& val) : ptr_(std::make_unique<T>(val)) {}
+    explicit maybe(T&& val) : ptr_(std::make_unique<T>(std::move(val))) {}
+    maybe<T>& operator = (const maybe<T>& other)
+    {
+        ptr_ = other.get() ? std::make_unique<T>(*other.get()) : ptr_t();
+        return *this;
+    }
+    maybe<T>& operator = (maybe<T>&& other) noexcept
+    {
+        ptr_ = std::move(other.ptr_);
+        return *this;
+    }
     bool is_just() const { return static_cast<bool>(get()); }
     const T& unsafe_get_just() const { assert(is_just()); return *get(); }
     typedef T type;
@@ -0,0 +1,191 @@
+// Copyright Tobias Hermann 2015.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include "function_traits.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace fplus
+{
+
+// Thread-safe cache used by memoized functions.
+// The keys are distributed over several shards,
+// each protected by its own mutex,
+// so concurrent callers rarely wait for each other.
+// If a capacity is given, every shard evicts
+// its least recently used entry when it is full,
+// so the cache never holds more than capacity entries in total.
+// A capacity of 0 means unbounded.
+template <typename Key, typename Val>
+class memoize_cache
+{
+public:
+    explicit memoize_cache(std::size_t capacity) :
+        capacity_(capacity),
+        shards_(capacity == 0 ? max_shard_count() :
+            std::min(capacity, max_shard_count()))
+    {
+        for (std::size_t i = 0; i < shards_.size(); ++i)
+        {
+            shards_[i].capacity = capacity == 0 ? 0 :
+                capacity / shards_.size() +
+                    (i < capacity % shards_.size() ? 1 : 0);
+            shards_[i].hits = 0;
+            shards_[i].misses = 0;
+        }
+    }
+
+    template <typename F>
+    Val get_or_compute(F& f, const Key& key)
+    {
+        shard& s = shards_[shard_idx(key)];
+        {
+            std::lock_guard<std::mutex> lock(s.mutex);
+            auto it = s.index.find(key);
+            if (it != std::end(s.index))
+            {
+                if (s.capacity != 0)
+                    s.entries.splice(std::begin(s.entries), s.entries,
+                        it->second);
+                ++s.hits;
+                return it->second->second;
+            }
+            ++s.misses;
+        }
+        // f runs without holding the lock,
+        // so slow calculations do not block other callers.
+        // If two threads miss the same key at the same time,
+        // both calculate it, which is fine for pure functions.
+        Val val = f(key);
+        std::lock_guard<std::mutex> lock(s.mutex);
+        if (s.index.find(key) == std::end(s.index))
+        {
+            s.entries.emplace_front(key, val);
+            s.index.emplace(key, std::begin(s.entries));
+            if (s.capacity != 0 && s.index.size() > s.capacity)
+            {
+                s.index.erase(s.entries.back().first);
+                s.entries.pop_back();
+            }
+        }
+        return val;
+    }
+
+    std::size_t capacity() const { return capacity_; }
+    std::size_t hits() const
+    {
+        return sum_over_shards([](const shard& s) { return s.hits; });
+    }
+    std::size_t misses() const
+    {
+        return sum_over_shards([](const shard& s) { return s.misses; });
+    }
+    std::size_t size() const
+    {
+        return sum_over_shards([](const shard& s) { return s.index.size(); });
+    }
+
+private:
+    static std::size_t max_shard_count() { return 16; }
+    typedef std::list<std::pair<Key, Val>> entries_t;
+    struct shard
+    {
+        mutable std::mutex mutex;
+        std::size_t capacity;
+        // Counted under the shard's lock,
+        // so lookups of different shards share no counters.
+        std::size_t hits;
+        std::size_t misses;
+        // front = most recently used
+        entries_t entries;
+        std::unordered_map<Key, typename entries_t::iterator> index;
+    };
+    std::size_t shard_idx(const Key& key) const
+    {
+        // Mix the bits, so the shards do not depend
+        // only on the bits the hash map uses for its buckets.
+        std::size_t h = std::hash<Key>()(key);
+        h ^= (h >> 7) ^ (h >> 17);
+        return h % shards_.size();
+    }
+    template <typename G>
+    std::size_t sum_over_shards(G get) const
+    {
+        std::size_t result = 0;
+        for (const auto& s : shards_)
+        {
+            std::lock_guard<std::mutex> lock(s.mutex);
+            result += get(s);
+        }
+        return result;
+    }
+    std::size_t capacity_;
+    std::vector<shard> shards_;
+};
+
+// Function object returned by memoize and memoize_lru.
+// Copies share the same cache.
+template <typename F,
+    typename FIn = typename utils::function_traits<F>::template arg<0>::type,
+    typename FOut = typename utils::function_traits<F>::result_type,
+    typename Key = std::remove_const_t<std::remove_reference_t<FIn>>,
+    typename Val = std::remove_const_t<std::remove_reference_t<FOut>>>
+class memoized_function
+{
+public:
+    memoized_function(F f, std::size_t capacity) :
+        f_(std::make_shared<F>(f)),
+        cache_(std::make_shared<memoize_cache<Key, Val>>(capacity))
+    {}
+    Val operator()(FIn x) const
+    {
+        return cache_->get_or_compute(*f_, x);
+    }
+    std::size_t hits() const { return cache_->hits(); }
+    std::size_t misses() const { return cache_->misses(); }
+    std::size_t cache_size() const { return cache_->size(); }
+private:
+    std::shared_ptr<F> f_;
+    std::shared_ptr<memoize_cache<Key, Val>> cache_;
+};
+
+// memoize : (a -> b) -> (a -> b)
+// Returns a function that remembers the results of f
+// and does not call it again for the same argument.
+// f must be a pure function,
+// and its parameter type must be hashable with std::hash.
+// The cache is unbounded. The returned function can be called
+// from multiple threads concurrently.
+template <typename F>
+memoized_function<F> memoize(F f)
+{
+    static_assert(utils::function_traits<F>::arity == 1, "Wrong arity.");
+    return memoized_function<F>(f, 0);
+}
+
+// memoize_lru : Int -> (a -> b) -> (a -> b)
+// Like memoize, but remembers at most capacity results,
+// evicting the least recently used ones first.
+template <typename F>
+memoized_function<F> memoize_lru(std::size_t capacity, F f)
+{
+    static_assert(utils::function_traits<F>::arity == 1, "Wrong arity.");
+    assert(capacity > 0);
+    return memoized_function<F>(f, capacity);
+}
+
+} // namespace fplus
@@ -0,0 +1,685 @@
+// Copyright Tobias Hermann 2015.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include "container_common.h"
+#include "function_traits.h"
+#include "simd.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace fplus
+{
+
+// Task scheduler with one double-ended queue per worker thread.
+// Tasks spawned by a worker go to the back of its own queue
+// and are taken from there again (LIFO, cache friendly).
+// Idle workers steal from the front of the queue
+// of a randomly chosen other worker, i.e. they take the oldest
+// and usually biggest pieces of work.
+// This keeps all cores busy even if the costs of tasks differ a lot.
+class work_stealing_pool
+{
+public:
+    explicit work_stealing_pool(
+        std::size_t threadCount = std::thread::hardware_concurrency()) :
+        queues_(std::max<std::size_t>(1, threadCount)),
+        queuedTasks_(0),
+        stop_(false),
+        nextExternalQueue_(0)
+    {
+        for (std::size_t i = 0; i < queues_.size(); ++i)
+            workers_.emplace_back([this, i]() { work(i); });
+    }
+    ~work_stealing_pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex_);
+            stop_ = true;
+        }
+        sleepCondition_.notify_all();
+        for (auto& worker : workers_)
+            worker.join();
+    }
+    work_stealing_pool(const work_stealing_pool&) = delete;
+    work_stealing_pool& operator = (const work_stealing_pool&) = delete;
+
+    std::size_t size() const { return queues_.size(); }
+
+    // Schedules a task. Called from a worker of this pool
+    // the task goes to the worker's own queue,
+    // otherwise the queues are used round robin.
+    void spawn(std::function<void()> task)
+    {
+        const std::size_t idx = is_own_worker() ?
+            current_worker().idx :
+            nextExternalQueue_++ % queues_.size();
+        {
+            std::lock_guard<std::mutex> lock(queues_[idx].mutex);
+            queues_[idx].tasks.push_back(std::move(task));
+        }
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex_);
+            ++queuedTasks_;
+        }
+        sleepCondition_.notify_one();
+    }
+
+    // Runs one pending task if there is one.
+    // Used by threads waiting for a task group,
+    // so they help instead of blocking a core.
+    bool try_run_one()
+    {
+        std::function<void()> task;
+        if (!try_take(task))
+            return false;
+        task();
+        return true;
+    }
+
+private:
+    struct worker_queue
+    {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+    struct worker_id
+    {
+        const work_stealing_pool* pool;
+        std::size_t idx;
+        std::uint32_t randomState;
+    };
+    static worker_id& current_worker()
+    {
+        static thread_local worker_id id = {nullptr, 0, 0};
+        return id;
+    }
+    bool is_own_worker() const
+    {
+        return current_worker().pool == this;
+    }
+    // xorshift, good enough for picking victims
+    static std::size_t random_victim(std::uint32_t& state, std::size_t count)
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state % count;
+    }
+    bool pop_own(std::size_t idx, std::function<void()>& task)
+    {
+        std::lock_guard<std::mutex> lock(queues_[idx].mutex);
+        if (queues_[idx].tasks.empty())
+            return false;
+        task = std::move(queues_[idx].tasks.back());
+        queues_[idx].tasks.pop_back();
+        return true;
+    }
+    bool steal(std::size_t idx, std::function<void()>& task)
+    {
+        std::unique_lock<std::mutex> lock(queues_[idx].mutex, std::try_to_lock);
+        if (!lock.owns_lock() || queues_[idx].tasks.empty())
+            return false;
+        task = std::move(queues_[idx].tasks.front());
+        queues_[idx].tasks.pop_front();
+        return true;
+    }
+    bool try_take(std::function<void()>& task)
+    {
+        if (queuedTasks_ == 0)
+            return false;
+        worker_id& me = current_worker();
+        const bool isWorker = is_own_worker();
+        if (isWorker && pop_own(me.idx, task))
+        {
+            --queuedTasks_;
+            return true;
+        }
+        if (me.randomState == 0)
+            me.randomState = static_cast<std::uint32_t>(
+                std::hash<std::thread::id>()(std::this_thread::get_id())) | 1;
+        const std::size_t start = random_victim(me.randomState, queues_.size());
+        for (std::size_t i = 0; i < queues_.size(); ++i)
+        {
+            const std::size_t victim = (start + i) % queues_.size();
+            if (isWorker && victim == me.idx)
+                continue;
+            if (steal(victim, task))
+            {
+                --queuedTasks_;
+                return true;
+            }
+        }
+        return false;
+    }
+    void work(std::size_t idx)
+    {
+        current_worker().pool = this;
+        current_worker().idx = idx;
+        current_worker().randomState = static_cast<std::uint32_t>(idx) * 2654435761u + 1;
+        for (;;)
+        {
+            if (try_run_one())
+                continue;
+            std::unique_lock<std::mutex> lock(sleepMutex_);
+            sleepCondition_.wait(lock, [this]()
+                { return stop_ || queuedTasks_ > 0; });
+            if (stop_)
+                return;
+        }
+    }
+
+    std::vector<worker_queue> queues_;
+    std::vector<std::thread> workers_;
+    std::atomic<std::size_t> queuedTasks_;
+    std::mutex sleepMutex_;
+    std::condition_variable sleepCondition_;
+    bool stop_;
+    std::atomic<std::size_t> nextExternalQueue_;
+};
+
+// Process-wide pool with one worker per hardware thread,
+// used by the parallel fplus functions.
+inline work_stealing_pool& default_work_stealing_pool()
+{
+    static work_stealing_pool pool;
+    return pool;
+}
+
+// Set of tasks one can wait for.
+// Tasks may spawn further tasks into the same group.
+// While waiting, the calling thread executes pending tasks itself,
+// so nested waits inside of tasks do not deadlock.
+// The first exception thrown by a task is rethrown by wait,
+// tasks not started yet at that point are skipped.
+class task_group
+{
+public:
+    explicit task_group(work_stealing_pool& pool) :
+        pool_(pool), pending_(0), failed_(false), errorMutex_(), error_() {}
+    ~task_group() { wait_for_tasks(); }
+    task_group(const task_group&) = delete;
+    task_group& operator = (const task_group&) = delete;
+
+    template <typename F>
+    void run(F f)
+    {
+        ++pending_;
+        pool_.spawn([this, f]()
+        {
+            try
+            {
+                if (!failed_)
+                    f();
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(errorMutex_);
+                if (!error_)
+                    error_ = std::current_exception();
+                failed_ = true;
+            }
+            --pending_;
+        });
+    }
+    void wait()
+    {
+        wait_for_tasks();
+        std::exception_ptr error;
+        {
+            std::lock_guard<std::mutex> lock(errorMutex_);
+            std::swap(error, error_);
+        }
+        failed_ = false;
+        if (error)
+            std::rethrow_exception(error);
+    }
+    work_stealing_pool& pool() { return pool_; }
+
+private:
+    void wait_for_tasks()
+    {
+        while (pending_ != 0)
+        {
+            if (!pool_.try_run_one())
+                std::this_thread::yield();
+        }
+    }
+
+    work_stealing_pool& pool_;
+    std::atomic<std::size_t> pending_;
+    std::atomic<bool> failed_;
+    std::mutex errorMutex_;
+    std::exception_ptr error_;
+};
+
+// Calls f(i) for every i in [idxBegin, idxEnd).
+// The range is split in halves recursively down to grainSize,
+// one half being offered to other workers as a task,
+// so skewed costs per index are balanced by stealing.
+template <typename F>
+void parallel_for_idx_range(task_group& group,
+    std::size_t idxBegin, std::size_t idxEnd, std::size_t grainSize,
+    const F& f)
+{
+    assert(grainSize > 0);
+    while (idxEnd - idxBegin > grainSize)
+    {
+        const std::size_t idxMid = idxBegin + (idxEnd - idxBegin) / 2;
+        group.run([&group, idxMid, idxEnd, grainSize, &f]()
+        {
+            parallel_for_idx_range(group, idxMid, idxEnd, grainSize, f);
+        });
+        idxEnd = idxMid;
+    }
+    for (std::size_t i = idxBegin; i < idxEnd; ++i)
+        f(i);
+}
+
+// Default grain size: enough pieces for stealing to balance the load,
+// but not so many that scheduling dominates for cheap elements.
+inline std::size_t default_grain_size(std::size_t count,
+    const work_stealing_pool& pool)
+{
+    return std::max<std::size_t>(1, count / (16 * pool.size()));
+}
+
+// Calls f(i) for every i in [0, count) on the given pool
+// and returns when all calls are done.
+template <typename F>
+void parallel_for_idx(work_stealing_pool& pool, std::size_t count,
+    std::size_t grainSize, const F& f)
+{
+    task_group group(pool);
+    parallel_for_idx_range(group, 0, count, grainSize, f);
+    group.wait();
+}
+
+// Hands over the collected results without copying them
+// if the requested container is a vector anyway.
+template <typename ContainerOut, typename Y>
+typename std::enable_if<std::is_same<ContainerOut, std::vector<Y>>::value,
+    ContainerOut>::type
+vector_to_container(std::vector<Y>&& ys)
+{
+    return std::move(ys);
+}
+
+template <typename ContainerOut, typename Y>
+typename std::enable_if<!std::is_same<ContainerOut, std::vector<Y>>::value,
+    ContainerOut>::type
+vector_to_container(std::vector<Y>&& ys)
+{
+    return convert_container<ContainerOut>(ys);
+}
+
+// Collects the results of a parallel transformation by index.
+// std::vector<bool> packs neighbouring elements into the same word,
+// so tasks writing to it concurrently would race.
+// Its bools are therefore gathered in a plain array first.
+template <typename Y>
+class parallel_results
+{
+public:
+    explicit parallel_results(std::size_t size) : ys_(size) {}
+    Y& operator[](std::size_t i) { return ys_[i]; }
+    std::vector<Y> release() { return std::move(ys_); }
+private:
+    std::vector<Y> ys_;
+};
+
+template <>
+class parallel_results<bool>
+{
+public:
+    explicit parallel_results(std::size_t size) :
+        size_(size), ys_(new bool[size]()) {}
+    bool& operator[](std::size_t i) { return ys_[i]; }
+    std::vector<bool> release()
+    {
+        return std::vector<bool>(ys_.get(), ys_.get() + size_);
+    }
+private:
+    std::size_t size_;
+    std::unique_ptr<bool[]> ys_;
+};
+
+// transform_parallelly((*2), [1, 3, 4]) == [2, 6, 8]
+// Like transform, but f is applied on multiple threads
+// using the default work-stealing pool.
+// Well suited for elements with very different processing costs,
+// e.g. f being applied to the inner containers of nested containers.
+// f may itself call parallel fplus functions.
+// The elements of the result must be default constructible.
+template <typename F, typename ContainerIn,
+    typename ContainerOut =
+        typename same_cont_new_t_from_unary_f<ContainerIn, F>::type>
+ContainerOut transform_parallelly(F f, const ContainerIn& xs)
+{
+    static_assert(utils::function_traits<F>::arity == 1, "Wrong arity.");
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
+    typedef typename ContainerOut::value_type Y;
+    std::vector<typename ContainerIn::const_iterator> its;
+    its.reserve(size_of_cont(xs));
+    for (auto it = std::begin(xs); it != std::end(xs); ++it)
+        its.push_back(it);
+    parallel_results<Y> results(its.size());
+    work_stealing_pool& pool = default_work_stealing_pool();
+    parallel_for_idx(pool, its.size(), default_grain_size(its.size(), pool),
+        [&](std::size_t i) { results[i] = f(*its[i]); });
+    FPLUS_PROFILE_OUTPUT(its.size());
+    return vector_to_container<ContainerOut>(results.release());
+}
+
+// transform_and_concat_parallelly(f, xs) == concat(transform_parallelly(f, xs))
+// (a -> [b]) -> [a] -> [b]
+template <typename F, typename ContainerIn,
+    typename ContainerOut =
+        typename same_cont_new_t_from_unary_f<ContainerIn, F>::type::value_type>
+ContainerOut transform_and_concat_parallelly(F f, const ContainerIn& xs)
+{
+    static_assert(utils::function_traits<F>::arity == 1, "Wrong arity.");
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
+    return concat(transform_parallelly(f, xs));
+}
+
+// Number of elements per block of the parallel scans.
+// It does not depend on the number of threads,
+// so the order in which f combines the values,
+// and with it every floating-point rounding, is the same on every machine.
+inline std::size_t scan_block_size()
+{
+    return 1 << 16;
+}
+
+// True for pointers and std::vector iterators to T,
+// i.e. the iterators the parallel scans get for vectors.
+template <typename It, typename T>
+struct is_contiguous_iterator_to : public std::integral_constant<bool,
+    std::is_same<It, T*>::value || std::is_same<It, const T*>::value ||
+    std::is_same<It, typename std::vector<T>::iterator>::value ||
+    std::is_same<It, typename std::vector<T>::const_iterator>::value> {};
+
+// Sums of 32 or 64 bit integers wrap around in the same way
+// no matter in which order they are added,
+// so they can be scanned several elements at a time.
+template <typename F, typename Acc, typename InputIt, typename OutputIt>
+struct is_vectorizable_scan_sum : public std::integral_constant<bool,
+    std::is_same<F, std::plus<Acc>>::value &&
+    std::is_integral<Acc>::value && !std::is_same<Acc, bool>::value &&
+    (sizeof(Acc) == 4 || sizeof(Acc) == 8) &&
+    is_contiguous_iterator_to<InputIt, Acc>::value &&
+    is_contiguous_iterator_to<OutputIt, Acc>::value> {};
+
+#ifdef FPLUS_SSE2
+// Integer lanes of one SSE2 register.
+template <std::size_t Bytes> struct sse2_int_lanes;
+
+template <> struct sse2_int_lanes<4>
+{
+    static __m128i set1(std::int32_t x) { return _mm_set1_epi32(x); }
+    static __m128i add(__m128i a, __m128i b) { return _mm_add_epi32(a, b); }
+    static __m128i sub(__m128i a, __m128i b) { return _mm_sub_epi32(a, b); }
+    static __m128i inclusive_sums(__m128i x)
+    {
+        x = add(x, _mm_slli_si128(x, 4));
+        return add(x, _mm_slli_si128(x, 8));
+    }
+    static __m128i broadcast_last(__m128i x) { return _mm_shuffle_epi32(x, 0xff); }
+};
+
+template <> struct sse2_int_lanes<8>
+{
+    static __m128i set1(std::int64_t x) { return _mm_set1_epi64x(x); }
+    static __m128i add(__m128i a, __m128i b) { return _mm_add_epi64(a, b); }
+    static __m128i sub(__m128i a, __m128i b) { return _mm_sub_epi64(a, b); }
+    static __m128i inclusive_sums(__m128i x)
+    {
+        return add(x, _mm_slli_si128(x, 8));
+    }
+    static __m128i broadcast_last(__m128i x) { return _mm_shuffle_epi32(x, 0xee); }
+};
+#endif
+
+// Prefix sums of [xs, xs + count) starting with acc.
+// With SSE2 every step adds one register of elements
+// to the broadcast running sum,
+// using log2(lanes) shifted additions for the sums within the register.
+template <typename T>
+T scan_sum_contiguous(T acc, const T* xs, std::size_t count, T* out,
+    bool inclusive)
+{
+    std::size_t i = 0;
+#ifdef FPLUS_SSE2
+    typedef sse2_int_lanes<sizeof(T)> lanes;
+    const std::size_t lanesCount = 16 / sizeof(T);
+    if (count >= lanesCount)
+    {
+        __m128i carry = lanes::set1(acc);
+        for (; i + lanesCount <= count; i += lanesCount)
+        {
+            const __m128i x = _mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(xs + i));
+            const __m128i sums = lanes::add(lanes::inclusive_sums(x), carry);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i),
+                inclusive ? sums : lanes::sub(sums, x));
+            carry = lanes::broadcast_last(sums);
+        }
+        T carried[16 / sizeof(T)];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(carried), carry);
+        acc = carried[0];
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        if (!inclusive)
+            out[i] = acc;
+        typedef std::make_unsigned_t<T> U;
+        acc = static_cast<T>(static_cast<U>(acc) + static_cast<U>(xs[i]));
+        if (inclusive)
+            out[i] = acc;
+    }
+    return acc;
+}
+
+template <typename F, typename Acc, typename InputIt, typename OutputIt>
+Acc scan_block(F& f, Acc acc, InputIt first, InputIt last,
+    OutputIt out, bool inclusive, std::false_type)
+{
+    if (inclusive)
+    {
+        for (; first != last; ++first, ++out)
+        {
+            acc = f(acc, *first);
+            *out = acc;
+        }
+    }
+    else
+    {
+        for (; first != last; ++first, ++out)
+        {
+            *out = acc;
+            acc = f(acc, *first);
+        }
+    }
+    return acc;
+}
+
+template <typename F, typename Acc, typename InputIt, typename OutputIt>
+Acc scan_block(F&, Acc acc, InputIt first, InputIt last,
+    OutputIt out, bool inclusive, std::true_type)
+{
+    const std::size_t count = static_cast<std::size_t>(last - first);
+    if (count == 0)
+        return acc;
+    return scan_sum_contiguous(acc, &*first, count, &*out, inclusive);
+}
+
+// Two-pass blocked prefix scan on the given pool,
+// writing count results to out and returning the overall result.
+// inclusive: out[i] = init `f` x[0] `f` ... `f` x[i]
+// exclusive: out[i] = init `f` x[0] `f` ... `f` x[i - 1]
+// Pass 1 reduces every block but the last one on its own,
+// the block offsets are then combined sequentially,
+// and pass 2 scans every block again starting from its offset.
+// f must be associative, and able to combine two accumulators.
+// std::plus of 32 or 64 bit integers on vectors is scanned
+// with the SSE2 kernel of scan_sum_contiguous,
+// other types and functions element by element.
+template <typename F, typename Acc, typename InputIt, typename OutputIt>
+Acc scan_left_blocks_parallelly(work_stealing_pool& pool, F f,
+    const Acc& init, InputIt xsBegin, std::size_t count, OutputIt out,
+    bool inclusive)
+{
+    static_assert(std::is_convertible<
+        typename std::iterator_traits<InputIt>::value_type, Acc>::value,
+        "Elements must be convertible to the accumulator type.");
+    const std::size_t blockSize = scan_block_size();
+    const std::size_t blockCount = (count + blockSize - 1) / blockSize;
+
+    const is_vectorizable_scan_sum<F, Acc, InputIt, OutputIt> vectorizable;
+    auto scan_one_block = [&f, inclusive, vectorizable](Acc acc,
+        InputIt first, InputIt last, OutputIt blockOut) -> Acc
+    {
+        return scan_block(f, acc, first, last, blockOut, inclusive, vectorizable);
+    };
+
+    if (blockCount <= 1)
+        return scan_one_block(init, xsBegin, xsBegin + static_cast<std::ptrdiff_t>(count), out);
+
+    auto block_begin = [xsBegin, blockSize](std::size_t b)
+        { return xsBegin + static_cast<std::ptrdiff_t>(b * blockSize); };
+    auto block_end = [xsBegin, blockSize, count](std::size_t b)
+    {
+        return xsBegin + static_cast<std::ptrdiff_t>(
+            std::min(count, (b + 1) * blockSize));
+    };
+
+    std::vector<Acc> blockOffsets(blockCount, init);
+    parallel_for_idx(pool, blockCount - 1, 1, [&](std::size_t b)
+    {
+        auto it = block_begin(b);
+        const auto itEnd = block_end(b);
+        Acc acc = *it;
+        for (++it; it != itEnd; ++it)
+            acc = f(acc, *it);
+        blockOffsets[b + 1] = acc;
+    });
+    for (std::size_t b = 1; b < blockCount; ++b)
+        blockOffsets[b] = f(blockOffsets[b - 1], blockOffsets[b]);
+
+    Acc total = init;
+    parallel_for_idx(pool, blockCount, 1, [&](std::size_t b)
+    {
+        const Acc blockResult = scan_one_block(blockOffsets[b],
+            block_begin(b), block_end(b),
+            out + static_cast<std::ptrdiff_t>(b * blockSize));
+        if (b + 1 == blockCount)
+            total = blockResult;
+    });
+    return total;
+}
+
+// Random-access input is scanned in place, other containers are copied.
+template <typename ContainerIn>
+const ContainerIn& as_random_access(const ContainerIn& xs, std::true_type)
+{
+    return xs;
+}
+
+template <typename ContainerIn,
+    typename T = typename ContainerIn::value_type>
+std::vector<T> as_random_access(const ContainerIn& xs, std::false_type)
+{
+    return convert_container<std::vector<T>>(xs);
+}
+
+template <typename ContainerIn>
+decltype(auto) as_random_access(const ContainerIn& xs)
+{
+    return as_random_access(xs, std::integral_constant<bool,
+        std::is_base_of<std::random_access_iterator_tag,
+            typename std::iterator_traits<
+                typename ContainerIn::const_iterator>::iterator_category
+        >::value>());
+}
+
+// scan_left_parallelly((+), 0, [1, 2, 3]) == [0, 1, 3, 6]
+// Multithreaded version of scan_left using the default work-stealing pool.
+// f must be associative, e.g. (+), (*), min or max,
+// and must accept accumulators as second parameter too.
+// The accumulator must be default constructible.
+template <typename F, typename ContainerIn,
+    typename Acc = std::decay_t<
+        typename utils::function_traits<F>::template arg<0>::type>,
+    typename ContainerOut = typename same_cont_new_t<ContainerIn, Acc>::type>
+ContainerOut scan_left_parallelly(F f, const Acc& init, const ContainerIn& xs)
+{
+    static_assert(utils::function_traits<F>::arity == 2, "Wrong arity.");
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
+    const auto& ys = as_random_access(xs);
+    const std::size_t count = size_of_cont(ys);
+    std::vector<Acc> result(count + 1);
+    result[count] = scan_left_blocks_parallelly(default_work_stealing_pool(),
+        f, init, std::begin(ys), count, std::begin(result), false);
+    FPLUS_PROFILE_OUTPUT(result.size());
+    return vector_to_container<ContainerOut>(std::move(result));
+}
+
+// scan_left_inclusive_parallelly((+), 0, [1, 2, 3]) == [1, 3, 6]
+// Like scan_left_parallelly, but without the initial value.
+template <typename F, typename ContainerIn,
+    typename Acc = std::decay_t<
+        typename utils::function_traits<F>::template arg<0>::type>,
+    typename ContainerOut = typename same_cont_new_t<ContainerIn, Acc>::type>
+ContainerOut scan_left_inclusive_parallelly(F f, const Acc& init,
+    const ContainerIn& xs)
+{
+    static_assert(utils::function_traits<F>::arity == 2, "Wrong arity.");
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
+    const auto& ys = as_random_access(xs);
+    const std::size_t count = size_of_cont(ys);
+    std::vector<Acc> result(count);
+    scan_left_blocks_parallelly(default_work_stealing_pool(),
+        f, init, std::begin(ys), count, std::begin(result), true);
+    FPLUS_PROFILE_OUTPUT(result.size());
+    return vector_to_container<ContainerOut>(std::move(result));
+}
+
+// scan_left_exclusive_parallelly((+), 0, [1, 2, 3]) == [0, 1, 3]
+// Like scan_left_parallelly, but without the overall result.
+template <typename F, typename ContainerIn,
+    typename Acc = std::decay_t<
+        typename utils::function_traits<F>::template arg<0>::type>,
+    typename ContainerOut = typename same_cont_new_t<ContainerIn, Acc>::type>
+ContainerOut scan_left_exclusive_parallelly(F f, const Acc& init,
+    const ContainerIn& xs)
+{
+    static_assert(utils::function_traits<F>::arity == 2, "Wrong arity.");
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
+    const auto& ys = as_random_access(xs);
+    const std::size_t count = size_of_cont(ys);
+    std::vector<Acc> result(count);
+    scan_left_blocks_parallelly(default_work_stealing_pool(),
+        f, init, std::begin(ys), count, std::begin(result), false);
+    FPLUS_PROFILE_OUTPUT(result.size());
+    return vector_to_container<ContainerOut>(std::move(result));
+}
+
+} // namespace fplus
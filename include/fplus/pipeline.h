@@ -0,0 +1,449 @@
+// Copyright Tobias Hermann 2015.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include "container_common.h"
+#include "filter.h"
+#include "function_traits.h"
+#include "transform.h"
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace fplus
+{
+
+// Bounded lock-free ring buffer for exactly one producer thread
+// and one consumer thread.
+// push blocks while the queue is full,
+// which propagates backpressure to the producer.
+// pop blocks while the queue is empty
+// and returns false once the queue is closed and drained.
+// Both spin only briefly before sleeping on a condition variable,
+// so a stalled stage does not keep a core busy.
+// After cancel, push drops its element and pop returns false at once.
+template <typename T>
+class bounded_spsc_queue
+{
+public:
+    explicit bounded_spsc_queue(std::size_t capacity) :
+        slots_(capacity + 1), head_(0), tail_(0),
+        closed_(false), cancelled_(false), sleepers_(0),
+        mutex_(), condition_()
+    {
+        assert(capacity > 0);
+    }
+    bool try_push(T& x)
+    {
+        if (!push_if_not_full(x))
+            return false;
+        wake_sleepers();
+        return true;
+    }
+    bool try_pop(T& x)
+    {
+        if (!pop_if_not_empty(x))
+            return false;
+        wake_sleepers();
+        return true;
+    }
+    void push(T x)
+    {
+        wait_until([&]() { return cancelled() || push_if_not_full(x); });
+        wake_sleepers();
+    }
+    bool pop(T& x)
+    {
+        bool popped = false;
+        wait_until([&]()
+        {
+            if (cancelled())
+                return true;
+            // closed_ has to be read before the last try,
+            // otherwise a push right before close could be missed.
+            const bool closed = closed_.load(std::memory_order_acquire);
+            popped = pop_if_not_empty(x);
+            return popped || closed;
+        });
+        if (popped)
+            wake_sleepers();
+        return popped;
+    }
+    // Called by the producer after its last push.
+    void close()
+    {
+        closed_.store(true, std::memory_order_release);
+        wake_sleepers();
+    }
+    // Called if the pipeline fails,
+    // so neither side waits for the other any longer.
+    void cancel()
+    {
+        cancelled_.store(true, std::memory_order_release);
+        wake_sleepers();
+    }
+    bool cancelled() const
+    {
+        return cancelled_.load(std::memory_order_acquire);
+    }
+private:
+    static std::size_t spin_count() { return 64; }
+    std::size_t increment(std::size_t idx) const
+    {
+        return idx + 1 == slots_.size() ? 0 : idx + 1;
+    }
+    bool push_if_not_full(T& x)
+    {
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        const std::size_t next = increment(tail);
+        if (next == head_.load(std::memory_order_acquire))
+            return false;
+        slots_[tail] = std::move(x);
+        tail_.store(next, std::memory_order_release);
+        return true;
+    }
+    bool pop_if_not_empty(T& x)
+    {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire))
+            return false;
+        x = std::move(slots_[head]);
+        head_.store(increment(head), std::memory_order_release);
+        return true;
+    }
+    template <typename Pred>
+    void wait_until(Pred done)
+    {
+        for (std::size_t i = 0; i < spin_count(); ++i)
+        {
+            if (done())
+                return;
+        }
+        std::unique_lock<std::mutex> lock(mutex_);
+        ++sleepers_;
+        condition_.wait(lock, done);
+        --sleepers_;
+    }
+    // Taking the lock makes sure a sleeper either sees the change
+    // when checking its condition, or is already waiting to be notified.
+    // It is uncontended unless somebody sleeps,
+    // and only taken once per element of the queue, i.e. per batch.
+    void wake_sleepers()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (sleepers_ != 0)
+            condition_.notify_all();
+    }
+    std::vector<T> slots_;
+    std::atomic<std::size_t> head_;
+    std::atomic<std::size_t> tail_;
+    std::atomic<bool> closed_;
+    std::atomic<bool> cancelled_;
+    std::size_t sleepers_;
+    std::mutex mutex_;
+    std::condition_variable condition_;
+};
+
+// Throughput counters of one pipeline stage,
+// filled during pipeline::run.
+struct pipeline_stage_stats
+{
+    pipeline_stage_stats() :
+        name(), items_in(0), items_out(0), batches(0), busy_seconds(0) {}
+    std::string name;
+    std::size_t items_in;
+    std::size_t items_out;
+    std::size_t batches;
+    double busy_seconds;
+    // Elements processed per second of busy time.
+    double items_per_second() const
+    {
+        return busy_seconds > 0 ? static_cast<double>(items_in) / busy_seconds : 0;
+    }
+};
+
+// Everything the threads of one pipeline run need to share.
+// The first exception thrown on any of them is kept,
+// and all queues are cancelled, so the other threads stop too.
+struct pipeline_run_state
+{
+    pipeline_run_state() :
+        threads(), stats(), mutex_(), error_(), cancels_() {}
+
+    std::vector<std::thread> threads;
+    std::vector<pipeline_stage_stats> stats;
+
+    template <typename Queue>
+    void watch(const std::shared_ptr<Queue>& queue)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (error_)
+            queue->cancel();
+        cancels_.push_back([queue]() { queue->cancel(); });
+    }
+    void fail(std::exception_ptr error)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!error_)
+            error_ = error;
+        for (const auto& cancel : cancels_)
+            cancel();
+    }
+    std::exception_ptr error()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return error_;
+    }
+
+private:
+    std::mutex mutex_;
+    std::exception_ptr error_;
+    std::vector<std::function<void()>> cancels_;
+};
+
+// Chain of stages, each running on its own thread.
+// The input is cut into batches of batchSize elements.
+// Between two stages there is a bounded queue
+// holding up to queueCapacity batches.
+// Build it with make_pipeline and the member functions
+// transform, keep_if and drop_if, then call run.
+// The result is the same as the one of the sequential composition
+// of the corresponding fplus functions, including the order.
+// If a stage throws, the whole pipeline stops,
+// and run rethrows the first exception.
+template <typename In, typename Out>
+class pipeline
+{
+public:
+    typedef bounded_spsc_queue<std::vector<In>> in_queue_t;
+    typedef bounded_spsc_queue<std::vector<Out>> out_queue_t;
+    typedef std::function<std::shared_ptr<out_queue_t>(
+        std::shared_ptr<in_queue_t>, pipeline_run_state&)> launcher_t;
+
+    pipeline(std::size_t batchSize, std::size_t queueCapacity,
+        const std::vector<std::string>& stageNames, launcher_t launcher) :
+        batchSize_(batchSize),
+        queueCapacity_(queueCapacity),
+        stageNames_(stageNames),
+        launcher_(launcher),
+        stats_()
+    {
+        assert(batchSize_ > 0);
+        assert(queueCapacity_ > 0);
+    }
+
+    // Appends a stage applying f to every element.
+    template <typename F,
+        typename FOut = std::remove_const_t<std::remove_reference_t<
+            typename utils::function_traits<F>::result_type>>>
+    pipeline<In, FOut> transform(F f, const std::string& name = "transform") const
+    {
+        static_assert(utils::function_traits<F>::arity == 1, "Wrong arity.");
+        return add_stage<FOut>(name, [f](const std::vector<Out>& xs)
+        {
+            return fplus::transform_convert<std::vector<FOut>>(f, xs);
+        });
+    }
+
+    // Appends a stage only passing on elements fulfilling pred.
+    template <typename Pred>
+    pipeline<In, Out> keep_if(Pred pred, const std::string& name = "keep_if") const
+    {
+        check_unary_predicate_for_type<Pred, Out>();
+        return add_stage<Out>(name, [pred](const std::vector<Out>& xs)
+        {
+            return fplus::keep_if(pred, xs);
+        });
+    }
+
+    // Appends a stage dropping elements fulfilling pred.
+    template <typename Pred>
+    pipeline<In, Out> drop_if(Pred pred, const std::string& name = "drop_if") const
+    {
+        check_unary_predicate_for_type<Pred, Out>();
+        return add_stage<Out>(name, [pred](const std::vector<Out>& xs)
+        {
+            return fplus::drop_if(pred, xs);
+        });
+    }
+
+    // Feeds xs through all stages and folds the results
+    // on the calling thread while the stages are still running.
+    template <typename F, typename Acc, typename ContainerIn>
+    Acc run_and_fold(F f, const Acc& init, const ContainerIn& xs)
+    {
+        static_assert(std::is_convertible<
+            typename ContainerIn::value_type, In>::value,
+            "Pipeline can not take elements of this container.");
+        pipeline_run_state state;
+        state.stats.resize(stageNames_.size());
+        for (std::size_t i = 0; i < stageNames_.size(); ++i)
+            state.stats[i].name = stageNames_[i];
+
+        auto source = std::make_shared<in_queue_t>(queueCapacity_);
+        state.watch(source);
+        auto sink = launcher_(source, state);
+
+        const std::size_t batchSize = batchSize_;
+        std::thread producer([source, batchSize, &xs, &state]()
+        {
+            try
+            {
+                std::vector<In> batch;
+                batch.reserve(batchSize);
+                for (const auto& x : xs)
+                {
+                    batch.push_back(x);
+                    if (batch.size() == batchSize)
+                    {
+                        source->push(std::move(batch));
+                        if (source->cancelled())
+                            break;
+                        batch = std::vector<In>();
+                        batch.reserve(batchSize);
+                    }
+                }
+                if (!batch.empty() && !source->cancelled())
+                    source->push(std::move(batch));
+            }
+            catch (...)
+            {
+                state.fail(std::current_exception());
+            }
+            source->close();
+        });
+
+        Acc acc = init;
+        try
+        {
+            std::vector<Out> batch;
+            while (sink->pop(batch))
+            {
+                for (const auto& y : batch)
+                    acc = f(acc, y);
+            }
+        }
+        catch (...)
+        {
+            state.fail(std::current_exception());
+        }
+
+        producer.join();
+        for (auto& thread : state.threads)
+            thread.join();
+        stats_ = state.stats;
+        if (state.error())
+            std::rethrow_exception(state.error());
+        return acc;
+    }
+
+    // Feeds xs through all stages and collects the results.
+    template <typename ContainerIn>
+    std::vector<Out> run(const ContainerIn& xs)
+    {
+        std::vector<Out> result;
+        auto append_one = [&result](int acc, const Out& y)
+        {
+            result.push_back(y);
+            return acc;
+        };
+        run_and_fold(append_one, 0, xs);
+        return result;
+    }
+
+    // Counters of every stage from the last call to run.
+    const std::vector<pipeline_stage_stats>& stats() const
+    {
+        return stats_;
+    }
+
+    std::size_t batch_size() const { return batchSize_; }
+    std::size_t queue_capacity() const { return queueCapacity_; }
+
+private:
+    template <typename NewOut, typename BatchF>
+    pipeline<In, NewOut> add_stage(const std::string& name, BatchF g) const
+    {
+        typedef bounded_spsc_queue<std::vector<NewOut>> new_out_queue_t;
+        const std::size_t stageIdx = stageNames_.size();
+        const std::size_t queueCapacity = queueCapacity_;
+        const launcher_t previous = launcher_;
+        auto launcher = [previous, g, stageIdx, queueCapacity]
+            (std::shared_ptr<in_queue_t> source, pipeline_run_state& state)
+        {
+            std::shared_ptr<out_queue_t> stageIn = previous(source, state);
+            auto stageOut = std::make_shared<new_out_queue_t>(queueCapacity);
+            state.watch(stageOut);
+            pipeline_stage_stats* stats = &state.stats[stageIdx];
+            pipeline_run_state* sharedState = &state;
+            state.threads.emplace_back([g, stageIn, stageOut, stats, sharedState]()
+            {
+                typedef std::chrono::steady_clock Clock;
+                try
+                {
+                    std::vector<Out> batch;
+                    while (stageIn->pop(batch))
+                    {
+                        const auto startTime = Clock::now();
+                        std::vector<NewOut> result = g(batch);
+                        const std::chrono::duration<double> elapsed =
+                            Clock::now() - startTime;
+                        stats->busy_seconds += elapsed.count();
+                        stats->items_in += batch.size();
+                        stats->items_out += result.size();
+                        ++stats->batches;
+                        if (!result.empty())
+                            stageOut->push(std::move(result));
+                    }
+                }
+                catch (...)
+                {
+                    sharedState->fail(std::current_exception());
+                }
+                stageOut->close();
+            });
+            return stageOut;
+        };
+        std::vector<std::string> stageNames = stageNames_;
+        stageNames.push_back(name);
+        return pipeline<In, NewOut>(batchSize_, queueCapacity_,
+            stageNames, launcher);
+    }
+
+    std::size_t batchSize_;
+    std::size_t queueCapacity_;
+    std::vector<std::string> stageNames_;
+    launcher_t launcher_;
+    std::vector<pipeline_stage_stats> stats_;
+};
+
+// Starts building a pipeline taking elements of type In.
+// make_pipeline<std::string>(1024, 8)
+//     .transform(parse).keep_if(is_valid).run(lines)
+// == keep_if(is_valid, transform(parse, lines))
+template <typename In>
+pipeline<In, In> make_pipeline(std::size_t batchSize = 1024,
+    std::size_t queueCapacity = 8)
+{
+    typedef typename pipeline<In, In>::in_queue_t queue_t;
+    auto identity_launcher = [](std::shared_ptr<queue_t> source,
+        pipeline_run_state&) { return source; };
+    return pipeline<In, In>(batchSize, queueCapacity,
+        std::vector<std::string>(), identity_launcher);
+}
+
+} // namespace fplus
@@ -0,0 +1,244 @@
+// Copyright Tobias Hermann 2015.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include "profiling_macros.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fplus
+{
+
+// Coverage of the probes:
+// Every function that walks a whole container records an event
+// under its own name, also if it is composed of other probed functions,
+// so the time of a pipeline is booked to each of its stages.
+// This includes the algorithms of aggregate.h, container_common.h,
+// filter.h, joins.h, maps.h, parallel.h, radix_sort.h, rolling.h,
+// serialize.h, sets.h, split.h, string_pool.h, string_tools.h,
+// top_k.h and transform.h.
+// Not instrumented are:
+// - Forwarders whose work is recorded by the probed functions they call:
+//   drop_if, drop_if_with_idx, drop_by_idx, drop_if_by_mask, without,
+//   nub, group, take, drop, split_at_idx, map_drop_if, map_to_pairs,
+//   top_k, smallest_k and partial_sort.
+// - Lookups of single elements or keys, e.g. nth_element,
+//   get_from_map, get_ptr_from_map, get_from_map_or_insert and contains.
+// - The functions of compare.h, composition.h, container_properties.h,
+//   generate.h, numeric.h, pairs.h, replace.h, search.h and show.h.
+// - The members of the containers (bitvector, flat_map, flat_hash_map,
+//   small_vector, soa_vector, static_vector, string_pool),
+//   eytzinger_index, memoize and the stages of pipeline.h.
+
+inline bool profiling_enabled()
+{
+#ifdef FPLUS_PROFILE
+    return true;
+#else
+    return false;
+#endif
+}
+
+// Returns the number of bytes allocated so far.
+// fplus can not observe allocations on its own,
+// so e.g. a counting global operator new has to provide it.
+typedef std::size_t (*allocated_bytes_counter)();
+
+// One call of an instrumented function.
+// allocatedBytes is the difference of the counter over the call
+// and includes the allocations of nested calls.
+struct profile_event
+{
+    const char* name;
+    std::size_t thread;
+    std::int64_t startNs;
+    std::int64_t durationNs;
+    std::size_t inputSize;
+    std::size_t outputSize;
+    std::size_t allocatedBytes;
+};
+
+// Thread-safe store of the recorded profile events.
+class profile_collector
+{
+public:
+    profile_collector() :
+        mutex_(), events_(), threadNumbers_(),
+        counter_(nullptr), epoch_(std::chrono::steady_clock::now())
+    {
+    }
+    profile_collector(const profile_collector&) = delete;
+    profile_collector& operator=(const profile_collector&) = delete;
+
+    void set_allocated_bytes_counter(allocated_bytes_counter counter)
+    {
+        counter_ = counter;
+    }
+
+    std::size_t allocated_bytes() const
+    {
+        const allocated_bytes_counter counter = counter_;
+        return counter ? counter() : 0;
+    }
+
+    // Nanoseconds since the construction of the collector.
+    std::int64_t now_ns() const
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - epoch_).count();
+    }
+
+    // Must be called on the thread that made the call.
+    void record(profile_event event)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto inserted = threadNumbers_.insert(std::make_pair(
+            std::this_thread::get_id(), threadNumbers_.size()));
+        event.thread = inserted.first->second;
+        events_.push_back(event);
+    }
+
+    std::vector<profile_event> events() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return events_;
+    }
+
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        events_.clear();
+    }
+
+    // Complete events ("ph": "X") in the Trace Event Format,
+    // loadable with chrome://tracing or ui.perfetto.dev.
+    std::string chrome_trace_json() const
+    {
+        const auto recorded = events();
+        std::ostringstream out;
+        out << std::fixed << std::setprecision(3);
+        out << "{\"traceEvents\":[";
+        for (std::size_t i = 0; i < recorded.size(); ++i)
+        {
+            const profile_event& e = recorded[i];
+            out << (i == 0 ? "\n" : ",\n")
+                << "{\"name\":\"" << e.name << "\",\"cat\":\"fplus\""
+                << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << e.thread
+                << ",\"ts\":" << static_cast<double>(e.startNs) / 1000.0
+                << ",\"dur\":" << static_cast<double>(e.durationNs) / 1000.0
+                << ",\"args\":{\"input_size\":" << e.inputSize
+                << ",\"output_size\":" << e.outputSize
+                << ",\"allocated_bytes\":" << e.allocatedBytes << "}}";
+        }
+        out << "\n],\"displayTimeUnit\":\"ns\"}\n";
+        return out.str();
+    }
+
+    // One line per function, the most expensive first.
+    std::string summary() const
+    {
+        struct totals
+        {
+            std::size_t calls;
+            std::int64_t durationNs;
+            std::size_t inputSize;
+            std::size_t outputSize;
+            std::size_t allocatedBytes;
+        };
+        std::map<std::string, totals> byName;
+        for (const profile_event& e : events())
+        {
+            totals& t = byName[e.name];
+            t.calls += 1;
+            t.durationNs += e.durationNs;
+            t.inputSize += e.inputSize;
+            t.outputSize += e.outputSize;
+            t.allocatedBytes += e.allocatedBytes;
+        }
+        std::vector<std::pair<std::string, totals>> rows(
+            std::begin(byName), std::end(byName));
+        std::stable_sort(std::begin(rows), std::end(rows),
+            [](const auto& x, const auto& y)
+            { return x.second.durationNs > y.second.durationNs; });
+        std::ostringstream out;
+        out << std::left << std::setw(32) << "function" << std::right
+            << std::setw(10) << "calls" << std::setw(14) << "total ms"
+            << std::setw(14) << "mean us" << std::setw(14) << "input"
+            << std::setw(14) << "output" << std::setw(16) << "bytes" << "\n";
+        out << std::fixed << std::setprecision(3);
+        for (const auto& row : rows)
+        {
+            const totals& t = row.second;
+            const double totalNs = static_cast<double>(t.durationNs);
+            out << std::left << std::setw(32) << row.first << std::right
+                << std::setw(10) << t.calls
+                << std::setw(14) << totalNs / 1000000.0
+                << std::setw(14) << totalNs / 1000.0 / static_cast<double>(t.calls)
+                << std::setw(14) << t.inputSize
+                << std::setw(14) << t.outputSize
+                << std::setw(16) << t.allocatedBytes << "\n";
+        }
+        return out.str();
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::vector<profile_event> events_;
+    std::map<std::thread::id, std::size_t> threadNumbers_;
+    std::atomic<allocated_bytes_counter> counter_;
+    std::chrono::steady_clock::time_point epoch_;
+};
+
+inline profile_collector& default_profile_collector()
+{
+    static profile_collector collector;
+    return collector;
+}
+
+// Records the call of the enclosing function when going out of scope.
+class profile_probe
+{
+public:
+    profile_probe(const char* name, std::size_t inputSize,
+            profile_collector& collector = default_profile_collector()) :
+        collector_(collector),
+        event_{name, 0, 0, 0, inputSize, 0, collector.allocated_bytes()}
+    {
+        event_.startNs = collector_.now_ns();
+    }
+    profile_probe(const profile_probe&) = delete;
+    profile_probe& operator=(const profile_probe&) = delete;
+
+    void set_output_size(std::size_t outputSize)
+    {
+        event_.outputSize = outputSize;
+    }
+
+    ~profile_probe()
+    {
+        event_.durationNs = collector_.now_ns() - event_.startNs;
+        event_.allocatedBytes =
+            collector_.allocated_bytes() - event_.allocatedBytes;
+        collector_.record(event_);
+    }
+
+private:
+    profile_collector& collector_;
+    profile_event event_;
+};
+
+} // namespace fplus
@@ -0,0 +1,23 @@
+// Copyright Tobias Hermann 2015.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+// The probes of the instrumented fplus functions.
+// Compiling with FPLUS_PROFILE defined lets them record
+// a profile_event for every call (see profiling.h).
+// Without it they expand to nothing,
+// their arguments are not even evaluated,
+// and the collector is not included.
+#ifdef FPLUS_PROFILE
+#include "profiling.h"
+#define FPLUS_PROFILE_SCOPE(inputSize) \
+    ::fplus::profile_probe fplus_profile_probe_(__func__, (inputSize))
+#define FPLUS_PROFILE_OUTPUT(outputSize) \
+    fplus_profile_probe_.set_output_size(outputSize)
+#else
+#define FPLUS_PROFILE_SCOPE(inputSize) ((void)0)
+#define FPLUS_PROFILE_OUTPUT(outputSize) ((void)0)
+#endif
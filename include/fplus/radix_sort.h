@@ -0,0 +1,277 @@
+// Copyright Tobias Hermann 2015.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include "container_traits.h"
+#include "copy_audit_macros.h"
+#include "profiling_macros.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace fplus
+{
+
+// Maps a value to an unsigned integer with the same ordering,
+// so it can be sorted digit by digit.
+// Signed integers get their sign bit flipped.
+// For IEEE floats all bits of negative numbers are flipped,
+// while positive numbers only get their sign bit set.
+template <typename T, typename Enable = void>
+struct radix_key_traits
+{
+    static const bool supported = false;
+};
+
+template <typename T>
+struct radix_key_traits<T, typename std::enable_if<
+    std::is_integral<T>::value && !std::is_same<T, bool>::value>::type>
+{
+    static const bool supported = true;
+    typedef typename std::make_unsigned<T>::type key_type;
+    static key_type key(T x)
+    {
+        const key_type signBit = std::is_signed<T>::value ?
+            static_cast<key_type>(key_type(1) << (8 * sizeof(T) - 1)) :
+            key_type(0);
+        return static_cast<key_type>(static_cast<key_type>(x) ^ signBit);
+    }
+};
+
+template <typename T, typename Bits>
+struct radix_float_key_traits
+{
+    static_assert(sizeof(T) == sizeof(Bits), "Unexpected floating point size.");
+    static const bool supported = true;
+    typedef Bits key_type;
+    static key_type key(T x)
+    {
+        Bits bits;
+        std::memcpy(&bits, &x, sizeof(T));
+        const Bits signBit = Bits(1) << (8 * sizeof(T) - 1);
+        return (bits & signBit) ? static_cast<Bits>(~bits) : (bits | signBit);
+    }
+};
+
+template <>
+struct radix_key_traits<float> :
+    public radix_float_key_traits<float, std::uint32_t> {};
+
+template <>
+struct radix_key_traits<double> :
+    public radix_float_key_traits<double, std::uint64_t> {};
+
+// Is there a radix sort implementation for elements of type T?
+template <typename T>
+struct is_radix_sortable : public std::integral_constant<bool,
+    radix_key_traits<T>::supported ||
+    std::is_same<T, std::string>::value> {};
+
+// LSD radix sort with one byte per pass.
+// The histograms of all passes are built in one go,
+// and passes in which all elements share the same byte are skipped,
+// so e.g. small IDs in 64 bit integers only need a few passes.
+template <typename T>
+void radix_sort_lsd(T* xs, std::size_t n)
+{
+    typedef radix_key_traits<T> traits;
+    typedef typename traits::key_type Key;
+    const std::size_t passCount = sizeof(Key);
+    if (n < 2)
+        return;
+    std::vector<std::array<std::size_t, 256>> counts(passCount);
+    for (auto& histogram : counts)
+        histogram.fill(0);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        const Key key = traits::key(xs[i]);
+        for (std::size_t pass = 0; pass < passCount; ++pass)
+            ++counts[pass][(key >> (8 * pass)) & 0xff];
+    }
+    std::unique_ptr<T[]> buffer(new T[n]);
+    T* src = xs;
+    T* dst = buffer.get();
+    for (std::size_t pass = 0; pass < passCount; ++pass)
+    {
+        auto& histogram = counts[pass];
+        const std::size_t firstDigit = (traits::key(src[0]) >> (8 * pass)) & 0xff;
+        if (histogram[firstDigit] == n)
+            continue;
+        std::size_t offset = 0;
+        for (std::size_t& count : histogram)
+        {
+            const std::size_t digitCount = count;
+            count = offset;
+            offset += digitCount;
+        }
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            const std::size_t digit = (traits::key(src[i]) >> (8 * pass)) & 0xff;
+            dst[histogram[digit]++] = src[i];
+        }
+        std::swap(src, dst);
+    }
+    if (src != xs)
+        std::copy(src, src + n, xs);
+}
+
+// Character at position depth, or -1 after the end of the string,
+// so shorter strings are sorted before their extensions.
+inline int radix_char_at(const std::string* str, std::size_t depth)
+{
+    return depth < str->size() ?
+        static_cast<int>(static_cast<unsigned char>((*str)[depth])) : -1;
+}
+
+// Multikey quicksort (Bentley and Sedgewick).
+// Partitions three-way by the character at position depth
+// and only continues with the next character for the middle part,
+// so common prefixes are never compared again.
+// Pointers are sorted instead of the strings, since swapping them is cheaper.
+// Requires all strings in [xs, xs + n) to share the first depth characters.
+inline void radix_sort_multikey(std::string** xs, std::size_t n,
+    std::size_t depth)
+{
+    while (n > 1)
+    {
+        if (n < 16)
+        {
+            std::sort(xs, xs + n,
+                [depth](const std::string* a, const std::string* b)
+            {
+                return a->compare(depth, std::string::npos,
+                    *b, depth, std::string::npos) < 0;
+            });
+            return;
+        }
+        const int a = radix_char_at(xs[0], depth);
+        const int b = radix_char_at(xs[n / 2], depth);
+        const int c = radix_char_at(xs[n - 1], depth);
+        const int pivot = std::max(std::min(a, b), std::min(std::max(a, b), c));
+        std::size_t lt = 0;
+        std::size_t i = 0;
+        std::size_t gt = n;
+        while (i < gt)
+        {
+            const int ch = radix_char_at(xs[i], depth);
+            if (ch < pivot)
+                std::swap(xs[lt++], xs[i++]);
+            else if (ch > pivot)
+                std::swap(xs[i], xs[--gt]);
+            else
+                ++i;
+        }
+        radix_sort_multikey(xs, lt, depth);
+        radix_sort_multikey(xs + gt, n - gt, depth);
+        if (pivot < 0)
+            return;
+        xs += lt;
+        n = gt - lt;
+        ++depth;
+    }
+}
+
+template <typename T, typename Alloc>
+typename std::enable_if<radix_key_traits<T>::supported>::type
+radix_sort_vector(std::vector<T, Alloc>& xs)
+{
+    radix_sort_lsd(xs.data(), xs.size());
+}
+
+template <typename Alloc>
+void radix_sort_vector(std::vector<std::string, Alloc>& xs)
+{
+    std::vector<std::string*> ptrs;
+    ptrs.reserve(xs.size());
+    for (auto& x : xs)
+        ptrs.push_back(&x);
+    radix_sort_multikey(ptrs.data(), ptrs.size(), 0);
+    std::vector<std::string, Alloc> result;
+    result.reserve(xs.size());
+    for (std::string* ptr : ptrs)
+        result.push_back(std::move(*ptr));
+    xs.swap(result);
+}
+
+template <typename T, typename Alloc>
+void radix_sort_vector_if_possible(std::vector<T, Alloc>& xs, std::true_type)
+{
+    radix_sort_vector(xs);
+}
+
+template <typename T, typename Alloc>
+void radix_sort_vector_if_possible(std::vector<T, Alloc>&, std::false_type)
+{
+}
+
+// Below this size std::sort is faster
+// than setting up the histograms or partitions.
+inline std::size_t radix_sort_min_size()
+{
+    return 256;
+}
+
+// Moves the sorted elements into the requested container,
+// without copying the input a second time.
+template <typename Container, typename T>
+Container container_from_sorted(std::vector<T>&& elems, std::false_type)
+{
+    return Container(std::make_move_iterator(std::begin(elems)),
+        std::make_move_iterator(std::end(elems)));
+}
+
+template <typename Container, typename T>
+Container container_from_sorted(std::vector<T>&& elems, std::true_type)
+{
+    Container result{};
+    std::move(std::begin(elems), std::end(elems), std::begin(result));
+    return result;
+}
+
+// sort_radix([3, -1, 2]) == [-1, 2, 3]
+// Same result as sort, but always uses radix sort.
+// Supported are integers (except bool), float, double and std::string.
+// Does not compare elements, so runtime is linear in the number
+// of elements (times the key length for strings).
+// NaN values end up at the front (negative NaNs)
+// or the back (positive NaNs), and -0.0 is sorted before 0.0.
+template <typename Container>
+Container sort_radix(const Container& xs)
+{
+    typedef typename Container::value_type T;
+    static_assert(is_radix_sortable<T>::value,
+        "sort_radix does not support this element type.");
+    FPLUS_PROFILE_SCOPE(xs.size());
+    FPLUS_AUDIT_COPY(xs);
+    std::vector<T> elems(std::begin(xs), std::end(xs));
+    radix_sort_vector(elems);
+    FPLUS_PROFILE_OUTPUT(elems.size());
+    return container_from_sorted<Container>(std::move(elems),
+        is_std_array<Container>());
+}
+
+template <typename T, typename Alloc>
+std::vector<T, Alloc> sort_radix(const std::vector<T, Alloc>& xs)
+{
+    static_assert(is_radix_sortable<T>::value,
+        "sort_radix does not support this element type.");
+    FPLUS_PROFILE_SCOPE(xs.size());
+    FPLUS_AUDIT_COPY(xs);
+    auto result = xs;
+    radix_sort_vector(result);
+    FPLUS_PROFILE_OUTPUT(result.size());
+    return result;
+}
+
+} // namespace fplus
@@ -0,0 +1,175 @@
+// Copyright Tobias Hermann 2015.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include "container_common.h"
+#include "function_traits.h"
+
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+namespace fplus
+{
+
+// Folds every window of windowSize consecutive elements
+// without copying the windows:
+// The accumulator is updated with add(acc, x) for the element entering
+// and with remove(acc, x) for the element leaving the window.
+// One result per complete window, none if xs is shorter than the window.
+// windowed_fold(2, (+), (-), 0, [1, 2, 3, 4]) == [3, 5, 7]
+template <typename AddF, typename RemoveF, typename Acc, typename Container>
+std::vector<Acc> windowed_fold(std::size_t windowSize,
+    AddF add, RemoveF remove, const Acc& init, const Container& xs)
+{
+    static_assert(utils::function_traits<AddF>::arity == 2, "Wrong arity.");
+    static_assert(utils::function_traits<RemoveF>::arity == 2, "Wrong arity.");
+    assert(windowSize > 0);
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
+    std::vector<Acc> result;
+    const std::size_t size = size_of_cont(xs);
+    if (size < windowSize)
+        return result;
+    result.reserve(size - windowSize + 1);
+    Acc acc = init;
+    auto itIn = std::begin(xs);
+    for (std::size_t i = 0; i < windowSize; ++i, ++itIn)
+        acc = add(acc, *itIn);
+    result.push_back(acc);
+    for (auto itOut = std::begin(xs); itIn != std::end(xs); ++itIn, ++itOut)
+    {
+        acc = add(remove(acc, *itOut), *itIn);
+        result.push_back(acc);
+    }
+    FPLUS_PROFILE_OUTPUT(result.size());
+    return result;
+}
+
+// rolling_sum(3, [1, 2, 3, 4, 5]) == [6, 9, 12]
+// O(n) independent of the window size.
+// For floating-point values the incremental updates
+// may accumulate rounding errors over very long inputs.
+template <typename Container,
+    typename T = typename Container::value_type>
+std::vector<T> rolling_sum(std::size_t windowSize, const Container& xs)
+{
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
+    return windowed_fold(windowSize, std::plus<T>(), std::minus<T>(), T(), xs);
+}
+
+// rolling_mean<double>(2, [1, 2, 4, 4]) == [1.5, 3, 4]
+template <typename Result, typename Container>
+std::vector<Result> rolling_mean(std::size_t windowSize, const Container& xs)
+{
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
+    const auto sums = rolling_sum(windowSize, xs);
+    std::vector<Result> result;
+    result.reserve(sums.size());
+    for (const auto& windowSum : sums)
+        result.push_back(static_cast<Result>(windowSum) /
+            static_cast<Result>(windowSize));
+    FPLUS_PROFILE_OUTPUT(result.size());
+    return result;
+}
+
+// Fixed-capacity double-ended queue on a ring buffer,
+// holding the candidates of rolling_extremum_by.
+template <typename T>
+class rolling_ring_deque
+{
+public:
+    explicit rolling_ring_deque(std::size_t capacity) :
+        items_(capacity), head_(0), size_(0)
+    {
+    }
+
+    bool empty() const { return size_ == 0; }
+    const T& front() const { return items_[head_]; }
+    const T& back() const { return items_[wrap(head_ + size_ - 1)]; }
+
+    void pop_front()
+    {
+        head_ = wrap(head_ + 1);
+        --size_;
+    }
+
+    void pop_back() { --size_; }
+
+    void push_back(const T& x)
+    {
+        assert(size_ < items_.size());
+        items_[wrap(head_ + size_)] = x;
+        ++size_;
+    }
+
+private:
+    std::size_t wrap(std::size_t i) const
+    {
+        return i >= items_.size() ? i - items_.size() : i;
+    }
+
+    std::vector<T> items_;
+    std::size_t head_;
+    std::size_t size_;
+};
+
+// The extremum by comp (min for less) of every window.
+// A monotonic queue holds the elements that can still become
+// the extremum of a later window, each together with its position.
+// Every element enters and leaves it at most once,
+// so this is O(n) independent of the window size.
+template <typename Compare, typename Container,
+    typename T = typename Container::value_type>
+std::vector<T> rolling_extremum_by(Compare comp,
+    std::size_t windowSize, const Container& xs)
+{
+    assert(windowSize > 0);
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
+    std::vector<T> result;
+    const std::size_t size = size_of_cont(xs);
+    if (size < windowSize)
+        return result;
+    result.reserve(size - windowSize + 1);
+    rolling_ring_deque<std::pair<T, std::size_t>> candidates(windowSize);
+    std::size_t idx = 0;
+    for (const auto& x : xs)
+    {
+        if (!candidates.empty() &&
+                candidates.front().second + windowSize <= idx)
+            candidates.pop_front();
+        while (!candidates.empty() && !comp(candidates.back().first, x))
+            candidates.pop_back();
+        candidates.push_back(std::make_pair(x, idx));
+        if (idx + 1 >= windowSize)
+            result.push_back(candidates.front().first);
+        ++idx;
+    }
+    FPLUS_PROFILE_OUTPUT(result.size());
+    return result;
+}
+
+// rolling_min(2, [3, 1, 4, 1, 5]) == [1, 1, 1, 1]
+template <typename Container,
+    typename T = typename Container::value_type>
+std::vector<T> rolling_min(std::size_t windowSize, const Container& xs)
+{
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
+    return rolling_extremum_by(std::less<T>(), windowSize, xs);
+}
+
+// rolling_max(2, [3, 1, 4, 1, 5]) == [3, 4, 4, 5]
+template <typename Container,
+    typename T = typename Container::value_type>
+std::vector<T> rolling_max(std::size_t windowSize, const Container& xs)
+{
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
+    return rolling_extremum_by(std::greater<T>(), windowSize, xs);
+}
+
+} // namespace fplus
@@ -36,6 +36,7 @@ template <typename Container, typename UnaryPredicate,
 maybe<T> find_last_by(UnaryPredicate pred, const Container& xs)
 {
     check_unary_predicate_for_container<UnaryPredicate, Container>();
+    FPLUS_AUDIT_COPY_SCOPE();
     return find_first_by(pred, reverse(xs));
 }
 
@@ -59,6 +60,7 @@ maybe<std::size_t> find_last_idx_by
         (UnaryPredicate pred, const Container& xs)
 {
     check_unary_predicate_for_container<UnaryPredicate, Container>();
+    FPLUS_AUDIT_COPY_SCOPE();
     auto calcRevIdx = [&](std::size_t idx) {
         return size_of_cont(xs) - (idx + 1);
     };
@@ -142,29 +144,72 @@ ContainerOut find_all_instances_of_non_overlapping
     ContainerOut result;
     if (is_empty(token))
         return result;
-    typedef typename Container::value_type T;
-    auto tokenAsList = convert<std::list<T>>(token);
-    auto tokenRemaining = tokenAsList;
-    std::size_t idx = 0;
+    const std::size_t tokenSize = size_of_cont(token);
     auto itOut = get_back_inserter(result);
-    for (const T& x : xs)
+    std::size_t idx = 0;
+    auto it = std::begin(xs);
+    for (;;)
     {
-        if (x == tokenRemaining.front())
-        {
-            tokenRemaining.pop_front();
-            if (is_empty(tokenRemaining))
-            {
-                *itOut = idx - (size_of_cont(token) - 1);
-                tokenRemaining = tokenAsList;
-            }
-        }
-        else
-        {
-            tokenRemaining = tokenAsList;
-        }
-        ++idx;
+        // Also finds matches starting inside a failed partial match,
+        // e.g. "\r\n" in "\r\r\n".
+        const auto found = std::search(it, std::end(xs),
+            std::begin(token), std::end(token));
+        if (found == std::end(xs))
+            break;
+        idx += static_cast<std::size_t>(std::distance(it, found));
+        *itOut = idx;
+        idx += tokenSize;
+        it = std::next(found, static_cast<std::ptrdiff_t>(tokenSize));
     }
     return result;
 }
 
-} // namespace fplus
\ No newline at end of file
+// lower_bound_idx(4, [1, 3, 4, 4, 9]) == 2
+// lower_bound_idx(5, [1, 3, 4, 4, 9]) == 4
+// Index of the first element not less than x
+// in a container sorted by operator<, size_of_cont(xs) if there is none.
+// Binary search, i.e. O(log(n)) comparisons.
+template <typename Container>
+std::size_t lower_bound_idx
+        (const typename Container::value_type& x, const Container& xs)
+{
+    return static_cast<std::size_t>(std::distance(std::begin(xs),
+        std::lower_bound(std::begin(xs), std::end(xs), x)));
+}
+
+// upper_bound_idx(4, [1, 3, 4, 4, 9]) == 4
+// Index of the first element greater than x
+// in a container sorted by operator<, size_of_cont(xs) if there is none.
+template <typename Container>
+std::size_t upper_bound_idx
+        (const typename Container::value_type& x, const Container& xs)
+{
+    return static_cast<std::size_t>(std::distance(std::begin(xs),
+        std::upper_bound(std::begin(xs), std::end(xs), x)));
+}
+
+// find_first_idx_sorted(4, [1, 3, 4, 4, 9]) == Just(2)
+// find_first_idx_sorted(5, [1, 3, 4, 4, 9]) == Nothing
+// Same result as find_first_idx, but xs must be sorted by operator<
+// and the search is binary instead of linear.
+template <typename Container>
+maybe<std::size_t> find_first_idx_sorted
+        (const typename Container::value_type& x, const Container& xs)
+{
+    auto it = std::lower_bound(std::begin(xs), std::end(xs), x);
+    if (it == std::end(xs) || x < *it)
+        return nothing<std::size_t>();
+    return just<std::size_t>(std::distance(std::begin(xs), it));
+}
+
+// contains_sorted(4, [1, 3, 4, 4, 9]) == true
+// Same result as contains, but xs must be sorted by operator<
+// and the search is binary instead of linear.
+template <typename Container>
+bool contains_sorted
+        (const typename Container::value_type& x, const Container& xs)
+{
+    return std::binary_search(std::begin(xs), std::end(xs), x);
+}
+
+} // namespace fplus
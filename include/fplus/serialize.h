@@ -0,0 +1,331 @@
+// Copyright Tobias Hermann 2015.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include "maybe.h"
+#include "profiling_macros.h"
+
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace fplus
+{
+
+// Compact binary snapshot format:
+// 4 bytes magic "FPSR", 1 byte format version, 1 reserved byte,
+// 2 bytes byte-order mark, followed by the payload.
+// Sizes are stored as 64 bit unsigned integers,
+// all values in native byte order.
+// Snapshots are meant to be read back on the same platform,
+// e.g. to cache results between process restarts.
+const std::uint8_t serialization_format_version = 1;
+
+typedef std::vector<std::uint8_t> serialized_bytes;
+
+// Cursor over the bytes of a snapshot.
+// Reading past the end marks it as failed instead of crashing,
+// so truncated input can be detected.
+class serialization_reader
+{
+public:
+    serialization_reader(const std::uint8_t* data, std::size_t size) :
+        pos_(data), end_(data + size), ok_(true) {}
+    bool ok() const { return ok_; }
+    bool at_end() const { return pos_ == end_; }
+    std::size_t remaining() const
+    {
+        return static_cast<std::size_t>(end_ - pos_);
+    }
+    void fail() { ok_ = false; pos_ = end_; }
+    void read(void* dest, std::size_t size)
+    {
+        if (!ok_ || size > remaining())
+        {
+            fail();
+            std::memset(dest, 0, size);
+            return;
+        }
+        std::memcpy(dest, pos_, size);
+        pos_ += size;
+    }
+    // Element counts are checked against the remaining input,
+    // since every serialized element takes up at least one byte.
+    // This avoids huge allocations for corrupt data.
+    std::size_t read_count()
+    {
+        std::uint64_t count = 0;
+        read(&count, sizeof(count));
+        if (count > remaining())
+        {
+            fail();
+            return 0;
+        }
+        return static_cast<std::size_t>(count);
+    }
+private:
+    const std::uint8_t* pos_;
+    const std::uint8_t* end_;
+    bool ok_;
+};
+
+inline void serialize_append_bytes(serialized_bytes& out,
+    const void* data, std::size_t size)
+{
+    if (size == 0)
+        return;
+    const std::size_t oldSize = out.size();
+    out.resize(oldSize + size);
+    std::memcpy(out.data() + oldSize, data, size);
+}
+
+inline void serialize_append_count(serialized_bytes& out, std::size_t count)
+{
+    const std::uint64_t count64 = count;
+    serialize_append_bytes(out, &count64, sizeof(count64));
+}
+
+// serializer<T> knows how to write a T into a byte buffer
+// and how to read it back. Trivially copyable types
+// are stored as their object representation.
+template <typename T, typename Enable = void>
+struct serializer
+{
+    static_assert(std::is_trivially_copyable<T>::value,
+        "Type is not serializable.");
+    static void write(serialized_bytes& out, const T& x)
+    {
+        serialize_append_bytes(out, &x, sizeof(T));
+    }
+    static T read(serialization_reader& reader)
+    {
+        T x;
+        reader.read(&x, sizeof(T));
+        return x;
+    }
+};
+
+template <typename T>
+void serialize_append(serialized_bytes& out, const T& x)
+{
+    serializer<T>::write(out, x);
+}
+
+template <typename T>
+T deserialize_read(serialization_reader& reader)
+{
+    return serializer<T>::read(reader);
+}
+
+template <typename CharT, typename Traits, typename Alloc>
+struct serializer<std::basic_string<CharT, Traits, Alloc>>
+{
+    typedef std::basic_string<CharT, Traits, Alloc> String;
+    static void write(serialized_bytes& out, const String& xs)
+    {
+        serialize_append_count(out, xs.size());
+        serialize_append_bytes(out, xs.data(), xs.size() * sizeof(CharT));
+    }
+    static String read(serialization_reader& reader)
+    {
+        const std::size_t count = reader.read_count();
+        String xs(count, CharT());
+        if (count > 0)
+            reader.read(&xs[0], count * sizeof(CharT));
+        return xs;
+    }
+};
+
+// Vectors of trivially copyable elements are copied in one go.
+template <typename T, typename Alloc>
+struct serializer<std::vector<T, Alloc>,
+    typename std::enable_if<std::is_trivially_copyable<T>::value &&
+        !std::is_same<T, bool>::value>::type>
+{
+    typedef std::vector<T, Alloc> Vector;
+    static void write(serialized_bytes& out, const Vector& xs)
+    {
+        serialize_append_count(out, xs.size());
+        serialize_append_bytes(out, xs.data(), xs.size() * sizeof(T));
+    }
+    static Vector read(serialization_reader& reader)
+    {
+        const std::size_t count = reader.read_count();
+        Vector xs(count);
+        if (count > 0)
+            reader.read(xs.data(), count * sizeof(T));
+        return xs;
+    }
+};
+
+template <typename T, typename Alloc>
+struct serializer<std::vector<T, Alloc>,
+    typename std::enable_if<!std::is_trivially_copyable<T>::value ||
+        std::is_same<T, bool>::value>::type>
+{
+    typedef std::vector<T, Alloc> Vector;
+    static void write(serialized_bytes& out, const Vector& xs)
+    {
+        serialize_append_count(out, xs.size());
+        for (const T& x : xs)
+            serialize_append<T>(out, x);
+    }
+    static Vector read(serialization_reader& reader)
+    {
+        const std::size_t count = reader.read_count();
+        Vector xs;
+        xs.reserve(count);
+        for (std::size_t i = 0; i < count && reader.ok(); ++i)
+            xs.push_back(deserialize_read<T>(reader));
+        return xs;
+    }
+};
+
+template <typename X, typename Y>
+struct serializer<std::pair<X, Y>>
+{
+    static void write(serialized_bytes& out, const std::pair<X, Y>& p)
+    {
+        serialize_append(out, p.first);
+        serialize_append(out, p.second);
+    }
+    static std::pair<X, Y> read(serialization_reader& reader)
+    {
+        // Two statements to guarantee the order of evaluation.
+        X x = deserialize_read<X>(reader);
+        Y y = deserialize_read<Y>(reader);
+        return std::make_pair(std::move(x), std::move(y));
+    }
+};
+
+template <typename T>
+struct serializer<maybe<T>>
+{
+    static void write(serialized_bytes& out, const maybe<T>& m)
+    {
+        const std::uint8_t isJust = is_just(m) ? 1 : 0;
+        serialize_append(out, isJust);
+        if (is_just(m))
+            serialize_append(out, m.unsafe_get_just());
+    }
+    static maybe<T> read(serialization_reader& reader)
+    {
+        const std::uint8_t isJust = deserialize_read<std::uint8_t>(reader);
+        if (isJust == 1)
+            return maybe<T>(deserialize_read<T>(reader));
+        if (isJust != 0)
+            reader.fail();
+        return nothing<T>();
+    }
+};
+
+template <typename MapType>
+struct map_serializer
+{
+    typedef typename MapType::key_type Key;
+    typedef typename MapType::mapped_type Val;
+    static void write(serialized_bytes& out, const MapType& dict)
+    {
+        serialize_append_count(out, dict.size());
+        for (const auto& keyAndVal : dict)
+        {
+            serialize_append(out, keyAndVal.first);
+            serialize_append(out, keyAndVal.second);
+        }
+    }
+    static MapType read(serialization_reader& reader)
+    {
+        const std::size_t count = reader.read_count();
+        MapType dict;
+        for (std::size_t i = 0; i < count && reader.ok(); ++i)
+        {
+            Key key = deserialize_read<Key>(reader);
+            Val val = deserialize_read<Val>(reader);
+            // Maps are written in iteration order,
+            // so the end is the right hint for ordered maps.
+            dict.insert(std::end(dict),
+                std::make_pair(std::move(key), std::move(val)));
+        }
+        return dict;
+    }
+};
+
+template <typename Key, typename Val, typename Compare, typename Alloc>
+struct serializer<std::map<Key, Val, Compare, Alloc>> :
+    public map_serializer<std::map<Key, Val, Compare, Alloc>> {};
+
+template <typename Key, typename Val, typename Hash, typename Pred,
+    typename Alloc>
+struct serializer<std::unordered_map<Key, Val, Hash, Pred, Alloc>> :
+    public map_serializer<std::unordered_map<Key, Val, Hash, Pred, Alloc>> {};
+
+inline void serialize_append_header(serialized_bytes& out)
+{
+    const std::uint8_t header[] = {'F', 'P', 'S', 'R',
+        serialization_format_version, 0};
+    const std::uint16_t byteOrderMark = 0x0102;
+    serialize_append_bytes(out, header, sizeof(header));
+    serialize_append_bytes(out, &byteOrderMark, sizeof(byteOrderMark));
+}
+
+inline bool deserialize_header(serialization_reader& reader)
+{
+    std::uint8_t header[6];
+    std::uint16_t byteOrderMark = 0;
+    reader.read(header, sizeof(header));
+    reader.read(&byteOrderMark, sizeof(byteOrderMark));
+    return reader.ok() &&
+        header[0] == 'F' && header[1] == 'P' &&
+        header[2] == 'S' && header[3] == 'R' &&
+        header[4] == serialization_format_version &&
+        byteOrderMark == 0x0102;
+}
+
+// Creates a binary snapshot of a value.
+// Supported are arithmetic and other trivially copyable types,
+// std::string, std::vector, std::pair, std::map, std::unordered_map
+// and maybe, arbitrarily nested.
+// deserialize<T>(serialize(x)) == just(x)
+template <typename T>
+serialized_bytes serialize(const T& x)
+{
+    FPLUS_PROFILE_SCOPE(1);
+    serialized_bytes result;
+    serialize_append_header(result);
+    serialize_append(result, x);
+    FPLUS_PROFILE_OUTPUT(result.size());
+    return result;
+}
+
+// Reads a value back from a binary snapshot.
+// Returns nothing if the header does not match
+// or the data is truncated or has trailing bytes.
+template <typename T>
+maybe<T> deserialize(const std::uint8_t* data, std::size_t size)
+{
+    FPLUS_PROFILE_SCOPE(size);
+    serialization_reader reader(data, size);
+    if (!deserialize_header(reader))
+        return nothing<T>();
+    T result = deserialize_read<T>(reader);
+    if (!reader.ok() || !reader.at_end())
+        return nothing<T>();
+    FPLUS_PROFILE_OUTPUT(1);
+    return maybe<T>(std::move(result));
+}
+
+template <typename T>
+maybe<T> deserialize(const serialized_bytes& bytes)
+{
+    return deserialize<T>(bytes.data(), bytes.size());
+}
+
+} // namespace fplus
@@ -0,0 +1,322 @@
+// Copyright Tobias Hermann 2015.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include "container_common.h"
+
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+namespace fplus
+{
+
+// All set functions work on containers sorted by operator<,
+// e.g. std::set or the results of sort,
+// and have the semantics of the std::set_* algorithms,
+// i.e. duplicates are treated like in multisets.
+// If one input is much smaller than the other
+// and both can be accessed randomly, the bigger one is not scanned
+// element by element, but searched with gallop_lower_bound.
+
+// Position of the first element in [first, last) that is not less than x.
+// Probes first[1], first[2], first[4], ... before doing a binary search,
+// so it needs O(log(d)) comparisons, d being the distance of the result.
+// Cheap when walking through a sorted range in small but irregular steps.
+template <typename RandomIt, typename T>
+RandomIt gallop_lower_bound(RandomIt first, RandomIt last, const T& x)
+{
+    if (first == last || !(*first < x))
+        return first;
+    typedef typename std::iterator_traits<RandomIt>::difference_type Diff;
+    Diff step = 1;
+    while (step < last - first && *(first + step) < x)
+    {
+        first += step;
+        step *= 2;
+    }
+    return std::lower_bound(first + 1, first + std::min(step, last - first), x);
+}
+
+template <typename Container>
+struct is_random_access_container : public std::is_base_of<
+    std::random_access_iterator_tag,
+    typename std::iterator_traits<
+        typename Container::const_iterator>::iterator_category> {};
+
+// Galloping pays off when one side is at least this many times bigger.
+inline std::size_t set_gallop_size_ratio()
+{
+    return 16;
+}
+
+// Walks through the bigger of two sorted ranges in gallops.
+// For every element of the smaller range the bigger one
+// is advanced to the first element not less than it.
+// The skipped elements of the bigger range are passed to on_big_run
+// as one iterator range, the element of the smaller range
+// and a pointer to its equal partner (or nullptr) to on_small.
+template <typename SmallIt, typename BigIt, typename OnBigRun, typename OnSmall>
+void gallop_merge_visit(SmallIt smallBegin, SmallIt smallEnd,
+    BigIt bigBegin, BigIt bigEnd, OnBigRun on_big_run, OnSmall on_small)
+{
+    BigIt itBig = bigBegin;
+    for (SmallIt itSmall = smallBegin; itSmall != smallEnd; ++itSmall)
+    {
+        const BigIt pos = gallop_lower_bound(itBig, bigEnd, *itSmall);
+        on_big_run(itBig, pos);
+        itBig = pos;
+        if (itBig != bigEnd && !(*itSmall < *itBig))
+        {
+            on_small(itSmall, &*itBig);
+            ++itBig;
+        }
+        else
+        {
+            on_small(itSmall, nullptr);
+        }
+    }
+    on_big_run(itBig, bigEnd);
+}
+
+// Every set operation provides a linear merge,
+// used for balanced sizes and non-random-access containers,
+// and a galloping version for lopsided random-access inputs.
+struct set_intersection_op
+{
+    template <typename ContainerX, typename ContainerY, typename OutIt>
+    static void linear(const ContainerX& xs, const ContainerY& ys, OutIt& itOut)
+    {
+        itOut = std::set_intersection(std::begin(xs), std::end(xs),
+            std::begin(ys), std::end(ys), itOut);
+    }
+    template <typename ContainerX, typename ContainerY, typename OutIt>
+    static void gallop(const ContainerX& xs, const ContainerY& ys, OutIt& itOut)
+    {
+        typedef typename ContainerX::value_type T;
+        typedef typename ContainerX::const_iterator ItX;
+        typedef typename ContainerY::const_iterator ItY;
+        if (size_of_cont(xs) < size_of_cont(ys))
+            gallop_merge_visit(std::begin(xs), std::end(xs),
+                std::begin(ys), std::end(ys), [](ItY, ItY) {},
+                [&](ItX itX, const T* y) { if (y) *itOut = *itX; });
+        else
+            gallop_merge_visit(std::begin(ys), std::end(ys),
+                std::begin(xs), std::end(xs), [](ItX, ItX) {},
+                [&](ItY, const T* x) { if (x) *itOut = *x; });
+    }
+};
+
+struct set_union_op
+{
+    template <typename ContainerX, typename ContainerY, typename OutIt>
+    static void linear(const ContainerX& xs, const ContainerY& ys, OutIt& itOut)
+    {
+        itOut = std::set_union(std::begin(xs), std::end(xs),
+            std::begin(ys), std::end(ys), itOut);
+    }
+    template <typename ContainerX, typename ContainerY, typename OutIt>
+    static void gallop(const ContainerX& xs, const ContainerY& ys, OutIt& itOut)
+    {
+        typedef typename ContainerX::value_type T;
+        typedef typename ContainerX::const_iterator ItX;
+        typedef typename ContainerY::const_iterator ItY;
+        if (size_of_cont(xs) < size_of_cont(ys))
+            gallop_merge_visit(std::begin(xs), std::end(xs),
+                std::begin(ys), std::end(ys),
+                [&](ItY first, ItY last) { itOut = std::copy(first, last, itOut); },
+                [&](ItX itX, const T*) { *itOut = *itX; });
+        else
+            gallop_merge_visit(std::begin(ys), std::end(ys),
+                std::begin(xs), std::end(xs),
+                [&](ItX first, ItX last) { itOut = std::copy(first, last, itOut); },
+                [&](ItY itY, const T* x) { if (x) *itOut = *x; else *itOut = *itY; });
+    }
+};
+
+struct set_difference_op
+{
+    template <typename ContainerX, typename ContainerY, typename OutIt>
+    static void linear(const ContainerX& xs, const ContainerY& ys, OutIt& itOut)
+    {
+        itOut = std::set_difference(std::begin(xs), std::end(xs),
+            std::begin(ys), std::end(ys), itOut);
+    }
+    template <typename ContainerX, typename ContainerY, typename OutIt>
+    static void gallop(const ContainerX& xs, const ContainerY& ys, OutIt& itOut)
+    {
+        typedef typename ContainerX::value_type T;
+        typedef typename ContainerX::const_iterator ItX;
+        typedef typename ContainerY::const_iterator ItY;
+        if (size_of_cont(xs) < size_of_cont(ys))
+            gallop_merge_visit(std::begin(xs), std::end(xs),
+                std::begin(ys), std::end(ys), [](ItY, ItY) {},
+                [&](ItX itX, const T* y) { if (!y) *itOut = *itX; });
+        else
+            gallop_merge_visit(std::begin(ys), std::end(ys),
+                std::begin(xs), std::end(xs),
+                [&](ItX first, ItX last) { itOut = std::copy(first, last, itOut); },
+                [](ItY, const T*) {});
+    }
+};
+
+struct set_symmetric_difference_op
+{
+    template <typename ContainerX, typename ContainerY, typename OutIt>
+    static void linear(const ContainerX& xs, const ContainerY& ys, OutIt& itOut)
+    {
+        itOut = std::set_symmetric_difference(std::begin(xs), std::end(xs),
+            std::begin(ys), std::end(ys), itOut);
+    }
+    template <typename ContainerX, typename ContainerY, typename OutIt>
+    static void gallop(const ContainerX& xs, const ContainerY& ys, OutIt& itOut)
+    {
+        typedef typename ContainerX::value_type T;
+        typedef typename ContainerX::const_iterator ItX;
+        typedef typename ContainerY::const_iterator ItY;
+        if (size_of_cont(xs) < size_of_cont(ys))
+            gallop_merge_visit(std::begin(xs), std::end(xs),
+                std::begin(ys), std::end(ys),
+                [&](ItY first, ItY last) { itOut = std::copy(first, last, itOut); },
+                [&](ItX itX, const T* y) { if (!y) *itOut = *itX; });
+        else
+            gallop_merge_visit(std::begin(ys), std::end(ys),
+                std::begin(xs), std::end(xs),
+                [&](ItX first, ItX last) { itOut = std::copy(first, last, itOut); },
+                [&](ItY itY, const T* x) { if (!x) *itOut = *itY; });
+    }
+};
+
+template <typename Op, typename ContainerX, typename ContainerY, typename OutIt>
+void set_operation_dispatch(const ContainerX& xs, const ContainerY& ys,
+    OutIt& itOut, std::false_type)
+{
+    Op::linear(xs, ys, itOut);
+}
+
+template <typename Op, typename ContainerX, typename ContainerY, typename OutIt>
+void set_operation_dispatch(const ContainerX& xs, const ContainerY& ys,
+    OutIt& itOut, std::true_type)
+{
+    const std::size_t xsSize = size_of_cont(xs);
+    const std::size_t ysSize = size_of_cont(ys);
+    if (xsSize > set_gallop_size_ratio() * ysSize ||
+        ysSize > set_gallop_size_ratio() * xsSize)
+        Op::gallop(xs, ys, itOut);
+    else
+        Op::linear(xs, ys, itOut);
+}
+
+template <typename Op, typename ContainerX, typename ContainerY>
+ContainerX set_operation(const ContainerX& xs, const ContainerY& ys,
+    std::size_t sizeHint)
+{
+    static_assert(std::is_same<typename ContainerX::value_type,
+        typename ContainerY::value_type>::value, "Element types do not match.");
+    ContainerX result;
+    prepare_container(result, sizeHint);
+    auto itOut = get_back_inserter(result);
+    set_operation_dispatch<Op>(xs, ys, itOut, std::integral_constant<bool,
+        is_random_access_container<ContainerX>::value &&
+        is_random_access_container<ContainerY>::value>());
+    return result;
+}
+
+// set_intersection([1,2,3,5], [2,3,4]) == [2,3]
+template <typename ContainerX, typename ContainerY>
+ContainerX set_intersection(const ContainerX& xs, const ContainerY& ys)
+{
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs) + size_of_cont(ys));
+    ContainerX result = set_operation<set_intersection_op>(xs, ys,
+        std::min(size_of_cont(xs), size_of_cont(ys)));
+    FPLUS_PROFILE_OUTPUT(size_of_cont(result));
+    return result;
+}
+
+// set_union([1,2,5], [2,3,4]) == [1,2,3,4,5]
+template <typename ContainerX, typename ContainerY>
+ContainerX set_union(const ContainerX& xs, const ContainerY& ys)
+{
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs) + size_of_cont(ys));
+    ContainerX result = set_operation<set_union_op>(xs, ys,
+        size_of_cont(xs) + size_of_cont(ys));
+    FPLUS_PROFILE_OUTPUT(size_of_cont(result));
+    return result;
+}
+
+// set_difference([1,2,3,5], [2,3,4]) == [1,5]
+template <typename ContainerX, typename ContainerY>
+ContainerX set_difference(const ContainerX& xs, const ContainerY& ys)
+{
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs) + size_of_cont(ys));
+    ContainerX result = set_operation<set_difference_op>(xs, ys,
+        size_of_cont(xs));
+    FPLUS_PROFILE_OUTPUT(size_of_cont(result));
+    return result;
+}
+
+// set_symmetric_difference([1,2,3,5], [2,3,4]) == [1,4,5]
+template <typename ContainerX, typename ContainerY>
+ContainerX set_symmetric_difference(const ContainerX& xs, const ContainerY& ys)
+{
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs) + size_of_cont(ys));
+    ContainerX result = set_operation<set_symmetric_difference_op>(xs, ys,
+        size_of_cont(xs) + size_of_cont(ys));
+    FPLUS_PROFILE_OUTPUT(size_of_cont(result));
+    return result;
+}
+
+// sets_intersection([[1,2,3], [2,3,4], [0,3]]) == [3]
+// Intersects the smallest sets first,
+// so the intermediate results shrink as fast as possible
+// and galloping kicks in for the big ones.
+template <typename ContainerIn,
+    typename ContainerOut = typename ContainerIn::value_type>
+ContainerOut sets_intersection(const ContainerIn& xss)
+{
+    FPLUS_PROFILE_SCOPE(size_of_cont(xss));
+    std::vector<const ContainerOut*> bySize;
+    for (const auto& xs : xss)
+        bySize.push_back(&xs);
+    if (bySize.empty())
+        return ContainerOut();
+    std::stable_sort(std::begin(bySize), std::end(bySize),
+        [](const ContainerOut* a, const ContainerOut* b)
+        { return size_of_cont(*a) < size_of_cont(*b); });
+    ContainerOut result = *bySize.front();
+    for (std::size_t i = 1; i < bySize.size() && !is_empty(result); ++i)
+        result = set_intersection(result, *bySize[i]);
+    FPLUS_PROFILE_OUTPUT(size_of_cont(result));
+    return result;
+}
+
+// sets_union([[1,2], [2,3], [5]]) == [1,2,3,5]
+// Unites the sets pairwise in a balanced tree,
+// so every element is copied only log(k) times for k sets.
+template <typename ContainerIn,
+    typename ContainerOut = typename ContainerIn::value_type>
+ContainerOut sets_union(const ContainerIn& xss)
+{
+    FPLUS_PROFILE_SCOPE(size_of_cont(xss));
+    std::vector<ContainerOut> level(std::begin(xss), std::end(xss));
+    if (level.empty())
+        return ContainerOut();
+    while (level.size() > 1)
+    {
+        std::vector<ContainerOut> nextLevel;
+        nextLevel.reserve(level.size() / 2 + 1);
+        for (std::size_t i = 0; i + 1 < level.size(); i += 2)
+            nextLevel.push_back(set_union(level[i], level[i + 1]));
+        if (level.size() % 2 == 1)
+            nextLevel.push_back(std::move(level.back()));
+        level = std::move(nextLevel);
+    }
+    FPLUS_PROFILE_OUTPUT(size_of_cont(level.front()));
+    return std::move(level.front());
+}
+
+} // namespace fplus
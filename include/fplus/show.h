@@ -8,19 +8,202 @@
 #include "container_common.h"
 #include "transform.h"
 
+#include <cstdio>
+#include <ostream>
 #include <sstream>
 #include <string>
+#include <type_traits>
 
 namespace fplus
 {
 
-// 42 -> "42"
+// The append_show overloads write the textual representation
+// of a value to the end of an existing string.
+// Numbers and strings are formatted directly into the buffer,
+// producing the same output as operator<< of std::ostream would.
+// Only other types fall back to an std::ostringstream.
+
+inline void append_show(std::string& out, const std::string& x)
+{
+    out.append(x);
+}
+
+inline void append_show(std::string& out, const char* x)
+{
+    out.append(x);
+}
+
+inline void append_show(std::string& out, char x)
+{
+    out.push_back(x);
+}
+
+inline void append_show(std::string& out, signed char x)
+{
+    out.push_back(static_cast<char>(x));
+}
+
+inline void append_show(std::string& out, unsigned char x)
+{
+    out.push_back(static_cast<char>(x));
+}
+
+inline void append_show(std::string& out, bool x)
+{
+    out.push_back(x ? '1' : '0');
+}
+
+// Writes the decimal digits of x backwards, ending at bufEnd.
+// Two digits are produced per division.
+template <typename U>
+char* write_unsigned_digits_backwards(char* bufEnd, U x)
+{
+    static const char digitPairs[] =
+        "00010203040506070809101112131415161718192021222324"
+        "25262728293031323334353637383940414243444546474849"
+        "50515253545556575859606162636465666768697071727374"
+        "75767778798081828384858687888990919293949596979899";
+    char* p = bufEnd;
+    while (x >= 100)
+    {
+        const std::size_t idx = static_cast<std::size_t>(x % 100) * 2;
+        x /= 100;
+        *--p = digitPairs[idx + 1];
+        *--p = digitPairs[idx];
+    }
+    if (x >= 10)
+    {
+        const std::size_t idx = static_cast<std::size_t>(x) * 2;
+        *--p = digitPairs[idx + 1];
+        *--p = digitPairs[idx];
+    }
+    else
+    {
+        *--p = static_cast<char>('0' + x);
+    }
+    return p;
+}
+
 template <typename T>
-std::string show(const T& x)
+typename std::enable_if<std::is_integral<T>::value &&
+    std::is_unsigned<T>::value>::type
+append_show_integral(std::string& out, T x)
+{
+    char buf[3 * sizeof(T) + 1];
+    char* bufEnd = buf + sizeof(buf);
+    out.append(write_unsigned_digits_backwards(bufEnd, x), bufEnd);
+}
+
+template <typename T>
+typename std::enable_if<std::is_integral<T>::value &&
+    std::is_signed<T>::value>::type
+append_show_integral(std::string& out, T x)
+{
+    typedef typename std::make_unsigned<T>::type U;
+    char buf[3 * sizeof(T) + 2];
+    char* bufEnd = buf + sizeof(buf);
+    const bool negative = x < 0;
+    const U absX = negative ? U(0) - static_cast<U>(x) : static_cast<U>(x);
+    char* p = write_unsigned_digits_backwards(bufEnd, absX);
+    if (negative)
+        *--p = '-';
+    out.append(p, bufEnd);
+}
+
+inline void append_show_floating_point(std::string& out, double x)
+{
+    char buf[64];
+    int length = std::snprintf(buf, sizeof(buf), "%g", x);
+    out.append(buf, static_cast<std::size_t>(length));
+}
+
+inline void append_show_floating_point(std::string& out, long double x)
+{
+    char buf[64];
+    int length = std::snprintf(buf, sizeof(buf), "%Lg", x);
+    out.append(buf, static_cast<std::size_t>(length));
+}
+
+template <typename T>
+typename std::enable_if<std::is_integral<T>::value &&
+    !std::is_same<T, bool>::value &&
+    !std::is_same<T, char>::value &&
+    !std::is_same<T, signed char>::value &&
+    !std::is_same<T, unsigned char>::value>::type
+append_show(std::string& out, T x)
+{
+    append_show_integral(out, x);
+}
+
+template <typename T>
+typename std::enable_if<std::is_floating_point<T>::value>::type
+append_show(std::string& out, T x)
+{
+    typedef typename std::conditional<
+        std::is_same<T, long double>::value, long double, double>::type F;
+    append_show_floating_point(out, static_cast<F>(x));
+}
+
+template <typename T>
+typename std::enable_if<!std::is_arithmetic<T>::value>::type
+append_show(std::string& out, const T& x)
 {
     std::ostringstream ss;
     ss << x;
-    return ss.str();
+    out.append(ss.str());
+}
+
+// 42 -> "42"
+template <typename T>
+std::string show(const T& x)
+{
+    std::string result;
+    append_show(result, x);
+    return result;
+}
+
+// Appends the elements of xs to out, each one shown
+// and separated by separator. If xs has more than maxCount elements
+// only the first maxCount ones are shown, followed by "...".
+template <typename Container>
+void append_show_cont_with_frame_and_limit(std::string& out,
+    const std::string& separator,
+    const std::string& prefix, const std::string& sufix,
+    std::size_t maxCount,
+    const Container& xs)
+{
+    out.append(prefix);
+    std::size_t idx = 0;
+    for (const auto& x : xs)
+    {
+        if (idx != 0)
+            out.append(separator);
+        if (idx == maxCount)
+        {
+            out.append("...");
+            break;
+        }
+        append_show(out, x);
+        ++idx;
+    }
+    out.append(sufix);
+}
+
+// show_cont_with_frame_and_limit (", ", "[", "]", 2, [1, 2, 3]) == "[1, 2, ...]"
+template <typename Container>
+std::string show_cont_with_frame_and_limit(
+    const std::string& separator,
+    const std::string& prefix, const std::string& sufix,
+    std::size_t maxCount,
+    const Container& xs)
+{
+    std::string result;
+    const std::size_t shownCount = std::min(maxCount, size_of_cont(xs));
+    result.reserve(prefix.size() + sufix.size() +
+        shownCount * (separator.size() + 4));
+    append_show_cont_with_frame_and_limit(
+        result, separator, prefix, sufix, maxCount, xs);
+    return result;
 }
 
 // show_cont_with_frame (" => ", [1, 2, 3], "{", "}") == "{1 => 2 => 3}"
@@ -30,12 +213,8 @@ std::string show_cont_with_frame(
     const std::string& prefix, const std::string& sufix,
     const Container& xs)
 {
-    typedef typename Container::value_type T;
-    typedef std::vector<std::string> Strings;
-    typedef decltype(show<T>) ShowType;
-    auto showT = show<T>;
-    auto mapped = transform<ShowType, Container, Strings>(showT, xs);
-    return prefix + join(separator, mapped) + sufix;
+    return show_cont_with_frame_and_limit(separator, prefix, sufix,
+        size_of_cont(xs), xs);
 }
 
 // show_cont_with( " - ", [1, 2, 3]) == "[1 - 2 - 3]"
@@ -52,5 +231,49 @@ std::string show_cont(const Container& xs)
     return show_cont_with(", ", xs);
 }
 
+// Writes the same output as show_cont_with_frame_and_limit
+// directly to a stream. Only a small buffer is used,
+// which is flushed to the stream whenever it is full,
+// so arbitrarily large containers can be dumped.
+template <typename Container>
+void write_cont_with_frame_and_limit(std::ostream& os,
+    const std::string& separator,
+    const std::string& prefix, const std::string& sufix,
+    std::size_t maxCount,
+    const Container& xs)
+{
+    const std::size_t flushSize = 4096;
+    std::string buffer;
+    buffer.reserve(flushSize + 64);
+    buffer.append(prefix);
+    std::size_t idx = 0;
+    for (const auto& x : xs)
+    {
+        if (idx != 0)
+            buffer.append(separator);
+        if (idx == maxCount)
+        {
+            buffer.append("...");
+            break;
+        }
+        append_show(buffer, x);
+        ++idx;
+        if (buffer.size() >= flushSize)
+        {
+            os.write(buffer.data(),
+                static_cast<std::streamsize>(buffer.size()));
+            buffer.clear();
+        }
+    }
+    buffer.append(sufix);
+    os.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+}
+
+// write_cont (std::cout, [1, 2, 3]) prints "[1, 2, 3]"
+template <typename Container>
+void write_cont(std::ostream& os, const Container& xs)
+{
+    write_cont_with_frame_and_limit(os, ", ", "[", "]", size_of_cont(xs), xs);
+}
 
-} // namespace fplus
\ No newline at end of file
+} // namespace fplus
@@ -0,0 +1,15 @@
+// Copyright Tobias Hermann 2015.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+// SSE2 is part of every x86-64 CPU, so it needs no compiler flags.
+// FPLUS_SSE2 is defined if the SSE2 code paths are compiled in.
+// Defining FPLUS_NO_SIMD forces the scalar code paths.
+#if !defined(FPLUS_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define FPLUS_SSE2
+#include <emmintrin.h>
+#endif
@@ -0,0 +1,291 @@
+// Copyright Tobias Hermann 2015.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace fplus
+{
+
+// Sequence container storing up to N elements inline
+// and moving them to the heap only when growing beyond that.
+// Well suited as inner container of split and group results,
+// which mostly consist of many short sequences:
+// split_by<decltype(isZero), std::vector<int>,
+//     std::vector<small_vector<int, 8>>>(isZero, false, xs)
+// allocates only for the outer vector and for groups longer than 8.
+template <typename T, std::size_t N>
+class small_vector
+{
+public:
+    typedef T value_type;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+    typedef T* iterator;
+    typedef const T* const_iterator;
+    typedef std::reverse_iterator<iterator> reverse_iterator;
+    typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+    small_vector() : data_(inline_data()), size_(0), capacity_(N) {}
+    small_vector(size_type n, const T& x) : small_vector()
+    {
+        reserve(n);
+        for (size_type i = 0; i < n; ++i)
+            push_back(x);
+    }
+    template <typename InputIt,
+        typename = typename std::iterator_traits<InputIt>::iterator_category>
+    small_vector(InputIt first, InputIt last) : small_vector()
+    {
+        reserve_for(first, last,
+            typename std::iterator_traits<InputIt>::iterator_category());
+        for (; first != last; ++first)
+            push_back(*first);
+    }
+    small_vector(std::initializer_list<T> xs) :
+        small_vector(std::begin(xs), std::end(xs)) {}
+    small_vector(const small_vector& other) :
+        small_vector(other.begin(), other.end()) {}
+    small_vector(small_vector&& other)
+        noexcept(std::is_nothrow_move_constructible<T>::value) :
+        small_vector()
+    {
+        take(std::move(other));
+    }
+    ~small_vector()
+    {
+        clear();
+        release();
+    }
+
+    small_vector& operator = (const small_vector& other)
+    {
+        if (this != &other)
+        {
+            clear();
+            reserve(other.size());
+            for (const auto& x : other)
+                push_back(x);
+        }
+        return *this;
+    }
+    small_vector& operator = (small_vector&& other)
+        noexcept(std::is_nothrow_move_constructible<T>::value)
+    {
+        if (this != &other)
+        {
+            clear();
+            release();
+            data_ = inline_data();
+            capacity_ = N;
+            take(std::move(other));
+        }
+        return *this;
+    }
+
+    iterator begin() { return data_; }
+    iterator end() { return data_ + size_; }
+    const_iterator begin() const { return data_; }
+    const_iterator end() const { return data_ + size_; }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+    reverse_iterator rbegin() { return reverse_iterator(end()); }
+    reverse_iterator rend() { return reverse_iterator(begin()); }
+    const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+    const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+    bool empty() const { return size_ == 0; }
+    size_type size() const { return size_; }
+    size_type capacity() const { return capacity_; }
+    static constexpr size_type inline_capacity() { return N; }
+    bool is_inline() const { return data_ == inline_data(); }
+
+    void reserve(size_type n)
+    {
+        if (n > capacity_)
+            reallocate(n);
+    }
+
+    T* data() { return data_; }
+    const T* data() const { return data_; }
+
+    reference operator[](size_type i) { assert(i < size_); return data_[i]; }
+    const_reference operator[](size_type i) const { assert(i < size_); return data_[i]; }
+    reference front() { return (*this)[0]; }
+    const_reference front() const { return (*this)[0]; }
+    reference back() { return (*this)[size_ - 1]; }
+    const_reference back() const { return (*this)[size_ - 1]; }
+
+    void push_back(const T& x)
+    {
+        if (size_ == capacity_)
+        {
+            // x could be an element of this vector.
+            T copy(x);
+            reallocate(grown_capacity());
+            new (data_ + size_) T(std::move(copy));
+        }
+        else
+            new (data_ + size_) T(x);
+        ++size_;
+    }
+    void push_back(T&& x)
+    {
+        if (size_ == capacity_)
+        {
+            T moved(std::move(x));
+            reallocate(grown_capacity());
+            new (data_ + size_) T(std::move(moved));
+        }
+        else
+            new (data_ + size_) T(std::move(x));
+        ++size_;
+    }
+    template <typename... Args>
+    reference emplace_back(Args&&... args)
+    {
+        push_back(T(std::forward<Args>(args)...));
+        return back();
+    }
+    void pop_back()
+    {
+        assert(size_ > 0);
+        --size_;
+        data_[size_].~T();
+    }
+    void clear()
+    {
+        while (size_ > 0)
+            pop_back();
+    }
+
+    // Makes std::inserter work, which is used by get_back_inserter
+    // for all containers without a specialised overload.
+    iterator insert(const_iterator pos, const T& x)
+    {
+        std::size_t idx = static_cast<std::size_t>(pos - begin());
+        push_back(x);
+        std::rotate(begin() + idx, end() - 1, end());
+        return begin() + idx;
+    }
+    iterator erase(const_iterator first, const_iterator last)
+    {
+        iterator itFirst = begin() + (first - begin());
+        iterator itLast = begin() + (last - begin());
+        iterator newEnd = std::move(itLast, end(), itFirst);
+        while (end() != newEnd)
+            pop_back();
+        return itFirst;
+    }
+    iterator erase(const_iterator pos)
+    {
+        return erase(pos, pos + 1);
+    }
+
+private:
+    typedef typename std::aligned_storage<sizeof(T), alignof(T)>::type
+        storage_t;
+
+    T* inline_data() { return reinterpret_cast<T*>(&storage_[0]); }
+    const T* inline_data() const
+    {
+        return reinterpret_cast<const T*>(&storage_[0]);
+    }
+
+    size_type grown_capacity() const
+    {
+        return std::max<size_type>(2 * capacity_, 1);
+    }
+
+    template <typename InputIt>
+    void reserve_for(InputIt first, InputIt last, std::forward_iterator_tag)
+    {
+        reserve(static_cast<size_type>(std::distance(first, last)));
+    }
+    template <typename InputIt>
+    void reserve_for(InputIt, InputIt, std::input_iterator_tag)
+    {
+    }
+
+    void reallocate(size_type newCapacity)
+    {
+        assert(newCapacity >= size_);
+        T* newData = std::allocator<T>().allocate(newCapacity);
+        for (size_type i = 0; i < size_; ++i)
+        {
+            new (newData + i) T(std::move(data_[i]));
+            data_[i].~T();
+        }
+        release();
+        data_ = newData;
+        capacity_ = newCapacity;
+    }
+
+    void release()
+    {
+        if (!is_inline())
+            std::allocator<T>().deallocate(data_, capacity_);
+    }
+
+    // Expects this to be empty and inline.
+    void take(small_vector&& other)
+    {
+        if (other.is_inline())
+        {
+            for (auto& x : other)
+                push_back(std::move(x));
+            other.clear();
+        }
+        else
+        {
+            data_ = other.data_;
+            size_ = other.size_;
+            capacity_ = other.capacity_;
+            other.data_ = other.inline_data();
+            other.size_ = 0;
+            other.capacity_ = N;
+        }
+    }
+
+    T* data_;
+    size_type size_;
+    size_type capacity_;
+    storage_t storage_[N == 0 ? 1 : N];
+};
+
+template <typename T, std::size_t N>
+bool operator == (const small_vector<T, N>& xs, const small_vector<T, N>& ys)
+{
+    return xs.size() == ys.size() &&
+        std::equal(std::begin(xs), std::end(xs), std::begin(ys));
+}
+
+template <typename T, std::size_t N>
+bool operator != (const small_vector<T, N>& xs, const small_vector<T, N>& ys)
+{
+    return !(xs == ys);
+}
+
+template <typename T, std::size_t N>
+bool operator < (const small_vector<T, N>& xs, const small_vector<T, N>& ys)
+{
+    return std::lexicographical_compare(
+        std::begin(xs), std::end(xs), std::begin(ys), std::end(ys));
+}
+
+} // namespace fplus
@@ -0,0 +1,403 @@
+// Copyright Tobias Hermann 2015.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include "container_common.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace fplus
+{
+
+// Sequence of tuples stored as a structure of arrays:
+// every tuple element lives in its own std::vector (column).
+// Work touching only some of the fields streams through
+// just these columns, and per-column loops can be vectorized
+// by the compiler, which is not possible with a vector of pairs.
+// soa_vector<int, std::string> xs;
+// xs.push_back(1, "a");
+// xs.column<1>() == ["a"]
+template <typename... Ts>
+class soa_vector
+{
+public:
+    typedef std::tuple<Ts...> value_type;
+    typedef std::tuple<std::vector<Ts>...> columns_t;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+
+    template <std::size_t I>
+    using column_t = std::tuple_element_t<I, columns_t>;
+
+    // Iterates over the rows, yielding copies of them as tuples.
+    // Like the iterators of std::vector<bool>, it is random access,
+    // but its reference is a value and not a real reference.
+    class const_iterator
+    {
+    public:
+        typedef std::random_access_iterator_tag iterator_category;
+        typedef std::tuple<Ts...> value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const value_type* pointer;
+        typedef value_type reference;
+
+        const_iterator() : xs_(nullptr), idx_(0) {}
+        const_iterator(const soa_vector* xs, std::size_t idx) :
+            xs_(xs), idx_(idx) {}
+
+        value_type operator*() const { return xs_->row(idx_); }
+        value_type operator[](difference_type n) const
+        {
+            return xs_->row(idx_ + static_cast<std::size_t>(n));
+        }
+        const_iterator& operator++() { ++idx_; return *this; }
+        const_iterator operator++(int) { auto old = *this; ++idx_; return old; }
+        const_iterator& operator--() { --idx_; return *this; }
+        const_iterator operator--(int) { auto old = *this; --idx_; return old; }
+        const_iterator& operator+=(difference_type n)
+        {
+            idx_ = static_cast<std::size_t>(
+                static_cast<difference_type>(idx_) + n);
+            return *this;
+        }
+        const_iterator& operator-=(difference_type n) { return *this += -n; }
+        const_iterator operator+(difference_type n) const
+        {
+            auto result = *this;
+            return result += n;
+        }
+        const_iterator operator-(difference_type n) const
+        {
+            auto result = *this;
+            return result -= n;
+        }
+        difference_type operator-(const const_iterator& other) const
+        {
+            return static_cast<difference_type>(idx_) -
+                static_cast<difference_type>(other.idx_);
+        }
+        bool operator==(const const_iterator& other) const
+        {
+            return idx_ == other.idx_;
+        }
+        bool operator!=(const const_iterator& other) const
+        {
+            return idx_ != other.idx_;
+        }
+        bool operator<(const const_iterator& other) const
+        {
+            return idx_ < other.idx_;
+        }
+        bool operator>(const const_iterator& other) const
+        {
+            return idx_ > other.idx_;
+        }
+        bool operator<=(const const_iterator& other) const
+        {
+            return idx_ <= other.idx_;
+        }
+        bool operator>=(const const_iterator& other) const
+        {
+            return idx_ >= other.idx_;
+        }
+        friend const_iterator operator+(difference_type n,
+            const const_iterator& it)
+        {
+            return it + n;
+        }
+
+    private:
+        const soa_vector* xs_;
+        std::size_t idx_;
+    };
+    typedef const_iterator iterator;
+
+    soa_vector() : columns_() {}
+
+    // Takes over existing columns. All of them must have the same size.
+    explicit soa_vector(std::vector<Ts>... columns) :
+        columns_(std::move(columns)...)
+    {
+        assert(columns_have_equal_sizes(std::index_sequence_for<Ts...>()));
+    }
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, size()); }
+
+    size_type size() const { return std::get<0>(columns_).size(); }
+    bool empty() const { return size() == 0; }
+
+    void reserve(size_type n)
+    {
+        for_each_column([n](auto& column) { column.reserve(n); });
+    }
+
+    void clear()
+    {
+        for_each_column([](auto& column) { column.clear(); });
+    }
+
+    void push_back(const Ts&... xs)
+    {
+        push_back_impl(std::index_sequence_for<Ts...>(), xs...);
+    }
+
+    void push_back(const value_type& x)
+    {
+        push_back_tuple(x, std::index_sequence_for<Ts...>());
+    }
+
+    value_type row(size_type i) const
+    {
+        return row_impl(i, std::index_sequence_for<Ts...>());
+    }
+
+    template <std::size_t I>
+    const column_t<I>& column() const & { return std::get<I>(columns_); }
+
+    template <std::size_t I>
+    column_t<I>& column() & { return std::get<I>(columns_); }
+
+    template <std::size_t I>
+    column_t<I> column() && { return std::move(std::get<I>(columns_)); }
+
+    const columns_t& columns() const & { return columns_; }
+    columns_t columns() && { return std::move(columns_); }
+
+    // Calls f with the elements of row i as separate arguments.
+    template <typename F>
+    auto apply_to_row(F& f, size_type i) const
+    {
+        return apply_to_row_impl(f, i, std::index_sequence_for<Ts...>());
+    }
+
+    // Calls f(column) for every column.
+    template <typename F>
+    void for_each_column(F f)
+    {
+        for_each_column_impl(f, std::index_sequence_for<Ts...>());
+    }
+
+    // Calls f(column, otherColumn) for every column.
+    template <typename F>
+    void for_each_column_with(const soa_vector& other, F f)
+    {
+        for_each_column_with_impl(other, f, std::index_sequence_for<Ts...>());
+    }
+
+private:
+    template <std::size_t... Is>
+    bool columns_have_equal_sizes(std::index_sequence<Is...>) const
+    {
+        const std::size_t sizes[] = {std::get<Is>(columns_).size()...};
+        return std::all_of(std::begin(sizes), std::end(sizes),
+            [&sizes](std::size_t s) { return s == sizes[0]; });
+    }
+
+    template <std::size_t... Is>
+    void push_back_impl(std::index_sequence<Is...>, const Ts&... xs)
+    {
+        int dummy[] = {(std::get<Is>(columns_).push_back(xs), 0)...};
+        (void)dummy;
+    }
+
+    template <std::size_t... Is>
+    void push_back_tuple(const value_type& x, std::index_sequence<Is...>)
+    {
+        push_back(std::get<Is>(x)...);
+    }
+
+    template <std::size_t... Is>
+    value_type row_impl(size_type i, std::index_sequence<Is...>) const
+    {
+        return value_type(std::get<Is>(columns_)[i]...);
+    }
+
+    template <typename F, std::size_t... Is>
+    auto apply_to_row_impl(F& f, size_type i, std::index_sequence<Is...>) const
+    {
+        return f(std::get<Is>(columns_)[i]...);
+    }
+
+    template <typename F, std::size_t... Is>
+    void for_each_column_impl(F& f, std::index_sequence<Is...>)
+    {
+        int dummy[] = {(f(std::get<Is>(columns_)), 0)...};
+        (void)dummy;
+    }
+
+    template <typename F, std::size_t... Is>
+    void for_each_column_with_impl(const soa_vector& other, F& f,
+        std::index_sequence<Is...>)
+    {
+        int dummy[] = {(f(std::get<Is>(columns_),
+            std::get<Is>(other.columns_)), 0)...};
+        (void)dummy;
+    }
+
+    columns_t columns_;
+};
+
+template <typename... Ts>
+bool operator == (const soa_vector<Ts...>& xs, const soa_vector<Ts...>& ys)
+{
+    return xs.columns() == ys.columns();
+}
+
+template <typename... Ts>
+bool operator != (const soa_vector<Ts...>& xs, const soa_vector<Ts...>& ys)
+{
+    return !(xs == ys);
+}
+
+// zip_to_soa([1, 2, 3], ["a", "b"]) == soa_vector{[1, 2], ["a", "b"]}
+// Like zip, but every input is copied into its own column
+// instead of being interleaved into pairs.
+template <typename... Containers>
+soa_vector<typename Containers::value_type...> zip_to_soa(
+    const Containers&... xss)
+{
+    const std::size_t sizes[] = {size_of_cont(xss)...};
+    const std::size_t size = *std::min_element(std::begin(sizes), std::end(sizes));
+    return soa_vector<typename Containers::value_type...>(
+        std::vector<typename Containers::value_type>(std::begin(xss),
+            std::next(std::begin(xss), static_cast<std::ptrdiff_t>(size)))...);
+}
+
+// unzip(soa_vector{[1, 2], [5, 6]}) == ([1, 2], [5, 6])
+// From a temporary soa_vector the columns are moved out in O(1).
+template <typename X, typename Y>
+std::pair<std::vector<X>, std::vector<Y>> unzip(soa_vector<X, Y>&& xs)
+{
+    auto columns = std::move(xs).columns();
+    return std::make_pair(std::move(std::get<0>(columns)),
+        std::move(std::get<1>(columns)));
+}
+
+// unzip(soa_vector{[1, 2], [5, 6]}) == ([1, 2], [5, 6])
+template <typename X, typename Y>
+std::pair<std::vector<X>, std::vector<Y>> unzip(const soa_vector<X, Y>& xs)
+{
+    return std::make_pair(xs.template column<0>(), xs.template column<1>());
+}
+
+// transform((+), soa_vector{[1, 2], [5, 6]}) == [6, 8]
+// f gets the fields of each row as separate arguments.
+template <typename F, typename... Ts,
+    typename Y = std::decay_t<std::result_of_t<F&(const Ts&...)>>>
+std::vector<Y> transform(F f, const soa_vector<Ts...>& xs)
+{
+    std::vector<Y> ys;
+    ys.reserve(xs.size());
+    for (std::size_t i = 0; i < xs.size(); ++i)
+        ys.push_back(xs.apply_to_row(f, i));
+    return ys;
+}
+
+template <typename F, typename Column>
+Column transform_soa_column_if(F& f, const Column& column, std::true_type)
+{
+    Column result;
+    result.reserve(column.size());
+    for (const auto& x : column)
+        result.push_back(f(x));
+    return result;
+}
+
+template <typename F, typename Column>
+Column transform_soa_column_if(F&, const Column& column, std::false_type)
+{
+    return column;
+}
+
+template <std::size_t I, typename F, typename... Ts, std::size_t... Js>
+soa_vector<Ts...> transform_column_impl(F& f, const soa_vector<Ts...>& xs,
+    std::index_sequence<Js...>)
+{
+    return soa_vector<Ts...>(transform_soa_column_if(f,
+        xs.template column<Js>(), std::integral_constant<bool, I == Js>())...);
+}
+
+// transform_column<1>((*2), soa_vector{[1, 2], [5, 6]})
+//     == soa_vector{[1, 2], [10, 12]}
+// Only the selected column is read, the others are copied as a whole.
+template <std::size_t I, typename F, typename... Ts>
+soa_vector<Ts...> transform_column(F f, const soa_vector<Ts...>& xs)
+{
+    typedef typename soa_vector<Ts...>::template column_t<I> Column;
+    static_assert(std::is_convertible<
+        std::result_of_t<F&(const typename Column::value_type&)>,
+        typename Column::value_type>::value,
+        "Function must return the type of the column.");
+    return transform_column_impl<I>(f, xs, std::index_sequence_for<Ts...>());
+}
+
+// keep_if(\x y -> x < y, soa_vector{[1, 4, 2], [3, 3, 3]})
+//     == soa_vector{[1, 2], [3, 3]}
+// pred gets the fields of each row as separate arguments.
+// The predicate is evaluated once per row,
+// then every column is filtered on its own.
+template <typename Pred, typename... Ts>
+soa_vector<Ts...> keep_if(Pred pred, const soa_vector<Ts...>& xs)
+{
+    std::vector<unsigned char> keep(xs.size());
+    std::size_t keptCount = 0;
+    for (std::size_t i = 0; i < xs.size(); ++i)
+    {
+        keep[i] = xs.apply_to_row(pred, i) ? 1 : 0;
+        keptCount += keep[i];
+    }
+    soa_vector<Ts...> result;
+    result.for_each_column_with(xs,
+        [&keep, keptCount](auto& column, const auto& source)
+    {
+        column.reserve(keptCount);
+        for (std::size_t i = 0; i < source.size(); ++i)
+        {
+            if (keep[i])
+                column.push_back(source[i]);
+        }
+    });
+    return result;
+}
+
+// sort_on(\x y -> y, soa_vector{[1, 2, 3], ["c", "a", "b"]})
+//     == soa_vector{[2, 3, 1], ["a", "b", "c"]}
+// key_fn gets the fields of each row as separate arguments.
+// The keys are sorted together with the row indices,
+// and then every column is permuted accordingly.
+// Rows with equal keys keep their order.
+template <typename F, typename... Ts>
+soa_vector<Ts...> sort_on(F key_fn, const soa_vector<Ts...>& xs)
+{
+    typedef std::decay_t<std::result_of_t<F&(const Ts&...)>> Key;
+    std::vector<std::pair<Key, std::size_t>> keysAndIdxs;
+    keysAndIdxs.reserve(xs.size());
+    for (std::size_t i = 0; i < xs.size(); ++i)
+        keysAndIdxs.emplace_back(xs.apply_to_row(key_fn, i), i);
+    std::stable_sort(std::begin(keysAndIdxs), std::end(keysAndIdxs),
+        [](const std::pair<Key, std::size_t>& a,
+            const std::pair<Key, std::size_t>& b)
+        { return a.first < b.first; });
+    soa_vector<Ts...> result;
+    result.for_each_column_with(xs,
+        [&keysAndIdxs](auto& column, const auto& source)
+    {
+        column.reserve(source.size());
+        for (const auto& keyAndIdx : keysAndIdxs)
+            column.push_back(source[keyAndIdx.second]);
+    });
+    return result;
+}
+
+} // namespace fplus
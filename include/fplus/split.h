@@ -12,6 +12,18 @@
 namespace fplus
 {
 
+// The inner containers of the result only need the same elements
+// as the input, so e.g. a std::vector can be split into small_vectors.
+template <typename ContainerIn, typename ContainerOut>
+void check_split_result_for_container()
+{
+    static_assert(std::is_same<typename ContainerIn::value_type,
+        typename ContainerOut::value_type::value_type>::value,
+        "Containers do not match.");
+    check_resizable_container<ContainerOut>();
+    check_resizable_container<typename ContainerOut::value_type>();
+}
+
 // ContainerOut is not deduced to
 // SameContNewType(ContainerIn, ContainerIn)
 // here, since ContainerIn could be a std::string.
@@ -22,19 +34,21 @@ template <typename BinaryPredicate, typename ContainerIn,
 ContainerOut group_by(BinaryPredicate p, const ContainerIn& xs)
 {
     check_binary_predicate_for_container<BinaryPredicate, ContainerIn>();
-    static_assert(std::is_same<ContainerIn, typename ContainerOut::value_type>::value, "Containers do not match.");
+    check_split_result_for_container<ContainerIn, ContainerOut>();
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
     ContainerOut result;
     if (is_empty(xs))
         return result;
     typedef typename ContainerOut::value_type InnerContainerOut;
     *get_back_inserter(result) = InnerContainerOut(1, xs.front());
-    for (auto it = ++std::begin(xs); it != std::end(xs); ++it)
+    for (auto it = std::next(std::begin(xs)); it != std::end(xs); ++it)
     {
         if (p(*it, result.back().front()))
             *get_back_inserter(result.back()) = *it;
         else
             *get_back_inserter(result) = InnerContainerOut(1, *it);
     }
+    FPLUS_PROFILE_OUTPUT(size_of_cont(result));
     return result;
 }
 
@@ -43,10 +57,67 @@ template <typename ContainerIn,
         typename ContainerOut = typename std::list<ContainerIn>>
 ContainerOut group(ContainerIn& xs)
 {
-    static_assert(std::is_same<ContainerIn, typename ContainerOut::value_type>::value, "Containers do not match.");
+    check_split_result_for_container<ContainerIn, ContainerOut>();
     typedef typename ContainerIn::value_type T;
     auto pred = [](const T& x, const T& y) { return x == y; };
-    return group_by(pred, xs);
+    return group_by<decltype(pred), ContainerIn, ContainerOut>(pred, xs);
+}
+
+// group_on(abs, [1,-1,2,3,-3,1]) == [[1,-1],[2],[3,-3],[1]]
+// Groups consecutive elements with equal keys,
+// calculating the key only once per element.
+template <typename F, typename ContainerIn,
+        typename ContainerOut = typename std::list<ContainerIn>>
+ContainerOut group_on(F key_fn, const ContainerIn& xs)
+{
+    static_assert(utils::function_traits<F>::arity == 1, "Wrong arity.");
+    check_split_result_for_container<ContainerIn, ContainerOut>();
+    typedef std::remove_const_t<std::remove_reference_t<
+        typename utils::function_traits<F>::result_type>> Key;
+    typedef typename ContainerOut::value_type InnerContainerOut;
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
+    ContainerOut result;
+    if (is_empty(xs))
+        return result;
+    auto it = std::begin(xs);
+    Key groupKey = key_fn(*it);
+    *get_back_inserter(result) = InnerContainerOut(1, *it);
+    for (++it; it != std::end(xs); ++it)
+    {
+        Key key = key_fn(*it);
+        if (key == groupKey)
+            *get_back_inserter(result.back()) = *it;
+        else
+        {
+            *get_back_inserter(result) = InnerContainerOut(1, *it);
+            groupKey = std::move(key);
+        }
+    }
+    FPLUS_PROFILE_OUTPUT(size_of_cont(result));
+    return result;
+}
+
+// group_on_labeled(isEven, [1,3,2,4,5]) == [(false,[1,3]),(true,[2,4]),(false,[5])]
+// Like group_on, but every group is paired with its key.
+template <typename F, typename ContainerIn,
+        typename Key = std::remove_const_t<std::remove_reference_t<
+            typename utils::function_traits<F>::result_type>>,
+        typename ContainerOut = typename std::vector<std::pair<Key, ContainerIn>>>
+ContainerOut group_on_labeled(F key_fn, const ContainerIn& xs)
+{
+    static_assert(utils::function_traits<F>::arity == 1, "Wrong arity.");
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
+    ContainerOut result;
+    for (const auto& x : xs)
+    {
+        Key key = key_fn(x);
+        if (result.empty() || !(key == result.back().first))
+            *get_back_inserter(result) = std::make_pair(std::move(key), ContainerIn(1, x));
+        else
+            *get_back_inserter(result.back().second) = x;
+    }
+    FPLUS_PROFILE_OUTPUT(size_of_cont(result));
+    return result;
 }
 
 // split_by(isEven, true, [1,3,2,2,5,5,3,6,7,9]) == [[1,3],[],[5,5,3],[7,9]]
@@ -58,7 +129,8 @@ ContainerOut split_by
     typedef typename ContainerIn::value_type T;
     typedef typename ContainerOut::value_type ContainerOutInner;
     check_unary_predicate_for_container<UnaryPredicate, ContainerIn>();
-    static_assert(std::is_same<ContainerIn, typename ContainerOut::value_type>::value, "Containers do not match.");
+    check_split_result_for_container<ContainerIn, ContainerOut>();
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
     ContainerOut result;
     auto itOut = get_back_inserter(result);
     ContainerOutInner current;
@@ -83,6 +155,7 @@ ContainerOut split_by
     {
         *itOut = current;
     }
+    FPLUS_PROFILE_OUTPUT(size_of_cont(result));
     return result;
 }
 
@@ -101,6 +174,7 @@ std::pair<Container, Container> partition
         (UnaryPredicate pred, const Container& xs)
 {
     check_unary_predicate_for_container<UnaryPredicate, Container>();
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
     Container matching;
     Container notMatching;
     auto itOutMatching = get_back_inserter(matching);
@@ -112,6 +186,7 @@ std::pair<Container, Container> partition
         else
             *itOutNotMatching = x;
     }
+    FPLUS_PROFILE_OUTPUT(size_of_cont(xs));
     return make_pair(matching, notMatching);
 }
 
@@ -121,6 +196,7 @@ template <typename ContainerIdxs, typename ContainerIn,
 ContainerOut split_at_idxs(const ContainerIdxs& idxsIn, const ContainerIn& xs)
 {
     static_assert(std::is_same<ContainerIn, typename ContainerOut::value_type>::value, "Containers do not match.");
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
     ContainerIdxs idxStartC = {0};
     ContainerIdxs idxEndC = {size_of_cont(xs)};
     std::vector<ContainerIdxs> containerIdxss = {idxStartC, idxsIn, idxEndC};
@@ -135,29 +211,37 @@ ContainerOut split_at_idxs(const ContainerIdxs& idxsIn, const ContainerIn& xs)
     {
         *itOut = get_range(idxPair.first, idxPair.second, xs);
     }
+    FPLUS_PROFILE_OUTPUT(size_of_cont(result));
     return result;
 }
 
 // split_by_token(", ", "foo, bar, baz") == ["foo", "bar", "baz"]
+// If allowEmpty is false, empty parts are dropped,
+// e.g. split_by_token(",", false, "a,,b") == ["a", "b"].
 template <typename ContainerIn,
         typename ContainerOut = typename std::list<ContainerIn>>
 ContainerOut split_by_token(const ContainerIn& token,
         bool allowEmpty, const ContainerIn& xs)
 {
-    static_assert(std::is_same<ContainerIn, typename ContainerOut::value_type>::value, "Containers do not match.");
+    check_split_result_for_container<ContainerIn, ContainerOut>();
+    typedef typename ContainerOut::value_type InnerContainerOut;
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
     auto instances = find_all_instances_of_non_overlapping(token, xs);
     *get_back_inserter(instances) = size_of_cont(xs);
-    std::list<ContainerIn> result;
+    ContainerOut result;
     auto itOut = get_back_inserter(result);
     std::size_t lastEnd = 0;
     for (std::size_t idx : instances)
     {
         if (idx != lastEnd || allowEmpty)
         {
-            *itOut = get_range(lastEnd, idx, xs);
-            lastEnd = idx + size_of_cont(token);
+            *itOut = InnerContainerOut(
+                std::next(std::begin(xs), static_cast<std::ptrdiff_t>(lastEnd)),
+                std::next(std::begin(xs), static_cast<std::ptrdiff_t>(idx)));
         }
+        lastEnd = idx + size_of_cont(token);
     }
+    FPLUS_PROFILE_OUTPUT(size_of_cont(result));
     return result;
 }
 
@@ -166,11 +250,13 @@ template <typename ContainerIn,
         typename MapOut = typename std::map<typename ContainerIn::value_type, std::size_t>>
 MapOut count_occurrences(const ContainerIn& xs)
 {
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
     MapOut result;
     for (auto& x : xs)
     {
         ++result[x];
     }
+    FPLUS_PROFILE_OUTPUT(size_of_cont(result));
     return result;
 }
 
@@ -194,6 +280,7 @@ Container drop(std::size_t amount, const Container& xs)
 template <typename Container, typename UnaryPredicate>
 Container take_while(UnaryPredicate pred, const Container& xs)
 {
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
     auto maybeIdx = find_first_idx_by(logical_not(pred), xs);
     return take(with_default<std::size_t>(size_of_cont(xs), maybeIdx), xs);
 }
@@ -202,6 +289,7 @@ Container take_while(UnaryPredicate pred, const Container& xs)
 template <typename Container, typename UnaryPredicate>
 Container drop_while(UnaryPredicate pred, const Container& xs)
 {
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
     auto maybeIdx = find_first_idx_by(logical_not(pred), xs);
     return drop(with_default<std::size_t>(size_of_cont(xs), maybeIdx), xs);
 }
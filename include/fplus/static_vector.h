@@ -0,0 +1,188 @@
+// Copyright Tobias Hermann 2015.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace fplus
+{
+
+// Sequence container with a fixed capacity of N elements
+// stored inline, i.e. it never allocates memory on the heap.
+// Exceeding the capacity is a precondition violation.
+template <typename T, std::size_t N>
+class static_vector
+{
+public:
+    typedef T value_type;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+    typedef T* iterator;
+    typedef const T* const_iterator;
+    typedef std::reverse_iterator<iterator> reverse_iterator;
+    typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+    static_vector() : size_(0) {}
+    static_vector(size_type n, const T& x) : size_(0)
+    {
+        assert(n <= N);
+        for (size_type i = 0; i < n; ++i)
+            push_back(x);
+    }
+    template <typename InputIt,
+        typename = typename std::iterator_traits<InputIt>::iterator_category>
+    static_vector(InputIt first, InputIt last) : size_(0)
+    {
+        for (; first != last; ++first)
+            push_back(*first);
+    }
+    static_vector(std::initializer_list<T> xs) :
+        static_vector(std::begin(xs), std::end(xs)) {}
+    static_vector(const static_vector& other) :
+        static_vector(other.begin(), other.end()) {}
+    static_vector(static_vector&& other) : size_(0)
+    {
+        for (auto& x : other)
+            push_back(std::move(x));
+        other.clear();
+    }
+    ~static_vector() { clear(); }
+
+    static_vector& operator = (const static_vector& other)
+    {
+        if (this != &other)
+        {
+            clear();
+            for (const auto& x : other)
+                push_back(x);
+        }
+        return *this;
+    }
+    static_vector& operator = (static_vector&& other)
+    {
+        if (this != &other)
+        {
+            clear();
+            for (auto& x : other)
+                push_back(std::move(x));
+            other.clear();
+        }
+        return *this;
+    }
+
+    iterator begin() { return data(); }
+    iterator end() { return data() + size_; }
+    const_iterator begin() const { return data(); }
+    const_iterator end() const { return data() + size_; }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+    reverse_iterator rbegin() { return reverse_iterator(end()); }
+    reverse_iterator rend() { return reverse_iterator(begin()); }
+    const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+    const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+    bool empty() const { return size_ == 0; }
+    size_type size() const { return size_; }
+    static constexpr size_type capacity() { return N; }
+    static constexpr size_type max_size() { return N; }
+    void reserve(size_type n) const { assert(n <= N); (void)n; }
+
+    T* data() { return reinterpret_cast<T*>(&storage_[0]); }
+    const T* data() const { return reinterpret_cast<const T*>(&storage_[0]); }
+
+    reference operator[](size_type i) { assert(i < size_); return data()[i]; }
+    const_reference operator[](size_type i) const { assert(i < size_); return data()[i]; }
+    reference front() { return (*this)[0]; }
+    const_reference front() const { return (*this)[0]; }
+    reference back() { return (*this)[size_ - 1]; }
+    const_reference back() const { return (*this)[size_ - 1]; }
+
+    void push_back(const T& x)
+    {
+        assert(size_ < N);
+        new (data() + size_) T(x);
+        ++size_;
+    }
+    void push_back(T&& x)
+    {
+        assert(size_ < N);
+        new (data() + size_) T(std::move(x));
+        ++size_;
+    }
+    void pop_back()
+    {
+        assert(size_ > 0);
+        --size_;
+        data()[size_].~T();
+    }
+    void clear()
+    {
+        while (size_ > 0)
+            pop_back();
+    }
+
+    // Makes std::inserter work, which is used by get_back_inserter
+    // for all containers without a specialised overload.
+    iterator insert(const_iterator pos, const T& x)
+    {
+        std::size_t idx = static_cast<std::size_t>(pos - begin());
+        push_back(x);
+        std::rotate(begin() + idx, end() - 1, end());
+        return begin() + idx;
+    }
+    iterator erase(const_iterator first, const_iterator last)
+    {
+        iterator itFirst = begin() + (first - begin());
+        iterator itLast = begin() + (last - begin());
+        iterator newEnd = std::move(itLast, end(), itFirst);
+        while (end() != newEnd)
+            pop_back();
+        return itFirst;
+    }
+    iterator erase(const_iterator pos)
+    {
+        return erase(pos, pos + 1);
+    }
+
+private:
+    typedef typename std::aligned_storage<sizeof(T), alignof(T)>::type
+        storage_t;
+    storage_t storage_[N == 0 ? 1 : N];
+    size_type size_;
+};
+
+template <typename T, std::size_t N>
+bool operator == (const static_vector<T, N>& xs, const static_vector<T, N>& ys)
+{
+    return xs.size() == ys.size() &&
+        std::equal(std::begin(xs), std::end(xs), std::begin(ys));
+}
+
+template <typename T, std::size_t N>
+bool operator != (const static_vector<T, N>& xs, const static_vector<T, N>& ys)
+{
+    return !(xs == ys);
+}
+
+template <typename T, std::size_t N>
+bool operator < (const static_vector<T, N>& xs, const static_vector<T, N>& ys)
+{
+    return std::lexicographical_compare(
+        std::begin(xs), std::end(xs), std::begin(ys), std::end(ys));
+}
+
+} // namespace fplus
@@ -0,0 +1,237 @@
+// Copyright Tobias Hermann 2015.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include "flat_hash_map.h"
+#include "string_tools.h"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace fplus
+{
+
+// Stores every distinct string once and identifies it by a small integer.
+// Ids are assigned consecutively from 0 in the order of first interning,
+// so they can directly index into vectors.
+// All characters live in one buffer and the lookup table
+// is probed linearly, so interning a string already in the pool
+// does not allocate.
+class string_pool
+{
+public:
+    typedef std::uint32_t id_type;
+
+    static id_type no_id() { return std::numeric_limits<id_type>::max(); }
+
+    string_pool() : chars_(), offsets_(1, 0), slots_(16, no_id()) {}
+
+    // Id of the string [data, data + size), adding it if it is new.
+    id_type intern(const char* data, std::size_t size)
+    {
+        std::size_t slot = slot_of(data, size);
+        while (slots_[slot] != no_id())
+        {
+            if (equals(slots_[slot], data, size))
+                return slots_[slot];
+            slot = (slot + 1) & mask();
+        }
+        assert(this->size() < no_id());
+        const id_type id = static_cast<id_type>(this->size());
+        chars_.insert(std::end(chars_), data, data + size);
+        offsets_.push_back(chars_.size());
+        slots_[slot] = id;
+        if (4 * this->size() > 3 * slots_.size())
+            rehash(2 * slots_.size());
+        return id;
+    }
+
+    id_type intern(const std::string& str)
+    {
+        return intern(str.data(), str.size());
+    }
+
+    // no_id() if the string is not in the pool.
+    id_type lookup(const char* data, std::size_t size) const
+    {
+        std::size_t slot = slot_of(data, size);
+        while (slots_[slot] != no_id())
+        {
+            if (equals(slots_[slot], data, size))
+                return slots_[slot];
+            slot = (slot + 1) & mask();
+        }
+        return no_id();
+    }
+
+    id_type lookup(const std::string& str) const
+    {
+        return lookup(str.data(), str.size());
+    }
+
+    // Number of distinct strings.
+    std::size_t size() const { return offsets_.size() - 1; }
+    bool empty() const { return size() == 0; }
+
+    // Invalidated by interning new strings.
+    const char* data(id_type id) const
+    {
+        assert(id < size());
+        return chars_.data() + offsets_[id];
+    }
+
+    std::size_t length(id_type id) const
+    {
+        assert(id < size());
+        return offsets_[id + 1] - offsets_[id];
+    }
+
+    std::string str(id_type id) const
+    {
+        return std::string(data(id), length(id));
+    }
+
+    // Bytes reserved by the pool.
+    std::size_t memory_usage() const
+    {
+        return chars_.capacity() * sizeof(char) +
+            offsets_.capacity() * sizeof(std::size_t) +
+            slots_.capacity() * sizeof(id_type);
+    }
+
+private:
+    std::size_t mask() const { return slots_.size() - 1; }
+
+    std::size_t slot_of(const char* data, std::size_t size) const
+    {
+        std::uint64_t h = static_cast<std::uint64_t>(
+            string_hash::hash_chars(data, size));
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        return static_cast<std::size_t>(h) & mask();
+    }
+
+    bool equals(id_type id, const char* data, std::size_t size) const
+    {
+        return length(id) == size &&
+            (size == 0 || std::memcmp(this->data(id), data, size) == 0);
+    }
+
+    void rehash(std::size_t slotCount)
+    {
+        slots_.assign(slotCount, no_id());
+        for (std::size_t id = 0; id < size(); ++id)
+        {
+            const auto typedId = static_cast<id_type>(id);
+            std::size_t slot = slot_of(data(typedId), length(typedId));
+            while (slots_[slot] != no_id())
+                slot = (slot + 1) & mask();
+            slots_[slot] = typedId;
+        }
+    }
+
+    std::vector<char> chars_;
+    std::vector<std::size_t> offsets_;
+    std::vector<id_type> slots_;
+};
+
+// unintern(pool, [0, 1, 0]) == ["GET", "POST", "GET"]
+template <typename ContainerOut = std::vector<std::string>,
+    typename ContainerIds>
+ContainerOut unintern(const string_pool& pool, const ContainerIds& ids)
+{
+    FPLUS_PROFILE_SCOPE(size_of_cont(ids));
+    ContainerOut result;
+    prepare_container(result, size_of_cont(ids));
+    auto itOut = get_back_inserter<ContainerOut>(result);
+    for (const auto id : ids)
+        *itOut = pool.str(id);
+    FPLUS_PROFILE_OUTPUT(size_of_cont(result));
+    return result;
+}
+
+// Like split_words, but returns the ids of the words in the pool,
+// so repeated words cost four bytes each instead of a string.
+// unintern(pool, split_words_interned(pool, "How are you?"))
+//     == ["How", "are", "you"]
+inline std::vector<string_pool::id_type> split_words_interned(
+    string_pool& pool, const std::string& str)
+{
+    FPLUS_PROFILE_SCOPE(str.size());
+    std::vector<string_pool::id_type> result;
+    std::size_t wordBegin = 0;
+    for (std::size_t i = 0; i < str.size(); ++i)
+    {
+        if (!is_letter_or_digit<std::string>(str[i]))
+        {
+            if (i != wordBegin)
+                result.push_back(pool.intern(str.data() + wordBegin, i - wordBegin));
+            wordBegin = i + 1;
+        }
+    }
+    if (str.size() != wordBegin)
+        result.push_back(pool.intern(str.data() + wordBegin, str.size() - wordBegin));
+    FPLUS_PROFILE_OUTPUT(result.size());
+    return result;
+}
+
+// Like split_lines, but returns the ids of the lines in the pool.
+// Windows and mac newlines are recognized without copying the input.
+inline std::vector<string_pool::id_type> split_lines_interned(
+    string_pool& pool, const std::string& str, bool allowEmpty)
+{
+    FPLUS_PROFILE_SCOPE(str.size());
+    std::vector<string_pool::id_type> result;
+    std::size_t lineBegin = 0;
+    for (std::size_t i = 0; i < str.size(); ++i)
+    {
+        if (str[i] == '\n' || str[i] == '\r')
+        {
+            if (i != lineBegin || allowEmpty)
+                result.push_back(pool.intern(str.data() + lineBegin, i - lineBegin));
+            if (str[i] == '\r' && i + 1 < str.size() && str[i + 1] == '\n')
+                ++i;
+            lineBegin = i + 1;
+        }
+    }
+    if (str.size() != lineBegin || allowEmpty)
+        result.push_back(pool.intern(str.data() + lineBegin, str.size() - lineBegin));
+    FPLUS_PROFILE_OUTPUT(result.size());
+    return result;
+}
+
+// Like split_by_token, but returns the ids of the parts in the pool.
+inline std::vector<string_pool::id_type> split_by_token_interned(
+    string_pool& pool, const std::string& token,
+    bool allowEmpty, const std::string& str)
+{
+    assert(!token.empty());
+    FPLUS_PROFILE_SCOPE(str.size());
+    std::vector<string_pool::id_type> result;
+    std::size_t partBegin = 0;
+    for (;;)
+    {
+        const std::size_t tokenPos = str.find(token, partBegin);
+        const std::size_t partEnd =
+            tokenPos == std::string::npos ? str.size() : tokenPos;
+        if (partEnd != partBegin || allowEmpty)
+            result.push_back(pool.intern(str.data() + partBegin, partEnd - partBegin));
+        if (tokenPos == std::string::npos)
+        {
+            FPLUS_PROFILE_OUTPUT(result.size());
+            return result;
+        }
+        partBegin = tokenPos + token.size();
+    }
+}
+
+} // namespace fplus
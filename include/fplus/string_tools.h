@@ -5,6 +5,7 @@
 
 #pragma once
 
+#include "ascii.h"
 #include "replace.h"
 #include "split.h"
 #include "transform.h"
@@ -19,11 +20,8 @@ template <typename String>
 bool is_letter_or_digit(const typename String::value_type& c)
 {
     typedef typename String::value_type C;
-    auto IsDigit = bind_2_of_3(is_in_rage<C>, 48, 58);
-    auto IsLowerLetter = bind_2_of_3(is_in_rage<C>, 65, 91);
-    auto IsUpperLetter = bind_2_of_3(is_in_rage<C>, 97, 123);
-    auto IsLetter = logical_or(IsLowerLetter, IsUpperLetter);
-    return IsDigit(c) || IsLetter(c);
+    return is_in_rage<C>(48, 58, c) || is_in_rage<C>(65, 91, c) ||
+        is_in_rage<C>(97, 123, c);
 }
 
 // Is character a whitespace.
@@ -45,16 +43,76 @@ bool is_line_break(const typename String::value_type& c)
 template <typename String>
 String clean_newlines(const String& str)
 {
+    FPLUS_PROFILE_SCOPE(str.size());
     return replace_elems('\r', '\n',
         replace_tokens(String("\r\n"), String("\n"), str));
 }
 
+// The std::string overloads below classify 16 bytes per instruction
+// (see ascii.h) instead of calling the predicate for every character.
+
+template <typename ContainerOut>
+ContainerOut split_words(const std::string& str, std::true_type)
+{
+    typedef typename ContainerOut::value_type InnerContainerOut;
+    ContainerOut result;
+    auto itOut = get_back_inserter<ContainerOut>(result);
+    ascii_for_each_run<ascii_class::letter_or_digit>(str.data(), str.size(),
+        [&itOut](const char* wordBegin, const char* wordEnd)
+        { *itOut = InnerContainerOut(wordBegin, wordEnd); });
+    return result;
+}
+
+template <typename ContainerOut, typename String>
+ContainerOut split_words(const String& str, std::false_type)
+{
+    typedef typename String::value_type C;
+    auto isNoLetterOrDigit = [](const C& c)
+        { return !is_letter_or_digit<String>(c); };
+    return split_by<decltype(isNoLetterOrDigit), String, ContainerOut>(
+        isNoLetterOrDigit, false, str);
+}
+
 // Splits a string by the found whitespace characters.
 // split_words("How are you?") == ["How", "are", "you?"]
 template <typename String, typename ContainerOut = std::list<String>>
 ContainerOut split_words(const String& str)
 {
-    return split_by(logical_not(is_letter_or_digit<String>), false, str);
+    FPLUS_PROFILE_SCOPE(str.size());
+    return split_words<ContainerOut>(str,
+        std::is_same<String, std::string>());
+}
+
+template <typename ContainerOut>
+ContainerOut split_lines(const std::string& str, bool allowEmpty,
+    std::true_type)
+{
+    typedef typename ContainerOut::value_type InnerContainerOut;
+    ContainerOut result;
+    auto itOut = get_back_inserter<ContainerOut>(result);
+    const char* data = str.data();
+    const std::size_t size = str.size();
+    std::size_t lineBegin = 0;
+    for (;;)
+    {
+        std::size_t lineEnd = ascii_find_first<ascii_class::line_break, true>(
+            data, lineBegin, size);
+        if (lineEnd != lineBegin || allowEmpty)
+            *itOut = InnerContainerOut(data + lineBegin, data + lineEnd);
+        if (lineEnd == size)
+            return result;
+        if (data[lineEnd] == '\r' && lineEnd + 1 < size &&
+                data[lineEnd + 1] == '\n')
+            ++lineEnd;
+        lineBegin = lineEnd + 1;
+    }
+}
+
+template <typename ContainerOut, typename String>
+ContainerOut split_lines(const String& str, bool allowEmpty, std::false_type)
+{
+    return split_by<decltype(&is_line_break<String>), String, ContainerOut>(
+        is_line_break<String>, allowEmpty, clean_newlines(str));
 }
 
 // Splits a string by the found newlines.
@@ -62,28 +120,109 @@ ContainerOut split_words(const String& str)
 template <typename String, typename ContainerOut = std::list<String>>
 ContainerOut split_lines(const String& str, bool allowEmpty)
 {
-    return split_by(is_line_break<String>, allowEmpty, clean_newlines(str));
+    FPLUS_PROFILE_SCOPE(str.size());
+    return split_lines<ContainerOut>(str, allowEmpty,
+        std::is_same<String, std::string>());
+}
+
+inline std::string trim_whitespace_left(const std::string& str,
+    std::true_type)
+{
+    return str.substr(ascii_find_first<ascii_class::whitespace, false>(
+        str.data(), 0, str.size()));
+}
+
+template <typename String>
+String trim_whitespace_left(const String& str, std::false_type)
+{
+    return trim_left(is_whitespace<String>, str);
 }
 
 // trim_whitespace_left("    text  ") == "text  "
 template <typename String>
 String trim_whitespace_left(const String& str)
 {
-    return trim_left(is_whitespace<String>, str);
+    FPLUS_PROFILE_SCOPE(str.size());
+    return trim_whitespace_left(str, std::is_same<String, std::string>());
+}
+
+inline std::string trim_whitespace_right(const std::string& str,
+    std::true_type)
+{
+    return str.substr(0, ascii_find_last_not_end<ascii_class::whitespace>(
+        str.data(), str.size()));
+}
+
+template <typename String>
+String trim_whitespace_right(const String& str, std::false_type)
+{
+    return trim_right(is_whitespace<String>, str);
 }
 
 // trim_whitespace_right("    text  ") == "    text"
 template <typename String>
 String trim_whitespace_right(const String& str)
 {
-    return trim_right(is_whitespace<String>, str);
+    FPLUS_PROFILE_SCOPE(str.size());
+    return trim_whitespace_right(str, std::is_same<String, std::string>());
 }
 
 // trim_whitespace("    text  ") == "text"
 template <typename String>
 String trim_whitespace(const String& str)
 {
-    return trim(is_whitespace<String>, str);
+    FPLUS_PROFILE_SCOPE(str.size());
+    return trim_whitespace_right(trim_whitespace_left(str));
+}
+
+inline std::string to_upper_case(const std::string& str, std::true_type)
+{
+    std::string result = str;
+    ascii_shift_letters(&result[0], result.size(), 'a', 'A' - 'a');
+    return result;
+}
+
+template <typename String>
+String to_upper_case(const String& str, std::false_type)
+{
+    typedef typename String::value_type C;
+    return transform([](const C& c) -> C
+        { return is_in_rage<C>(97, 123, c) ? static_cast<C>(c - 32) : c; },
+        str);
+}
+
+// to_upper_case("Hello, World!") == "HELLO, WORLD!"
+// Only ASCII letters are changed, other characters are kept as they are.
+template <typename String>
+String to_upper_case(const String& str)
+{
+    FPLUS_PROFILE_SCOPE(str.size());
+    return to_upper_case(str, std::is_same<String, std::string>());
+}
+
+inline std::string to_lower_case(const std::string& str, std::true_type)
+{
+    std::string result = str;
+    ascii_shift_letters(&result[0], result.size(), 'A', 'a' - 'A');
+    return result;
+}
+
+template <typename String>
+String to_lower_case(const String& str, std::false_type)
+{
+    typedef typename String::value_type C;
+    return transform([](const C& c) -> C
+        { return is_in_rage<C>(65, 91, c) ? static_cast<C>(c + 32) : c; },
+        str);
+}
+
+// to_lower_case("Hello, World!") == "hello, world!"
+// Only ASCII letters are changed, other characters are kept as they are.
+template <typename String>
+String to_lower_case(const String& str)
+{
+    FPLUS_PROFILE_SCOPE(str.size());
+    return to_lower_case(str, std::is_same<String, std::string>());
 }
 
 } // namespace fplus
\ No newline at end of file
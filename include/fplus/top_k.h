@@ -0,0 +1,240 @@
+// Copyright Tobias Hermann 2015.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include "container_common.h"
+#include "function_traits.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace fplus
+{
+
+// Keeps the k greatest elements (by the less comparator comp)
+// seen in a stream of arbitrary length, using memory only for k elements.
+// The kept elements form a heap with the smallest of them on top,
+// so most elements of a long stream are rejected
+// after a single comparison with it.
+// Of equal elements the ones pushed first are kept.
+// top_k_accumulator<int> acc(2);
+// acc.push(3); acc.push(1); acc.push(4); acc.push(2);
+// acc.result() == [4, 3]
+template <typename T, typename Compare = std::less<T>>
+class top_k_accumulator
+{
+public:
+    explicit top_k_accumulator(std::size_t k, Compare comp = Compare()) :
+        k_(k), heap_(), comp_(comp)
+    {
+        heap_.reserve(k);
+    }
+
+    std::size_t k() const { return k_; }
+    std::size_t size() const { return heap_.size(); }
+    bool empty() const { return heap_.empty(); }
+
+    void push(const T& x)
+    {
+        if (heap_.size() < k_)
+        {
+            heap_.push_back(x);
+            std::push_heap(std::begin(heap_), std::end(heap_), greater());
+        }
+        else if (k_ != 0 && comp_(heap_.front(), x))
+        {
+            std::pop_heap(std::begin(heap_), std::end(heap_), greater());
+            heap_.back() = x;
+            std::push_heap(std::begin(heap_), std::end(heap_), greater());
+        }
+    }
+
+    template <typename InputIt>
+    void push(InputIt itBegin, InputIt itEnd)
+    {
+        for (auto it = itBegin; it != itEnd; ++it)
+            push(*it);
+    }
+
+    // The kept elements, greatest first.
+    std::vector<T> result() const &
+    {
+        std::vector<T> sorted = heap_;
+        sort_descending(sorted);
+        return sorted;
+    }
+
+    std::vector<T> result() &&
+    {
+        sort_descending(heap_);
+        return std::move(heap_);
+    }
+
+private:
+    // Inverts the comparator, so the standard max-heap functions
+    // keep the smallest kept element on top.
+    struct greater_by_comp
+    {
+        const Compare* comp;
+        bool operator()(const T& x, const T& y) const { return (*comp)(y, x); }
+    };
+    greater_by_comp greater() const { return greater_by_comp{&comp_}; }
+
+    void sort_descending(std::vector<T>& xs) const
+    {
+        std::sort_heap(std::begin(xs), std::end(xs), greater());
+    }
+
+    std::size_t k_;
+    std::vector<T> heap_;
+    Compare comp_;
+};
+
+// Below this share of the input size the k elements are collected
+// in a heap while scanning the input once.
+// For bigger k the input is copied and split with std::nth_element.
+inline bool top_k_use_heap(std::size_t k, std::size_t n)
+{
+    return k <= n / 16;
+}
+
+template <typename Compare, typename Container,
+    typename T = typename Container::value_type>
+std::vector<T> top_k_vector(Compare comp, std::size_t k, const Container& xs)
+{
+    const std::size_t n = size_of_cont(xs);
+    k = std::min(k, n);
+    if (top_k_use_heap(k, n))
+    {
+        top_k_accumulator<T, Compare> acc(k, comp);
+        acc.push(std::begin(xs), std::end(xs));
+        return std::move(acc).result();
+    }
+    auto greater = [&comp](const T& x, const T& y) { return comp(y, x); };
+    std::vector<T> result(std::begin(xs), std::end(xs));
+    std::nth_element(std::begin(result),
+        std::begin(result) + static_cast<std::ptrdiff_t>(k),
+        std::end(result), greater);
+    result.resize(k);
+    std::sort(std::begin(result), std::end(result), greater);
+    return result;
+}
+
+// top_k_by(is_less_by(size), 2, ["ab", "c", "def", "gh"]) == ["def", "ab"]
+// The k greatest elements by the less comparator comp, greatest first.
+// Same result as take(k, reverse(sort_by(comp, xs))) up to the order
+// of equal elements, but only the k result elements are ever sorted.
+template <typename Compare, typename Container>
+Container top_k_by(Compare comp, std::size_t k, const Container& xs)
+{
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
+    FPLUS_PROFILE_OUTPUT(std::min(k, size_of_cont(xs)));
+    return convert_container<Container>(top_k_vector(comp, k, xs));
+}
+
+// top_k(2, [3, 1, 4, 1, 5]) == [5, 4]
+template <typename Container>
+Container top_k(std::size_t k, const Container& xs)
+{
+    typedef typename Container::value_type T;
+    return top_k_by(std::less<T>(), k, xs);
+}
+
+// Top k by comparing the keys of the elements.
+// In the heap case the keys are computed while streaming over xs,
+// so only k of them are stored.
+template <typename DecoratedCompare, typename F, typename Container>
+Container top_k_decorated(DecoratedCompare comp, F key_fn, std::size_t k,
+    const Container& xs)
+{
+    static_assert(utils::function_traits<F>::arity == 1, "Wrong arity.");
+    typedef std::remove_const_t<std::remove_reference_t<
+        typename utils::function_traits<F>::result_type>> Key;
+    typedef std::pair<Key, typename Container::const_iterator> Decorated;
+    const std::size_t n = size_of_cont(xs);
+    k = std::min(k, n);
+    if (!top_k_use_heap(k, n))
+        return undecorate_keys<Container>(
+            top_k_vector(comp, k, decorate_with_keys(key_fn, xs)));
+    top_k_accumulator<Decorated, DecoratedCompare> acc(k, comp);
+    for (auto it = std::begin(xs); it != std::end(xs); ++it)
+        acc.push(Decorated(key_fn(*it), it));
+    return undecorate_keys<Container>(std::move(acc).result());
+}
+
+// top_k_on(size, 2, ["ab", "c", "def", "gh"]) == ["def", "ab"]
+// key_fn is called only once per element.
+template <typename F, typename Container>
+Container top_k_on(F key_fn, std::size_t k, const Container& xs)
+{
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
+    FPLUS_PROFILE_OUTPUT(std::min(k, size_of_cont(xs)));
+    auto less = [](const auto& x, const auto& y) { return x.first < y.first; };
+    return top_k_decorated(less, key_fn, k, xs);
+}
+
+// smallest_k_by(is_less_by(size), 2, ["ab", "c", "def", "gh"]) == ["c", "ab"]
+// The k smallest elements by the less comparator comp, smallest first.
+template <typename Compare, typename Container>
+Container smallest_k_by(Compare comp, std::size_t k, const Container& xs)
+{
+    typedef typename Container::value_type T;
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
+    FPLUS_PROFILE_OUTPUT(std::min(k, size_of_cont(xs)));
+    auto greater = [comp](const T& x, const T& y) { return comp(y, x); };
+    return top_k_by(greater, k, xs);
+}
+
+// smallest_k(2, [3, 1, 4, 1, 5]) == [1, 1]
+template <typename Container>
+Container smallest_k(std::size_t k, const Container& xs)
+{
+    typedef typename Container::value_type T;
+    return smallest_k_by(std::less<T>(), k, xs);
+}
+
+// smallest_k_on(size, 2, ["ab", "c", "def", "gh"]) == ["c", "ab"]
+template <typename F, typename Container>
+Container smallest_k_on(F key_fn, std::size_t k, const Container& xs)
+{
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
+    FPLUS_PROFILE_OUTPUT(std::min(k, size_of_cont(xs)));
+    auto greater = [](const auto& x, const auto& y) { return y.first < x.first; };
+    return top_k_decorated(greater, key_fn, k, xs);
+}
+
+// partial_sort_by((<), 2, [5, 1, 4, 2, 3]) == [1, 2] ++ permutation of [5, 4, 3]
+// The k smallest elements are sorted into the front,
+// the order of the remaining ones is unspecified.
+// Needs a container with random access.
+template <typename Compare, typename Container>
+Container partial_sort_by(Compare comp, std::size_t k, const Container& xs)
+{
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
+    FPLUS_AUDIT_COPY(xs);
+    Container result = xs;
+    const std::size_t n = size_of_cont(result);
+    std::partial_sort(std::begin(result),
+        std::next(std::begin(result), static_cast<std::ptrdiff_t>(std::min(k, n))),
+        std::end(result), comp);
+    FPLUS_PROFILE_OUTPUT(n);
+    return result;
+}
+
+// partial_sort(2, [5, 1, 4, 2, 3]) == [1, 2] ++ permutation of [5, 4, 3]
+template <typename Container>
+Container partial_sort(std::size_t k, const Container& xs)
+{
+    typedef typename Container::value_type T;
+    return partial_sort_by(std::less<T>(), k, xs);
+}
+
+} // namespace fplus
@@ -26,10 +26,12 @@ template <typename F, typename ContainerIn,
 ContainerOut transform(F f, const ContainerIn& xs)
 {
     static_assert(utils::function_traits<F>::arity == 1, "Wrong arity.");
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
     ContainerOut ys;
     prepare_container(ys, size_of_cont(xs));
     auto it = get_back_inserter<ContainerOut>(ys);
     std::transform(std::begin(xs), std::end(xs), it, f);
+    FPLUS_PROFILE_OUTPUT(size_of_cont(ys));
     return ys;
 }
 
@@ -39,13 +41,43 @@ template <typename ContainerOut, typename F, typename ContainerIn>
 ContainerOut transform_convert(F f, const ContainerIn& xs)
 {
     static_assert(utils::function_traits<F>::arity == 1, "Wrong arity.");
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
     ContainerOut ys;
     prepare_container(ys, size_of_cont(xs));
     auto it = get_back_inserter<ContainerOut>(ys);
     std::transform(std::begin(xs), std::end(xs), it, f);
+    FPLUS_PROFILE_OUTPUT(size_of_cont(ys));
     return ys;
 }
 
+// (a -> Bool) -> [a] -> bitvector
+// transform_to_bitvector(is_even, [1, 2, 4]) == [false, true, true]
+// Same result as transform_convert<bitvector>,
+// but the bits are collected into whole words before storing them.
+template <typename UnaryPredicate, typename ContainerIn>
+bitvector transform_to_bitvector(UnaryPredicate p, const ContainerIn& xs)
+{
+    check_unary_predicate_for_container<UnaryPredicate, ContainerIn>();
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
+    bitvector result;
+    result.reserve(size_of_cont(xs));
+    bitvector::word_type word = 0;
+    std::size_t bitIdx = 0;
+    for (const auto& x : xs)
+    {
+        word |= bitvector::word_type(p(x) ? 1 : 0) << bitIdx;
+        if (++bitIdx == bitvector::word_bits())
+        {
+            result.push_back_word(word, bitIdx);
+            word = 0;
+            bitIdx = 0;
+        }
+    }
+    result.push_back_word(word, bitIdx);
+    FPLUS_PROFILE_OUTPUT(result.size());
+    return result;
+}
+
 // (size_t -> a -> b) -> [a] -> [b]
 // transform_with_idx(f, [6, 4, 7]) == [f(0, 6), f(1, 4), f(2, 7)]
 template <typename F, typename ContainerIn,
@@ -56,6 +88,7 @@ template <typename F, typename ContainerIn,
 ContainerOut transform_with_idx(F f, const ContainerIn& xs)
 {
     static_assert(utils::function_traits<F>::arity == 2, "Wrong arity.");
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
     ContainerOut ys;
     prepare_container(ys, size_of_cont(xs));
     auto it = get_back_inserter<ContainerOut>(ys);
@@ -64,6 +97,7 @@ ContainerOut transform_with_idx(F f, const ContainerIn& xs)
     {
         *it = f(idx++, x);
     }
+    FPLUS_PROFILE_OUTPUT(size_of_cont(ys));
     return ys;
 }
 
@@ -75,6 +109,7 @@ template <typename F, typename ContainerIn,
 ContainerOut transform_and_keep_justs(F f, const ContainerIn& xs)
 {
     static_assert(utils::function_traits<F>::arity == 1, "Wrong arity.");
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
     auto transformed = transform(f, xs);
     return justs<decltype(transformed), ContainerOut>(transformed);
 }
@@ -86,6 +121,7 @@ template <typename F, typename ContainerIn,
 ContainerOut transform_and_concat(F f, const ContainerIn& xs)
 {
     static_assert(utils::function_traits<F>::arity == 1, "Wrong arity.");
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
     return concat(transform(f, xs));
 }
 
@@ -94,6 +130,7 @@ template <typename Container>
 Container transpose(const Container& grid2d)
 {
     std::size_t height = size_of_cont(grid2d);
+    FPLUS_PROFILE_SCOPE(height);
     if (height == 0)
         return grid2d;
 
@@ -114,6 +151,7 @@ Container transpose(const Container& grid2d)
             *itOutRow = grid2d[y][x];
         }
     }
+    FPLUS_PROFILE_OUTPUT(width);
     return result;
 }
 
@@ -123,8 +161,10 @@ template <typename Container>
 Container sample(std::size_t n, const Container& xs)
 {
     assert(n <= size_of_cont(xs));
+    FPLUS_PROFILE_SCOPE(size_of_cont(xs));
     std::random_device rd;
     std::mt19937 gen(rd());
+    FPLUS_AUDIT_COPY(xs);
     Container ys = xs;
     std::shuffle(begin(ys), end(ys), gen);
     return get_range(0, n, ys);
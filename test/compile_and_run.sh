@@ -1,7 +1,10 @@
 #!/usr/bin/env bash
 
-g++ -std=c++14 -O3 -Wall -Wextra -pedantic -Werror -o ./temp_FunctionalPlus_tests__gcc -I./../include tests.cpp
-clang++-3.6 -O3 -std=c++14 -Wall -Wextra -pedantic -Werror -o ./temp_FunctionalPlus_tests__clang -I./../include tests.cpp
+g++ -std=c++14 -O3 -Wall -Wextra -pedantic -Werror -pthread -o ./temp_FunctionalPlus_tests__gcc -I./../include tests.cpp
+clang++-3.6 -O3 -std=c++14 -Wall -Wextra -pedantic -Werror -pthread -o ./temp_FunctionalPlus_tests__clang -I./../include tests.cpp
+# The opt-in instrumentations have to compile and pass too.
+g++ -std=c++14 -O3 -Wall -Wextra -pedantic -Werror -pthread -DFPLUS_PROFILE -o ./temp_FunctionalPlus_tests__gcc_profile -I./../include tests.cpp
+g++ -std=c++14 -O3 -Wall -Wextra -pedantic -Werror -pthread -DFPLUS_AUDIT_COPIES -o ./temp_FunctionalPlus_tests__gcc_audit -I./../include tests.cpp
 
 if [ -f ./temp_FunctionalPlus_tests__gcc ];
 then
@@ -13,4 +16,16 @@ if [ -f ./temp_FunctionalPlus_tests__clang ];
 then
     ./temp_FunctionalPlus_tests__clang
     rm ./temp_FunctionalPlus_tests__clang
+fi
+
+if [ -f ./temp_FunctionalPlus_tests__gcc_profile ];
+then
+    ./temp_FunctionalPlus_tests__gcc_profile
+    rm ./temp_FunctionalPlus_tests__gcc_profile
+fi
+
+if [ -f ./temp_FunctionalPlus_tests__gcc_audit ];
+then
+    ./temp_FunctionalPlus_tests__gcc_audit
+    rm ./temp_FunctionalPlus_tests__gcc_audit
 fi
\ No newline at end of file
@@ -5,14 +5,27 @@
 
 #include "fplus.h"
 
+#include <array>
+#include <atomic>
 #include <cassert>
 #include <chrono>
+#include <cstdlib>
+#include <cmath>
 #include <ctime>
 #include <deque>
 #include <functional>
 #include <iostream>
+#include <limits>
 #include <list>
+#include <map>
+#include <set>
+#include <memory>
+#include <new>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
 #include <string>
+#include <thread>
 #include <vector>
 
 void Test_Numeric()
@@ -263,6 +276,13 @@ void Test_Maybe()
     assert(just(1) != nothing<int>());
     assert(nothing<int>() == nothing<int>());
 
+    maybe<Ints> movedFrom(Ints({1,2,3}));
+    const int* elems = movedFrom.unsafe_get_just().data();
+    maybe<Ints> movedTo(std::move(movedFrom));
+    assert(movedTo.unsafe_get_just().data() == elems);
+    movedFrom = std::move(movedTo);
+    assert(movedFrom == just(Ints({1,2,3})));
+
     Ints wholeNumbers = { -3, 4, 16, -1 };
     assert(transform_and_keep_justs(sqrtToMaybeInt, wholeNumbers)
             == Ints({2,4}));
@@ -388,6 +408,24 @@ void Test_ContainerTools()
     assert(show_cont(xs) == xsShown);
     assert(show_cont_with(", ", xs) == xsShown);
     assert(show<int>(1) == "1");
+    assert(show(-1234567) == "-1234567");
+    assert(show(std::numeric_limits<std::int64_t>::min()) == "-9223372036854775808");
+    assert(show(std::numeric_limits<std::uint64_t>::max()) == "18446744073709551615");
+    assert(show(0u) == "0");
+    assert(show(1.5) == "1.5");
+    assert(show(0.1f) == "0.1");
+    assert(show(1e20) == "1e+20");
+    assert(show('a') == "a");
+    assert(show(true) == "1");
+    assert(show(std::string("str")) == "str");
+    assert(show_cont(std::vector<double>({0.5, -2})) == "[0.5, -2]");
+    assert(show_cont_with_frame_and_limit(", ", "[", "]", 2, xs) == "[1, 2, ...]");
+    assert(show_cont_with_frame_and_limit(", ", "[", "]", 0, xs) == "[...]");
+    assert(show_cont_with_frame_and_limit(", ", "[", "]", 5, xs) == xsShown);
+    assert(show_cont_with_frame_and_limit(", ", "[", "]", 2, IntVector()) == "[]");
+    std::ostringstream xsStream;
+    write_cont(xsStream, xs);
+    assert(xsStream.str() == xsShown);
     auto multiply = [](int x, int y){ return x * y; };
     assert(zip_with(multiply, xs, xs)
             == transform(squareLambda, xs));
@@ -454,6 +492,25 @@ void Test_ContainerTools()
             { return isEven(a) == isEven(b); };
     assert(unique_by(IsEqualByIsEven, xs) == IntVector({1,2,3,2}));
 
+    typedef std::vector<std::string> StringVector;
+    auto absInt = [](int x) { return std::abs(x); };
+    auto stringSize = [](const std::string& str) { return str.size(); };
+    assert(sort_on(stringSize, StringVector({"abc", "d", "ef"})) == StringVector({"d", "ef", "abc"}));
+    assert(stable_sort_on(stringSize, StringVector({"ab", "c", "de", "f"})) == StringVector({"c", "f", "ab", "de"}));
+    assert(stable_sort_on(stringSize, std::list<std::string>({"ab", "c"})) == std::list<std::string>({"c", "ab"}));
+    assert(sort_on(absInt, IntVector()) == IntVector());
+    assert(unique_on(absInt, IntVector({1,-1,2,3,-3,1})) == IntVector({1,2,3,1}));
+    assert(unique_on(absInt, IntVector()) == IntVector());
+    assert(nub_on(absInt, IntVector({1,-1,2,-2,3,1})) == IntVector({1,2,3}));
+    assert(nub_on(absInt, IntVector({-3,1,3,-1})) == IntVector({-3,1}));
+    assert(nub_on(absInt, IntVector()) == IntVector());
+    assert(group_on(absInt, IntVector({1,-1,2,3,-3,1})) == std::list<IntVector>({IntVector({1,-1}),IntVector({2}),IntVector({3,-3}),IntVector({1})}));
+    assert(group_on(absInt, IntVector()) == std::list<IntVector>());
+    auto calls = std::make_shared<std::size_t>(0);
+    auto countingKey = [calls](int x) { ++*calls; return -x; };
+    assert(sort_on(countingKey, xs) == reverse(xsSorted));
+    assert(*calls == xs.size());
+
     assert(all_the_same(IntVector()) == true);
     assert(all_the_same(IntVector({1})) == true);
     assert(all_the_same(IntVector({1,1,1})) == true);
@@ -493,6 +550,37 @@ void Test_ContainerTools()
     assert(find_last_idx(2, xs) == just<size_t>(4));
     assert(find_last_idx(4, xs) == nothing<size_t>());
 
+    const IntVector sortedXs = {1,3,4,4,9};
+    assert(lower_bound_idx(4, sortedXs) == 2);
+    assert(lower_bound_idx(5, sortedXs) == 4);
+    assert(lower_bound_idx(10, sortedXs) == 5);
+    assert(upper_bound_idx(4, sortedXs) == 4);
+    assert(upper_bound_idx(0, sortedXs) == 0);
+    assert(find_first_idx_sorted(4, sortedXs) == just<size_t>(2));
+    assert(find_first_idx_sorted(5, sortedXs) == nothing<size_t>());
+    assert(find_first_idx_sorted(4, std::list<int>({1,3,4,4,9})) == just<size_t>(2));
+    assert(contains_sorted(9, sortedXs));
+    assert(!contains_sorted(2, sortedXs));
+    assert(!contains_sorted(2, IntVector()));
+
+    const eytzinger_index<int> eytzinger(sortedXs);
+    assert(eytzinger.size() == 5);
+    assert(eytzinger.lower_bound_idx(4) == 2);
+    assert(eytzinger.lower_bound_idx(0) == 0);
+    assert(eytzinger.lower_bound_idx(10) == 5);
+    assert(eytzinger.find_idx(9) == just<size_t>(4));
+    assert(eytzinger.find_idx(5) == nothing<size_t>());
+    assert(eytzinger.contains(1) && !eytzinger.contains(2));
+    assert(!eytzinger_index<int>().contains(1));
+    assert(eytzinger_index<int>().lower_bound_idx(1) == 0);
+    const auto sortedRandoms = sort(generate<IntVector>([]() { return std::rand() % 2000; }, 1000));
+    const eytzinger_index<int> randomEytzinger(sortedRandoms);
+    for (int x = -1; x <= 2001; ++x)
+    {
+        assert(randomEytzinger.lower_bound_idx(x) == lower_bound_idx(x, sortedRandoms));
+        assert(randomEytzinger.find_idx(x) == find_first_idx(x, sortedRandoms));
+    }
+
     assert(nth_element(2, xs) == 2);
 
     IntPair intPair = std::make_pair(2, 3);
@@ -518,6 +606,11 @@ void Test_ContainerTools()
     assert(replace_elems(2, 5, xs) == IntVector({1,5,5,3,5}));
     assert(replace_tokens(std::string("123"), std::string("_"),
             std::string("--123----123123")) == std::string("--_----__"));
+    assert(find_all_instances_of_non_overlapping(std::string("xx"), std::string("bxxxxc"))
+        == std::list<std::size_t>({ 1, 3 }));
+    assert(find_all_instances_of_non_overlapping(std::string("ab"), std::string("aab"))
+        == std::list<std::size_t>({ 1 }));
+    assert(clean_newlines(std::string("a\r\r\nb")) == std::string("a\n\nb"));
     assert(take(2, xs) == IntVector({ 1,2 }));
     assert(drop(2, xs) == IntVector({ 2,3,2 }));
     assert(take_while(is_odd, xs) == IntVector({ 1 }));
@@ -605,6 +698,47 @@ void Test_ContainerTools()
     assert(get_from_map_with_def(intStringMap, std::string("n/a"), 9) == "n/a");
     assert(map_contains(intStringMap, 1) == true);
     assert(map_contains(intStringMap, 9) == false);
+    assert(*get_ptr_from_map(intStringMap, 4) == "53");
+    assert(get_ptr_from_map(intStringMap, 9) == nullptr);
+    std::map<std::string, int, std::less<>> transparentMap = {{"a", 1}, {"b", 2}};
+    assert(*get_ptr_from_map(transparentMap, "b") == 2);
+    assert(map_contains(transparentMap, "c") == false);
+    ++*get_ptr_from_map(transparentMap, "a");
+    assert(get_from_map_or_insert(transparentMap, "a", 7) == 2);
+    get_from_map_or_insert(transparentMap, "c", 7) += 1;
+    assert(transparentMap == (std::map<std::string, int, std::less<>>({{"a", 2}, {"b", 2}, {"c", 8}})));
+    IntStringUnorderedMap unorderedForInsert = {{1, "x"}};
+    assert(get_from_map_or_insert(unorderedForInsert, 1, std::string("y")) == "x");
+    assert(get_from_map_or_insert(unorderedForInsert, 2, std::string("y")) == "y");
+    assert(unorderedForInsert.size() == 2);
+
+    typedef std::map<int, int> IntIntMap;
+    const IntIntMap intIntMap = {{1, 2}, {3, 4}, {5, 6}};
+    assert(convert_container<IntVector>(map_keys_view(intStringMap)) == IntVector({1, 4, 7}));
+    assert(convert_container<StringVector>(map_values_view(intStringMap)) == StringVector({"2", "53", "21"}));
+    assert(size_of_cont(map_keys_view(intIntMap)) == 3);
+    assert(transform_map_values([](int x) { return 2 * x; }, intIntMap) == IntIntMap({{1, 4}, {3, 8}, {5, 12}}));
+    assert(transform_map_values(show<int>, intIntMap) == IntStringMap({{1, "2"}, {3, "4"}, {5, "6"}}));
+    typedef std::map<int, int, std::greater<int>> IntIntDescMap;
+    typedef std::map<int, std::string, std::greater<int>> IntStringDescMap;
+    const IntStringDescMap descStrings = transform_map_values(show<int>, IntIntDescMap({{1, 2}, {3, 4}, {5, 6}}));
+    assert(descStrings == IntStringDescMap({{5, "6"}, {3, "4"}, {1, "2"}}));
+    assert(descStrings.begin()->first == 5);
+    auto descending = [](int a, int b) { return a > b; };
+    std::map<int, int, decltype(descending)> lambdaOrdered(descending);
+    lambdaOrdered[1] = 2;
+    lambdaOrdered[3] = 4;
+    assert(map_to_pairs(transform_map_values([](int x) { return 2 * x; }, lambdaOrdered))
+        == (std::vector<std::pair<int, int>>({{3, 8}, {1, 4}})));
+    assert(map_keep_if(is_odd, IntIntMap({{1, 2}, {2, 3}, {3, 4}})) == IntIntMap({{1, 2}, {3, 4}}));
+    assert(map_drop_if(is_odd, IntIntMap({{1, 2}, {2, 3}, {3, 4}})) == IntIntMap({{2, 3}}));
+    auto add_ints = [](int a, int b) { return a + b; };
+    assert(map_union_with(add_ints, IntIntMap({{0, 1}, {1, 2}}), IntIntMap({{1, 3}, {2, 4}})) ==
+        IntIntMap({{0, 1}, {1, 5}, {2, 4}}));
+    typedef std::unordered_map<int, int> IntIntUnorderedMap;
+    assert(map_union_with(add_ints, IntIntUnorderedMap({{0, 1}, {1, 2}}), IntIntUnorderedMap({{1, 3}, {2, 4}})) ==
+        IntIntUnorderedMap({{0, 1}, {1, 5}, {2, 4}}));
+    assert(map_keep_if(is_odd, IntIntUnorderedMap({{1, 2}, {2, 3}})) == IntIntUnorderedMap({{1, 2}}));
 
     typedef std::vector<std::size_t> IdxVector;
     assert(split_at_idx(2, xs) == std::make_pair(IntVector({1,2}), IntVector({2,3,2})));
@@ -614,6 +748,15 @@ void Test_ContainerTools()
     IntVectors splittedAt1And3Dest = {IntVector({1}), IntVector({2,2}), IntVector({3,2})};
     assert(splittedAt1And3 == splittedAt1And3Dest);
     assert(split_by(isEven, true, IntList({1,3,2,2,5,5,3,6,7,9})) == IntLists({{1,3},{},{5,5,3},{7,9}}));
+    // Empty parts are skipped without swallowing the following token.
+    assert((split_by_token<std::string, StringVector>(",", false, "a,,b"))
+        == StringVector({"a", "b"}));
+    assert((split_by_token<std::string, StringVector>("ab", false, "xababy"))
+        == StringVector({"x", "y"}));
+    assert((split_by_token<std::string, StringVector>(",", false, ",,a,"))
+        == StringVector({"a"}));
+    assert((split_by_token<std::string, StringVector>(",", true, "a,,b"))
+        == StringVector({"a", "", "b"}));
     typedef std::map<int, std::size_t> IntSizeTMap;
     IntSizeTMap OccurrencesResult = {{1, 1}, {2, 3}, {3, 1}};
     assert(count_occurrences(xs) == OccurrencesResult);
@@ -624,6 +767,1169 @@ void Test_ContainerTools()
     assert(sum(convert<std::vector<int>>(std::string("hello"))) == 532);
 }
 
+void Test_FixedSizeContainers()
+{
+    using namespace fplus;
+    auto squareLambda = [](int x) { return x*x; };
+    auto isEven = [](int x){ return x % 2 == 0; };
+
+    typedef std::array<int, 5> IntArray5;
+    typedef std::array<float, 5> FloatArray5;
+    typedef std::array<std::string, 5> StringArray5;
+    IntArray5 xs = {{1,2,2,3,2}};
+    assert(transform(squareLambda, xs) == IntArray5({{1,4,4,9,4}}));
+    assert(convert_elems<float>(xs) == FloatArray5({{1.0f,2.0f,2.0f,3.0f,2.0f}}));
+    assert(transform(show<int>, xs) == StringArray5({{"1","2","2","3","2"}}));
+    assert(transform_with_idx(std::plus<int>(), xs) == IntArray5({{1,3,4,6,6}}));
+    assert(sort(xs) == IntArray5({{1,2,2,2,3}}));
+    assert(reverse(xs) == IntArray5({{2,3,2,2,1}}));
+    assert(sum(xs) == 10);
+    assert(show_cont(xs) == "[1, 2, 2, 3, 2]");
+    assert(count(2, xs) == 3);
+    // keep_if, split_by etc. reject std::array at compile time,
+    // since the size of their result is not known before.
+    static_assert(is_std_array<IntArray5>::value, "");
+    static_assert(!is_std_array<static_vector<int, 5>>::value, "");
+    typedef static_vector<int, 5> IntStaticVec5;
+    assert(keep_if(isEven, convert_container<IntStaticVec5>(xs)) == IntStaticVec5({2,2,2}));
+    assert(drop_if(isEven, convert_container<IntStaticVec5>(xs)) == IntStaticVec5({1,3}));
+
+    typedef static_vector<int, 8> IntStaticVec;
+    typedef static_vector<IntStaticVec, 8> IntStaticVecs;
+    IntStaticVec ys = {1,2,2,3,2};
+    assert(ys.size() == 5);
+    assert(ys.capacity() == 8);
+    assert(transform(squareLambda, ys) == IntStaticVec({1,4,4,9,4}));
+    assert(keep_if(isEven, ys) == IntStaticVec({2,2,2}));
+    assert(drop_if(isEven, ys) == IntStaticVec({1,3}));
+    assert(convert_elems<float>(ys) == (static_vector<float, 8>({1.0f,2.0f,2.0f,3.0f,2.0f})));
+    assert(unique(ys) == IntStaticVec({1,2,3,2}));
+    assert(sort(reverse(ys)) == IntStaticVec({1,2,2,2,3}));
+    assert(append(ys, IntStaticVec({7})) == IntStaticVec({1,2,2,3,2,7}));
+    assert(trim_right(isEven, ys) == IntStaticVec({1,2,2,3}));
+    assert(convert_container<IntStaticVec>(xs) == ys);
+    assert(convert_container<std::vector<int>>(ys) == std::vector<int>({1,2,2,3,2}));
+    assert((split_by<decltype(isEven), IntStaticVec, IntStaticVecs>(
+        isEven, false, IntStaticVec({1,3,2,5,6,7,9})))
+        == IntStaticVecs({{1,3},{5},{7,9}}));
+    assert((group<IntStaticVec, IntStaticVecs>(ys))
+        == IntStaticVecs({{1},{2,2},{3},{2}}));
+
+    static_vector<std::string, 4> strs = {"a", "b"};
+    strs.push_back("c");
+    assert(show_cont(strs) == "[a, b, c]");
+    strs.pop_back();
+    assert(strs == (static_vector<std::string, 4>({"a", "b"})));
+
+    typedef small_vector<int, 4> IntSmallVec;
+    typedef std::vector<IntSmallVec> IntSmallVecs;
+    IntSmallVec zs = {1,2,2,3,2};
+    assert(!zs.is_inline());
+    assert(IntSmallVec({1,2}).is_inline());
+    assert(transform(squareLambda, zs) == IntSmallVec({1,4,4,9,4}));
+    assert(keep_if(isEven, zs) == IntSmallVec({2,2,2}));
+    assert(convert_elems<float>(zs) == (small_vector<float, 4>({1.0f,2.0f,2.0f,3.0f,2.0f})));
+    assert(sort(reverse(zs)) == IntSmallVec({1,2,2,2,3}));
+    assert(trim_right(isEven, zs) == IntSmallVec({1,2,2,3}));
+    assert(convert_container<std::vector<int>>(zs) == std::vector<int>({1,2,2,3,2}));
+    IntSmallVec moved = std::move(zs);
+    assert(moved == IntSmallVec({1,2,2,3,2}));
+    assert(zs.empty());
+    IntSmallVec small = {7};
+    moved = small;
+    assert(moved == small);
+    moved.push_back(moved.front());
+    moved.push_back(moved.front());
+    moved.push_back(moved.front());
+    moved.push_back(moved.front());
+    assert(moved == IntSmallVec({7,7,7,7,7}));
+
+    typedef std::vector<int> IntVector;
+    typedef std::vector<IntVector> IntVectors;
+    assert((split_by<decltype(isEven), IntVector, IntSmallVecs>(
+        isEven, false, IntVector({1,3,2,5,6,7,9,11,13,15})))
+        == IntSmallVecs({{1,3},{5},{7,9,11,13,15}}));
+    IntVector grouped = {1,2,2,3,2};
+    assert((group<IntVector, IntSmallVecs>(grouped))
+        == IntSmallVecs({{1},{2,2},{3},{2}}));
+    assert((group_on<decltype(isEven), IntVector, IntSmallVecs>(isEven, grouped))
+        == IntSmallVecs({{1},{2,2},{3},{2}}));
+    assert((split_by_token<IntVector, IntSmallVecs>(IntVector({0,0}), false,
+        IntVector({1,0,0,2,3,0,0,4}))) == IntSmallVecs({{1},{2,3},{4}}));
+    assert((split_by_token<IntVector, IntVectors>(IntVector({0}), false,
+        IntVector({1,0,2}))) == IntVectors({{1},{2}}));
+    typedef small_vector<char, 8> Word;
+    assert((split_words<std::string, std::vector<Word>>("How are you?"))
+        == std::vector<Word>({{'H','o','w'},{'a','r','e'},{'y','o','u'}}));
+    assert((split_lines<std::string, std::vector<Word>>("a\nb", false))
+        == std::vector<Word>({{'a'},{'b'}}));
+}
+
+void Test_RadixSort()
+{
+    using namespace fplus;
+    typedef std::vector<int> IntVector;
+    typedef std::vector<std::string> StringVector;
+
+    auto check_against_std_sort = [](auto xs)
+    {
+        auto expected = xs;
+        std::sort(std::begin(expected), std::end(expected));
+        assert(sort_radix(xs) == expected);
+        assert(sort(xs) == expected);
+    };
+
+    std::srand(42);
+    auto randomInts = generate<IntVector>(std::rand, 5000);
+    check_against_std_sort(randomInts);
+    check_against_std_sort(transform([](int x) { return x - RAND_MAX / 2; }, randomInts));
+    check_against_std_sort(transform([](int x) { return static_cast<std::int64_t>(x) * 123456789 - (1LL << 50); }, randomInts));
+    check_against_std_sort(transform([](int x) { return static_cast<std::uint64_t>(x) << 20; }, randomInts));
+    check_against_std_sort(transform([](int x) { return static_cast<std::uint8_t>(x); }, randomInts));
+    check_against_std_sort(transform([](int x) { return static_cast<std::int16_t>(x); }, randomInts));
+    check_against_std_sort(transform([](int x) { return static_cast<char>(x); }, randomInts));
+    check_against_std_sort(transform([](int x) { return (x - RAND_MAX / 2) / 1000.0; }, randomInts));
+    check_against_std_sort(transform([](int x) { return static_cast<float>(x % 2000 - 1000) * 1e30f; }, randomInts));
+    check_against_std_sort(IntVector({std::numeric_limits<int>::min(), 0, -1, 1, std::numeric_limits<int>::max()}));
+    check_against_std_sort(std::vector<double>({std::numeric_limits<double>::infinity(), -0.5, 0.0,
+        -std::numeric_limits<double>::infinity(), std::numeric_limits<double>::lowest(), 1e-310}));
+    check_against_std_sort(IntVector());
+    check_against_std_sort(IntVector({7}));
+    check_against_std_sort(IntVector(1000, 7));
+
+    auto randomWord = [](int x)
+    {
+        std::string word;
+        for (int i = 0; i < x % 7; ++i)
+            word.push_back(static_cast<char>('a' + (x >> (i * 2)) % 3));
+        return word;
+    };
+    auto words = transform(randomWord, randomInts);
+    check_against_std_sort(words);
+    check_against_std_sort(transform([](const std::string& str) { return "common/prefix/" + str; }, words));
+    check_against_std_sort(StringVector({"b", "", "a\xff", "a", "ab", "a\x01", ""}));
+
+    assert(sort_radix(std::list<int>({3,1,2})) == std::list<int>({1,2,3}));
+    assert(sort_radix(std::deque<double>({0.5,-2.0,1.0})) == std::deque<double>({-2.0,0.5,1.0}));
+    assert(sort_radix(std::array<int, 3>({{3,1,2}})) == (std::array<int, 3>({{1,2,3}})));
+    assert(sort_radix(std::string("radix")) == "adirx");
+}
+
+void Test_Memoize()
+{
+    using namespace fplus;
+    typedef std::vector<int> IntVector;
+    int calls = 0;
+    auto squareCounting = [&calls](int x) { ++calls; return x * x; };
+
+    auto squareMemo = memoize(squareCounting);
+    static_assert(utils::function_traits<decltype(squareMemo)>::arity == 1, "No.");
+    static_assert(std::is_same<
+        utils::function_traits<decltype(squareMemo)>::arg<0>::type,
+        int>::value, "No.");
+    static_assert(std::is_same<
+        utils::function_traits<decltype(squareMemo)>::result_type,
+        int>::value, "No.");
+    IntVector xs = {1,2,2,3,2};
+    assert(transform(squareMemo, xs) == IntVector({1,4,4,9,4}));
+    assert(calls == 3);
+    assert(squareMemo.hits() == 2);
+    assert(squareMemo.misses() == 3);
+    auto squareMemoCopy = squareMemo;
+    assert(squareMemoCopy(3) == 9);
+    assert(calls == 3);
+    assert(squareMemo.hits() == 3);
+    assert((compose(squareMemo, squareMemo)(2)) == 16);
+    std::function<int(int)> squareMemoStdFunction = squareMemo;
+    assert(squareMemoStdFunction(2) == 4);
+
+    auto showTwice = [](const std::string& str) { return str + str; };
+    auto showTwiceMemo = memoize(showTwice);
+    assert(showTwiceMemo("ab") == "abab");
+    assert(showTwiceMemo(std::string("ab")) == "abab");
+    assert(showTwiceMemo.hits() == 1);
+
+    calls = 0;
+    auto squareLru = memoize_lru(2, squareCounting);
+    squareLru(1);
+    squareLru(2);
+    squareLru(1);
+    squareLru(3);
+    assert(squareLru.cache_size() <= 2);
+    assert(calls == 3);
+    assert(squareLru.hits() == 1);
+
+    calls = 0;
+    auto squareLru1 = memoize_lru(1, squareCounting);
+    squareLru1(1);
+    squareLru1(1);
+    squareLru1(2);
+    squareLru1(1);
+    assert(calls == 3);
+    assert(squareLru1.cache_size() == 1);
+}
+
+void Test_Pipeline()
+{
+    using namespace fplus;
+    typedef std::vector<int> IntVector;
+    typedef std::map<int, std::size_t> IntSizeTMap;
+    auto parse = [](const std::string& str) { return std::stoi(str); };
+    auto isEven = [](int x){ return x % 2 == 0; };
+    auto isSmall = [](int x){ return x < 100; };
+
+    auto numbers = generate_by_idx<IntVector>(
+        [](std::size_t i) { return static_cast<int>((i * 7919) % 1000); }, 10000);
+    const std::string text = show_cont_with_frame("\n", "", "", numbers);
+    const auto lines = split_lines(text, false);
+
+    const auto sequential = count_occurrences(
+        keep_if(isSmall, keep_if(isEven, transform(parse, lines))));
+
+    auto ingest = make_pipeline<std::string>(64, 4)
+        .transform(parse, "parse")
+        .keep_if(isEven)
+        .keep_if(isSmall);
+    const auto pipelined = count_occurrences(ingest.run(lines));
+    assert(pipelined == sequential);
+    assert(ingest.stats().size() == 3);
+    assert(ingest.stats()[0].name == "parse");
+    assert(ingest.stats()[0].items_in == 10000);
+    assert(ingest.stats()[0].items_out == 10000);
+    assert(ingest.stats()[1].items_out == ingest.stats()[2].items_in);
+    assert(ingest.stats()[2].items_out == sum(get_map_values(sequential)));
+
+    auto count_one = [](const IntSizeTMap& acc, int x)
+    {
+        IntSizeTMap result = acc;
+        ++result[x];
+        return result;
+    };
+    assert(ingest.run_and_fold(count_one, IntSizeTMap(), lines) == sequential);
+
+    auto squareLambda = [](int x) { return x * x; };
+    assert(make_pipeline<int>(2, 1).transform(squareLambda).drop_if(isEven)
+        .run(IntVector({1,2,3,4,5})) == IntVector({1,9,25}));
+    assert(make_pipeline<int>().transform(squareLambda).run(IntVector()) == IntVector());
+    assert(make_pipeline<int>().run(std::list<int>({3,2,1})) == IntVector({3,2,1}));
+
+    // A failing stage stops the other threads,
+    // and its exception reaches the caller of run.
+    auto failOn777 = [](int x) -> int
+    {
+        if (x == 777)
+            throw std::runtime_error("777");
+        return x;
+    };
+    auto runFailing = [&](const IntVector& xs) -> std::string
+    {
+        try
+        {
+            make_pipeline<int>(16, 1).transform(failOn777).transform(squareLambda).run(xs);
+        }
+        catch (const std::runtime_error& e)
+        {
+            return e.what();
+        }
+        return "";
+    };
+    assert(runFailing(numbers) == "777");
+    assert(runFailing(IntVector({1,2,3})) == "");
+    bool foldFailed = false;
+    try
+    {
+        make_pipeline<int>(16, 1).transform(squareLambda)
+            .run_and_fold([](int acc, int x) -> int
+            {
+                if (x > 1000)
+                    throw std::logic_error("fold");
+                return acc + x;
+            }, 0, numbers);
+    }
+    catch (const std::logic_error&)
+    {
+        foldFailed = true;
+    }
+    assert(foldFailed);
+
+    // Stages much slower than their neighbours make the others sleep.
+    auto slowIdentity = [](int x)
+    {
+        if (x % 100 == 0)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        return x;
+    };
+    assert(make_pipeline<int>(4, 1).transform(slowIdentity).transform(squareLambda)
+        .run(numbers) == transform(squareLambda, numbers));
+}
+
+void Test_Parallel()
+{
+    using namespace fplus;
+    typedef std::vector<int> IntVector;
+    typedef std::vector<IntVector> IntVectors;
+    auto squareLambda = [](int x) { return x * x; };
+    auto numbers = generate_by_idx<IntVector>(
+        [](std::size_t i) { return static_cast<int>(i % 1000); }, 10000);
+    assert(transform_parallelly(squareLambda, numbers) == transform(squareLambda, numbers));
+    assert(transform_parallelly(squareLambda, IntVector()) == IntVector());
+    assert(transform_parallelly(squareLambda, std::list<int>({1,2,3})) == std::list<int>({1,4,9}));
+
+    // Neighbouring bools share a word in std::vector<bool>,
+    // an odd size makes the tasks' ranges straddle such words.
+    auto isMultipleOf3 = [](int x) { return x % 3 == 0; };
+    auto oddSized = generate_by_idx<IntVector>(
+        [](std::size_t i) { return static_cast<int>(i); }, 100003);
+    assert(transform_parallelly(isMultipleOf3, oddSized) == transform(isMultipleOf3, oddSized));
+    assert(transform_parallelly(isMultipleOf3, std::list<int>({3,4,6})) == std::list<bool>({true,false,true}));
+
+    auto replicateSelf = [](int x) { return replicate<IntVector>(static_cast<std::size_t>(x), x); };
+    auto skewed = IntVector({1, 0, 3, 1000, 2, 1, 0, 500});
+    assert(transform_and_concat_parallelly(replicateSelf, skewed) ==
+        transform_and_concat(replicateSelf, skewed));
+
+    // nested parallel calls must not deadlock
+    auto sumOfSquaresParallelly = [&](const IntVector& xs)
+        { return sum(transform_parallelly(squareLambda, xs)); };
+    auto nested = generate_by_idx<IntVectors>(
+        [](std::size_t i) -> IntVector { return replicate<IntVector>(i * 37 % 500, static_cast<int>(i)); }, 200);
+    assert(transform_parallelly(sumOfSquaresParallelly, nested) ==
+        transform([&](const IntVector& xs) { return sum(transform(squareLambda, xs)); }, nested));
+
+    work_stealing_pool pool(3);
+    assert(pool.size() == 3);
+    std::atomic<std::size_t> visited(0);
+    {
+        task_group group(pool);
+        for (std::size_t i = 0; i < 100; ++i)
+            group.run([&]() { ++visited; });
+        group.wait();
+    }
+    assert(visited == 100);
+    std::vector<int> flags(1000, 0);
+    parallel_for_idx(pool, flags.size(), 7, [&](std::size_t i) { flags[i] = 1; });
+    assert(sum(flags) == 1000);
+
+    // Exceptions thrown on worker threads reach the caller.
+    auto throwOn500 = [](int x) -> int
+    {
+        if (x == 500)
+            throw std::runtime_error("500");
+        return x;
+    };
+    bool caught = false;
+    try
+    {
+        transform_parallelly(throwOn500, numbers);
+    }
+    catch (const std::runtime_error& e)
+    {
+        caught = std::string(e.what()) == "500";
+    }
+    assert(caught);
+    caught = false;
+    {
+        task_group group(pool);
+        for (std::size_t i = 0; i < 100; ++i)
+            group.run([i]() { if (i % 10 == 3) throw std::logic_error("task"); });
+        try
+        {
+            group.wait();
+        }
+        catch (const std::logic_error&)
+        {
+            caught = true;
+        }
+        group.run([&]() { ++visited; });
+        group.wait();
+    }
+    assert(caught);
+    assert(visited == 101);
+    assert(transform_parallelly(squareLambda, numbers) == transform(squareLambda, numbers));
+
+    auto add = [](int acc, int x) { return acc + x; };
+    assert(scan_left_parallelly(add, 0, IntVector({1,2,3})) == IntVector({0,1,3,6}));
+    assert(scan_left_inclusive_parallelly(add, 0, IntVector({1,2,3})) == IntVector({1,3,6}));
+    assert(scan_left_exclusive_parallelly(add, 0, IntVector({1,2,3})) == IntVector({0,1,3}));
+    assert(scan_left_parallelly(add, 5, IntVector()) == IntVector({5}));
+    assert(scan_left_inclusive_parallelly(add, 5, IntVector()) == IntVector());
+    assert(scan_left_parallelly(add, 0, std::list<int>({1,2,3})) == std::list<int>({0,1,3,6}));
+    const std::size_t manyBlocks = 3 * scan_block_size() + 17;
+    auto longNumbers = generate_by_idx<IntVector>(
+        [](std::size_t i) { return static_cast<int>(i % 7) - 3; }, manyBlocks);
+    const auto sequential = scan_left(add, 1, longNumbers);
+    assert(scan_left_parallelly(add, 1, longNumbers) == sequential);
+    assert(scan_left_exclusive_parallelly(add, 1, longNumbers) == take(sequential.size() - 1, sequential));
+    assert(scan_left_inclusive_parallelly(add, 1, longNumbers) == drop(1, sequential));
+    auto maxInt = [](int acc, int x) { return std::max(acc, x); };
+    assert(scan_left_parallelly(maxInt, -10, longNumbers) == scan_left(maxInt, -10, longNumbers));
+
+    // std::plus on 32 and 64 bit integers uses the SSE2 kernel,
+    // which has to handle every tail length.
+    typedef std::vector<std::int64_t> Int64Vector;
+    static_assert(is_vectorizable_scan_sum<std::plus<int>, int,
+        IntVector::const_iterator, IntVector::iterator>::value, "");
+    static_assert(!is_vectorizable_scan_sum<decltype(add), int,
+        IntVector::const_iterator, IntVector::iterator>::value, "");
+    for (std::size_t size : {0, 1, 3, 4, 5, 8, 9, 17})
+    {
+        const IntVector ints(longNumbers.begin(), longNumbers.begin() + static_cast<std::ptrdiff_t>(size));
+        assert(scan_left_parallelly(std::plus<int>(), 1, ints) == scan_left(add, 1, ints));
+        assert(scan_left_inclusive_parallelly(std::plus<int>(), 1, ints) == drop(1, scan_left(add, 1, ints)));
+    }
+    assert(scan_left_parallelly(std::plus<int>(), 1, longNumbers) == sequential);
+    assert(scan_left_exclusive_parallelly(std::plus<int>(), 1, longNumbers) == take(sequential.size() - 1, sequential));
+    assert(scan_left_inclusive_parallelly(std::plus<int>(), 1, longNumbers) == drop(1, sequential));
+    const auto longInt64s = convert_elems<std::int64_t>(longNumbers);
+    assert(scan_left_parallelly(std::plus<std::int64_t>(), std::int64_t(1), longInt64s) ==
+        convert_elems<std::int64_t>(sequential));
+    assert(scan_left_inclusive_parallelly(std::plus<std::int64_t>(), std::int64_t(1), Int64Vector({1,2,3})) ==
+        Int64Vector({2,4,7}));
+
+    // The block partition does not depend on the number of threads,
+    // so floating-point results are reproducible.
+    typedef std::vector<float> FloatVector;
+    auto addFloat = [](float acc, float x) { return acc + x; };
+    auto floats = generate_by_idx<FloatVector>(
+        [](std::size_t i) { return 1.0f / static_cast<float>(i % 101 + 1); }, manyBlocks);
+    std::vector<FloatVector> floatScans;
+    for (std::size_t threadCount : {1, 2, 5})
+    {
+        work_stealing_pool scanPool(threadCount);
+        FloatVector ys(floats.size());
+        scan_left_blocks_parallelly(scanPool, addFloat, 0.0f,
+            floats.begin(), floats.size(), ys.begin(), true);
+        floatScans.push_back(ys);
+    }
+    assert(all_the_same(floatScans));
+    assert(floatScans.front() == scan_left_inclusive_parallelly(addFloat, 0.0f, floats));
+}
+
+void Test_Aggregate()
+{
+    using namespace fplus;
+    typedef std::vector<int> IntVector;
+    typedef std::pair<int, int> IntPair;
+    typedef std::vector<IntPair> IntPairs;
+    auto isEven = [](int x){ return x % 2 == 0; };
+    auto add = [](int acc, int x) { return acc + x; };
+    auto xs = IntVector({1,2,3,4,5});
+
+    auto sums = group_fold_on(isEven, add, 0, xs);
+    assert(sums.size() == 2);
+    assert(sums[false] == 9);
+    assert(sums[true] == 6);
+    assert(group_fold_on(isEven, add, 0, IntVector()).empty());
+    typedef std::map<bool, int> BoolIntMap;
+    assert((group_fold_on<decltype(isEven), decltype(add), int, IntVector, bool, BoolIntMap>(
+        isEven, add, 100, xs)) == BoolIntMap({{false, 109}, {true, 106}}));
+
+    auto counts = count_by_key(isEven, xs);
+    assert(counts[false] == 3 && counts[true] == 2);
+
+    auto pairs = IntPairs({{1, 2}, {2, 3}, {1, 4}});
+    auto pairKey = [](const IntPair& p) { return p.first; };
+    auto pairVal = [](const IntPair& p) { return p.second; };
+    auto pairSums = sum_by_key(pairKey, pairVal, pairs);
+    assert(pairSums.size() == 2 && pairSums[1] == 6 && pairSums[2] == 3);
+
+    auto modKey = [](int x) { return x % 97; };
+    auto numbers = generate_by_idx<IntVector>(
+        [](std::size_t i) { return static_cast<int>(i * 7919 % 100003); }, 50000);
+    auto sequentialSums = sum_by_key(modKey, identity<int>, numbers);
+    assert(sum_by_key_parallelly(modKey, identity<int>, numbers) == sequentialSums);
+    assert(count_by_key_parallelly(modKey, numbers) == count_by_key(modKey, numbers));
+    assert(count_by_key_parallelly(modKey, std::list<int>(numbers.begin(), numbers.end())) ==
+        count_by_key(modKey, numbers));
+    assert(count_by_key_parallelly(modKey, IntVector()).empty());
+
+    auto sortedGroupSums = transform(
+        [&](const IntVector& group) { return std::make_pair(modKey(group.front()), sum(group)); },
+        group_on(modKey, sort_on(modKey, numbers)));
+    assert(sortedGroupSums.size() == sequentialSums.size());
+    for (const auto& keyAndSum : sortedGroupSums)
+        assert(sequentialSums[keyAndSum.first] == keyAndSum.second);
+
+    typedef std::pair<bool, IntVector> LabeledGroup;
+    assert(group_on_labeled(isEven, IntVector({1,3,2,4,5})) == std::vector<LabeledGroup>(
+        {{false, {1,3}}, {true, {2,4}}, {false, {5}}}));
+}
+
+void Test_Joins()
+{
+    using namespace fplus;
+    typedef std::pair<int, std::string> IntStr;
+    typedef std::vector<IntStr> IntStrs;
+    typedef std::pair<IntStr, IntStr> Joined;
+    auto key = [](const IntStr& p) { return p.first; };
+    const IntStrs as = {{1, "a"}, {2, "b"}, {4, "d"}, {2, "bb"}};
+    const IntStrs bs = {{2, "x"}, {3, "y"}, {2, "xx"}, {5, "z"}};
+
+    const auto inner = join_on(key, key, as, bs);
+    assert(inner == std::vector<Joined>({
+        {{2, "b"}, {2, "x"}}, {{2, "b"}, {2, "xx"}},
+        {{2, "bb"}, {2, "x"}}, {{2, "bb"}, {2, "xx"}}}));
+    auto concatSnds = [](const IntStr& a, const IntStr& b) { return a.second + b.second; };
+    assert(join_on_with(concatSnds, key, key, as, bs) ==
+        std::vector<std::string>({"bx", "bxx", "bbx", "bbxx"}));
+    assert(join_on(key, key, as, IntStrs()).empty());
+
+    const auto left = left_join_on(key, key, as, bs);
+    assert(left.size() == 6);
+    assert(left[0].first == IntStr(1, "a") && is_nothing(left[0].second));
+    assert(left[1].second == just(IntStr(2, "x")));
+    assert(left[3].first == IntStr(4, "d") && is_nothing(left[3].second));
+
+    const auto outer = outer_join_on(key, key, as, bs);
+    assert(outer.size() == 8);
+    assert(is_nothing(outer[6].first) && outer[6].second == just(IntStr(3, "y")));
+    assert(is_nothing(outer[7].first) && outer[7].second == just(IntStr(5, "z")));
+    auto describe = [](const maybe<IntStr>& a, const maybe<IntStr>& b) -> std::string
+    {
+        return (is_just(a) ? unsafe_get_just(a).second : "-") +
+            (is_just(b) ? unsafe_get_just(b).second : "-");
+    };
+    assert(outer_join_on_with(describe, key, key, as, bs) == std::vector<std::string>(
+        {"a-", "bx", "bxx", "d-", "bbx", "bbxx", "-y", "-z"}));
+
+    const auto asSorted = stable_sort_on(key, as);
+    const auto bsSorted = stable_sort_on(key, bs);
+    assert(join_on_sorted(key, key, asSorted, bsSorted) ==
+        join_on(key, key, asSorted, bsSorted));
+    assert(join_on_with_sorted(concatSnds, key, key, asSorted, bsSorted) ==
+        std::vector<std::string>({"bx", "bxx", "bbx", "bbxx"}));
+    const auto leftSorted = left_join_on_sorted(key, key, asSorted, bsSorted);
+    assert(leftSorted.size() == 6);
+    assert(leftSorted.back().first == IntStr(4, "d") && is_nothing(leftSorted.back().second));
+    const auto outerSorted = outer_join_on_sorted(key, key, asSorted, bsSorted);
+    assert(outerSorted.size() == 8);
+    assert(is_nothing(outerSorted[5].first) && outerSorted[5].second == just(IntStr(3, "y")));
+    assert(outerSorted[6].first == just(IntStr(4, "d")) && is_nothing(outerSorted[6].second));
+    assert(join_on_sorted(key, key, IntStrs(), bsSorted).empty());
+}
+
+void Test_Sets()
+{
+    using namespace fplus;
+    typedef std::vector<int> IntVector;
+    typedef std::set<int> IntSet;
+    const IntVector xs = {1,2,3,5};
+    const IntVector ys = {2,3,4};
+    assert(set_intersection(xs, ys) == IntVector({2,3}));
+    assert(set_union(xs, ys) == IntVector({1,2,3,4,5}));
+    assert(set_difference(xs, ys) == IntVector({1,5}));
+    assert(set_symmetric_difference(xs, ys) == IntVector({1,4,5}));
+    assert(set_union(IntVector(), ys) == ys);
+    assert(set_intersection(xs, IntVector()) == IntVector());
+
+    assert(set_intersection(IntSet({1,2,3,5}), IntSet({2,3,4})) == IntSet({2,3}));
+    assert(set_union(IntSet({1,2,5}), IntSet({2,3,4})) == IntSet({1,2,3,4,5}));
+    assert(set_difference(IntSet({1,2,3,5}), xs) == IntSet());
+    assert(set_symmetric_difference(std::list<int>({1,2}), IntSet({2,3})) == std::list<int>({1,3}));
+
+    // galloping results must match the linear std algorithms
+    std::srand(11);
+    auto random_sorted = [](std::size_t n, int maxVal)
+        { return sort(generate<IntVector>([maxVal]() { return std::rand() % maxVal; }, n)); };
+    auto check_with_std = [](const IntVector& as, const IntVector& bs)
+    {
+        IntVector expected;
+        std::set_intersection(as.begin(), as.end(), bs.begin(), bs.end(), std::back_inserter(expected));
+        assert(set_intersection(as, bs) == expected);
+        expected.clear();
+        std::set_union(as.begin(), as.end(), bs.begin(), bs.end(), std::back_inserter(expected));
+        assert(set_union(as, bs) == expected);
+        expected.clear();
+        std::set_difference(as.begin(), as.end(), bs.begin(), bs.end(), std::back_inserter(expected));
+        assert(set_difference(as, bs) == expected);
+        expected.clear();
+        std::set_symmetric_difference(as.begin(), as.end(), bs.begin(), bs.end(), std::back_inserter(expected));
+        assert(set_symmetric_difference(as, bs) == expected);
+    };
+    const IntVector big = random_sorted(5000, 3000);
+    const IntVector small = random_sorted(40, 3000);
+    check_with_std(big, small);
+    check_with_std(small, big);
+    check_with_std(big, random_sorted(4000, 3000));
+    check_with_std(IntVector({1,1,1,2}), IntVector(100, 1));
+    check_with_std(IntVector(100, 1), IntVector({1,1,3}));
+
+    assert(gallop_lower_bound(big.begin(), big.end(), 1500) ==
+        std::lower_bound(big.begin(), big.end(), 1500));
+    assert(gallop_lower_bound(big.begin(), big.end(), 5000) == big.end());
+    assert(gallop_lower_bound(big.begin(), big.end(), -1) == big.begin());
+
+    typedef std::vector<IntVector> IntVectors;
+    assert(sets_intersection(IntVectors({{1,2,3}, {2,3,4}, {0,3}})) == IntVector({3}));
+    assert(sets_intersection(IntVectors()) == IntVector());
+    assert(sets_union(IntVectors({{1,2}, {2,3}, {5}})) == IntVector({1,2,3,5}));
+    assert(sets_union(std::vector<IntSet>({{3}, {1}, {2, 3}})) == IntSet({1,2,3}));
+}
+
+// Key type that counts how often it is copied.
+struct CopyCountedKey
+{
+    explicit CopyCountedKey(int x) : x_(x) {}
+    CopyCountedKey(const CopyCountedKey& other) : x_(other.x_) { ++copies; }
+    CopyCountedKey(CopyCountedKey&&) = default;
+    CopyCountedKey& operator=(const CopyCountedKey&) = default;
+    CopyCountedKey& operator=(CopyCountedKey&&) = default;
+    static std::size_t copies;
+    int x_;
+};
+std::size_t CopyCountedKey::copies = 0;
+bool operator == (const CopyCountedKey& lhs, const CopyCountedKey& rhs) { return lhs.x_ == rhs.x_; }
+struct CopyCountedKeyHash
+{
+    std::size_t operator()(const CopyCountedKey& key) const { return std::hash<int>()(key.x_); }
+};
+
+void Test_FlatMaps()
+{
+    using namespace fplus;
+    typedef flat_map<int, std::string> IntStringFlatMap;
+    typedef flat_map<std::string, int> StringIntFlatMap;
+    typedef flat_hash_map<int, std::string> IntStringFlatHashMap;
+    typedef flat_hash_map<std::string, int> StringIntFlatHashMap;
+    typedef std::vector<std::pair<int, std::string>> IntStringPairs;
+
+    const IntStringPairs pairs = {{7, "21"}, {1, "2"}, {4, "53"}, {1, "x"}};
+    const IntStringFlatMap flatMap = pairs_to_map<IntStringFlatMap>(pairs);
+    assert(flatMap == IntStringFlatMap({{1, "2"}, {4, "53"}, {7, "21"}}));
+    assert(map_to_pairs(flatMap) == IntStringPairs({{1, "2"}, {4, "53"}, {7, "21"}}));
+    assert(get_map_keys(flatMap) == std::vector<int>({1, 4, 7}));
+    assert(get_from_map(flatMap, 4) == just<std::string>("53"));
+    assert(get_from_map(flatMap, 5) == nothing<std::string>());
+    assert(map_contains(flatMap, 7));
+    assert(swap_keys_and_values(flatMap) == StringIntFlatMap({{"2", 1}, {"21", 7}, {"53", 4}}));
+    typedef std::map<int, std::string> IntStringMap;
+    assert(convert<IntStringMap>(flatMap) == pairs_to_map<IntStringMap>(pairs));
+
+    const IntStringFlatHashMap flatHashMap = pairs_to_map<IntStringFlatHashMap>(pairs);
+    assert(flatHashMap.size() == 3);
+    assert(get_map_keys(flatHashMap) == std::vector<int>({7, 1, 4}));
+    assert(get_from_map(flatHashMap, 1) == just<std::string>("2"));
+    assert(get_from_map(flatHashMap, 5) == nothing<std::string>());
+    assert(swap_keys_and_values(flatHashMap) == StringIntFlatHashMap({{"2", 1}, {"21", 7}, {"53", 4}}));
+    assert(convert_container<IntStringFlatHashMap>(flatMap) == flatHashMap);
+
+    const std::vector<int> keys = {3, 1, 2};
+    const std::vector<std::string> values = {"c", "a", "b"};
+    const IntStringPairs sortedPairs = {{1, "a"}, {2, "b"}, {3, "c"}};
+    const IntStringPairs insertionOrderPairs = {{3, "c"}, {1, "a"}, {2, "b"}};
+    assert(create_flat_map(keys, values).entries() == sortedPairs);
+    assert(create_flat_hash_map(keys, values).entries() == insertionOrderPairs);
+
+    IntStringFlatMap m;
+    m[5] = "e";
+    m[2] = "b";
+    assert(m.insert(std::make_pair(2, std::string("x"))).second == false);
+    m.insert(m.end(), {9, "i"});
+    m.insert(m.end(), {1, "a"});
+    assert(get_map_keys(m) == std::vector<int>({1, 2, 5, 9}));
+    assert(m.erase(5) == 1 && m.erase(5) == 0 && m.at(9) == "i");
+
+    typedef flat_map<int, int> IntIntFlatMap;
+    const IntIntFlatMap fm1 = {{0, 1}, {1, 2}, {3, 3}};
+    const IntIntFlatMap fm2 = {{1, 3}, {2, 4}};
+    assert(map_union_with(std::plus<int>(), fm1, fm2) == IntIntFlatMap({{0, 1}, {1, 5}, {2, 4}, {3, 3}}));
+    assert(transform_map_values([](int x) { return x * 10; }, fm1) == IntIntFlatMap({{0, 10}, {1, 20}, {3, 30}}));
+    assert(map_keep_if([](int k) { return k > 0; }, fm1) == IntIntFlatMap({{1, 2}, {3, 3}}));
+    assert(get_map_values(map_keep_if([](int k) { return k != 1; },
+        pairs_to_map<flat_hash_map<int, int>>(fm1))) == std::vector<int>({1, 3}));
+
+    flat_map<std::string, int, std::less<>> transparentFlatMap = {{"b", 2}, {"a", 1}};
+    assert(*get_ptr_from_map(transparentFlatMap, "b") == 2);
+    assert(get_ptr_from_map(transparentFlatMap, "c") == nullptr);
+    get_from_map_or_insert(transparentFlatMap, std::string("0"), 5);
+    get_from_map_or_insert(transparentFlatMap, std::string("a"), 5);
+    assert(get_map_values(transparentFlatMap) == std::vector<int>({5, 1, 2}));
+    flat_hash_map<std::string, int, string_hash, std::equal_to<>> transparentFlatHashMap = {{"b", 2}, {"a", 1}};
+    assert(*get_ptr_from_map(transparentFlatHashMap, "a") == 1);
+    assert(map_contains(transparentFlatHashMap, "c") == false);
+    assert(string_hash()("abc") == string_hash()(std::string("abc")));
+    ++get_from_map_or_insert(transparentFlatHashMap, std::string("c"), 3);
+    assert(transparentFlatHashMap.at("c") == 4);
+
+    // erasing with backward shifts must keep all other keys reachable
+    flat_hash_map<int, int> h;
+    for (int i = 0; i < 1000; ++i)
+        h[i * 16] = i;
+    for (int i = 0; i < 1000; i += 3)
+        assert(h.erase(i * 16) == 1);
+    assert(h.size() == 666);
+    for (int i = 0; i < 1000; ++i)
+        assert(map_contains(h, i * 16) == (i % 3 != 0));
+    for (const auto& entry : h)
+        assert(h.at(entry.first) == entry.second);
+
+    // Accessing or inserting a present key does not copy it.
+    flat_hash_map<CopyCountedKey, int, CopyCountedKeyHash> counted;
+    const CopyCountedKey one(1);
+    counted[one] = 1;
+    assert(CopyCountedKey::copies == 1);
+    ++counted[one];
+    assert(counted.insert(std::make_pair(CopyCountedKey(1), 5)).second == false);
+    assert(counted.try_emplace(one, 7).second == false);
+    assert(counted.try_emplace(CopyCountedKey(2), 7).second);
+    assert(CopyCountedKey::copies == 1);
+    assert(counted.at(one) == 2 && counted.at(CopyCountedKey(2)) == 7);
+
+    // get_from_map_or_insert copies key and default value only on a miss.
+    std::unordered_map<CopyCountedKey, CopyCountedKey, CopyCountedKeyHash> countedValues;
+    const CopyCountedKey zero(0);
+    CopyCountedKey::copies = 0;
+    assert(get_from_map_or_insert(countedValues, one, zero).x_ == 0);
+    assert(CopyCountedKey::copies == 2);
+    get_from_map_or_insert(countedValues, one, zero).x_ = 5;
+    assert(get_from_map_or_insert(countedValues, one, zero).x_ == 5);
+    assert(get_from_map_or_insert(counted, one, 0) == 2);
+    assert(CopyCountedKey::copies == 2);
+}
+
+void Test_SoaVector()
+{
+    using namespace fplus;
+    typedef std::vector<int> IntVector;
+    typedef std::vector<std::string> StringVector;
+    typedef soa_vector<int, std::string> IntStringSoa;
+
+    const IntStringSoa xs = zip_to_soa(IntVector({3, 1, 2, 5}), StringVector({"c", "a", "b"}));
+    assert(xs.size() == 3);
+    assert(xs.column<0>() == IntVector({3, 1, 2}));
+    assert(xs.column<1>() == StringVector({"c", "a", "b"}));
+    assert(xs.row(1) == std::make_tuple(1, std::string("a")));
+    assert(unzip(xs) == std::make_pair(IntVector({3, 1, 2}), StringVector({"c", "a", "b"})));
+    assert(unzip(IntStringSoa(xs)) == unzip(xs));
+
+    auto show_row = [](int i, const std::string& str) { return str + show(i); };
+    assert(transform(show_row, xs) == StringVector({"c3", "a1", "b2"}));
+    assert(transform_column<0>([](int i) { return 10 * i; }, xs).column<0>() == IntVector({30, 10, 20}));
+    assert(keep_if([](int i, const std::string& str) { return i > 1 && str != "b"; }, xs) ==
+        IntStringSoa(IntVector({3}), StringVector({"c"})));
+    assert(sort_on([](int i, const std::string&) { return i; }, xs) ==
+        IntStringSoa(IntVector({1, 2, 3}), StringVector({"a", "b", "c"})));
+    assert(sort_on([](int, const std::string& str) { return str.size(); }, xs) == xs);
+
+    IntStringSoa ys;
+    ys.push_back(1, "x");
+    ys.push_back(std::make_tuple(2, std::string("y")));
+    typedef std::vector<std::tuple<int, std::string>> IntStringTuples;
+    const IntStringTuples expectedTuples = {std::make_tuple(1, "x"), std::make_tuple(2, "y")};
+    assert(convert_container<IntStringTuples>(ys) == expectedTuples);
+    assert(std::move(ys).column<1>() == StringVector({"x", "y"}));
+
+    const auto first = xs.begin();
+    const auto last = xs.end();
+    assert(2 + first == first + 2 && last - (2 + first) == 1);
+    assert(first < last && last > first && first <= first && last >= first);
+    assert(!(last <= first) && !(first >= last));
+    assert(first[2] == xs.row(2) && *(last - 1) == xs.row(2));
+}
+
+void Test_Bitvector()
+{
+    using namespace fplus;
+    typedef std::vector<int> IntVector;
+    auto is_even = [](int x) { return x % 2 == 0; };
+    const IntVector xs = generate_by_idx<IntVector>([](std::size_t i) { return static_cast<int>(i * i % 7); }, 150);
+    const bitvector mask = transform_to_bitvector(is_even, xs);
+    assert(mask == transform_convert<bitvector>(is_even, xs));
+    assert(mask.size() == 150);
+    assert(convert_container<std::vector<bool>>(mask) == transform(is_even, xs));
+    assert(count(true, mask) == count_if(is_even, xs));
+    assert(count(false, mask) == 150 - count_if(is_even, xs));
+    assert(keep_if_by_mask(mask, xs) == keep_if(is_even, xs));
+    assert(drop_if_by_mask(mask, xs) == drop_if(is_even, xs));
+    assert(keep_if_by_mask(mask, convert_container<std::list<int>>(xs)) ==
+        convert_container<std::list<int>>(keep_if(is_even, xs)));
+
+    assert(all(bitvector(130, true)));
+    assert(!all(bitvector(130, false)));
+    assert(none(bitvector(130, false)));
+    assert(all(bitvector()) && none(bitvector()) && !any(bitvector()));
+    bitvector almostAll(130, true);
+    almostAll.set(129, false);
+    assert(!all(almostAll) && any(almostAll) && count(true, almostAll) == 129);
+    assert(all(~bitvector(70, false)) && count(true, ~almostAll) == 1);
+
+    const bitvector a = {true, true, false, false};
+    const bitvector b = {true, false, true, false};
+    assert((a & b) == bitvector({true, false, false, false}));
+    assert((a | b) == bitvector({true, true, true, false}));
+    assert((a ^ b) == bitvector({false, true, true, false}));
+    assert(transform([](bool x) { return !x; }, a) == bitvector({false, false, true, true}));
+    assert(transform([](bool x) { return x ? 1 : 0; }, a) == IntVector({1, 1, 0, 0}));
+    bitvector c;
+    c.push_back_word(5, 3);
+    c.push_back_word(~std::uint64_t(0), 64);
+    assert(c.size() == 67 && count(true, c) == 66 && !c[1] && c[66]);
+
+    const auto first = c.begin();
+    const auto last = c.end();
+    assert(66 + first == first + 66 && *(66 + first) && !first[1]);
+    assert(first < last && last > first && first <= first && last >= first);
+    assert(!(last <= first) && !(first >= last) && last - first == 67);
+}
+
+void Test_TopK()
+{
+    using namespace fplus;
+    typedef std::vector<int> IntVector;
+    typedef std::vector<std::string> StringVector;
+    const IntVector xs = {3, 1, 4, 1, 5, 9, 2, 6};
+    assert(top_k(3, xs) == IntVector({9, 6, 5}));
+    assert(top_k(0, xs) == IntVector());
+    assert(top_k(20, xs) == IntVector({9, 6, 5, 4, 3, 2, 1, 1}));
+    assert(smallest_k(3, xs) == IntVector({1, 1, 2}));
+    assert(top_k(2, std::list<int>({3, 1, 4})) == std::list<int>({4, 3}));
+    assert(top_k_by(std::greater<int>(), 2, xs) == IntVector({1, 1}));
+    assert(smallest_k_by(std::greater<int>(), 2, xs) == IntVector({9, 6}));
+    auto str_size = [](const std::string& str) { return str.size(); };
+    const StringVector strs = {"ab", "c", "def", "ghij"};
+    assert(top_k_on(str_size, 2, strs) == StringVector({"ghij", "def"}));
+    assert(smallest_k_on(str_size, 2, strs) == StringVector({"c", "ab"}));
+    assert(take(2, partial_sort(2, xs)) == IntVector({1, 1}));
+    assert(sort(partial_sort(3, xs)) == sort(xs));
+    assert(take(3, partial_sort_by(std::greater<int>(), 3, xs)) == IntVector({9, 6, 5}));
+
+    // heap and nth_element paths must agree with sorting everything
+    std::srand(23);
+    const IntVector ys = generate<IntVector>([]() { return std::rand() % 10000; }, 5000);
+    for (std::size_t k : {std::size_t(1), std::size_t(50), std::size_t(1000), std::size_t(5000)})
+    {
+        assert(top_k(k, ys) == take(k, reverse(sort(ys))));
+        assert(smallest_k(k, ys) == take(k, sort(ys)));
+        auto negated = [](int x) { return -x; };
+        assert(top_k_on(negated, k, ys) == take(k, sort(ys)));
+        assert(smallest_k_on(negated, k, ys) == take(k, reverse(sort(ys))));
+    }
+
+    top_k_accumulator<int> acc(2);
+    assert(acc.result() == IntVector());
+    for (int x : {3, 1, 4, 1, 5})
+        acc.push(x);
+    assert(acc.size() == 2 && acc.result() == IntVector({5, 4}));
+    top_k_accumulator<int, std::greater<int>> smallestAcc(3);
+    smallestAcc.push(xs.begin(), xs.end());
+    assert(std::move(smallestAcc).result() == IntVector({1, 1, 2}));
+}
+
+void Test_Rolling()
+{
+    using namespace fplus;
+    typedef std::vector<int> IntVector;
+    typedef std::vector<double> DoubleVector;
+    const IntVector xs = {3, 1, 4, 1, 5, 9, 2, 6};
+    assert(rolling_sum(3, xs) == IntVector({8, 6, 10, 15, 16, 17}));
+    assert(rolling_sum(1, xs) == xs);
+    assert(rolling_sum(8, xs) == IntVector({31}));
+    assert(rolling_sum(9, xs) == IntVector());
+    assert(rolling_mean<double>(2, IntVector({1, 2, 4, 4})) == DoubleVector({1.5, 3, 4}));
+    assert(rolling_min(2, xs) == IntVector({1, 1, 1, 1, 5, 2, 2}));
+    assert(rolling_max(3, std::list<int>(xs.begin(), xs.end())) == IntVector({4, 4, 5, 9, 9, 9}));
+    assert(windowed_fold(2, std::plus<int>(), std::minus<int>(), 100, IntVector({1, 2, 3})) == IntVector({103, 105}));
+
+    // must match folding every materialized window
+    std::srand(31);
+    const IntVector ys = generate<IntVector>([]() { return std::rand() % 100; }, 300);
+    for (std::size_t w : {std::size_t(1), std::size_t(2), std::size_t(7), std::size_t(64), std::size_t(300)})
+    {
+        IntVector sums, mins, maxs;
+        for (std::size_t i = 0; i + w <= ys.size(); ++i)
+        {
+            const IntVector window = get_range(i, i + w, ys);
+            sums.push_back(sum(window));
+            mins.push_back(minimum(window));
+            maxs.push_back(maximum(window));
+        }
+        assert(rolling_sum(w, ys) == sums);
+        assert(rolling_min(w, ys) == mins);
+        assert(rolling_max(w, ys) == maxs);
+    }
+}
+
+std::size_t profiling_test_allocated_bytes = 0;
+std::size_t profiling_test_allocated_bytes_counter()
+{
+    return profiling_test_allocated_bytes;
+}
+
+std::size_t profiling_test_evaluations = 0;
+std::size_t profiling_test_count_evaluation()
+{
+    return ++profiling_test_evaluations;
+}
+
+void Test_Profiling()
+{
+    using namespace fplus;
+    typedef std::vector<int> IntVector;
+
+    // Without FPLUS_PROFILE the probes do not evaluate their arguments
+    // and nothing is recorded.
+    {
+        FPLUS_PROFILE_SCOPE(profiling_test_count_evaluation());
+        FPLUS_PROFILE_OUTPUT(profiling_test_count_evaluation());
+    }
+    assert(profiling_test_evaluations == (profiling_enabled() ? 2u : 0u));
+    default_profile_collector().clear();
+    const auto sorted = sort(IntVector({3,1,2}));
+    assert(sorted == IntVector({1,2,3}));
+    const auto sortEvents = default_profile_collector().events();
+    assert(sortEvents.empty() != profiling_enabled());
+    if (profiling_enabled())
+    {
+        assert(std::string(sortEvents.back().name) == "sort");
+        assert(sortEvents.back().inputSize == 3);
+        assert(sortEvents.back().outputSize == 3);
+    }
+    default_profile_collector().clear();
+
+    // Every stage of a composed pipeline records its own event.
+    auto isEven = [](int x) { return x % 2 == 0; };
+    const auto counts = count_by_key(isEven,
+        set_intersection(IntVector({1,2,3,4}), IntVector({2,3,4,5})));
+    assert(counts.size() == 2);
+    assert(deserialize<IntVector>(serialize(sorted)) == just(sorted));
+    typedef std::vector<std::string> Strings;
+    const auto stageNames = transform_convert<Strings>(
+        [](const profile_event& e) { return std::string(e.name); },
+        default_profile_collector().events());
+    if (profiling_enabled())
+    {
+        assert(contains(std::string("set_intersection"), stageNames));
+        assert(contains(std::string("count_by_key"), stageNames));
+        assert(contains(std::string("group_fold_on"), stageNames));
+        assert(contains(std::string("serialize"), stageNames));
+        assert(contains(std::string("deserialize"), stageNames));
+    }
+    else
+        assert(stageNames.empty());
+    default_profile_collector().clear();
+
+    profile_collector collector;
+    collector.set_allocated_bytes_counter(profiling_test_allocated_bytes_counter);
+    {
+        profile_probe outer("outer", 10, collector);
+        {
+            profile_probe inner("inner", 10, collector);
+            profiling_test_allocated_bytes += 64;
+            inner.set_output_size(5);
+        }
+        outer.set_output_size(1);
+    }
+    std::thread([&]() { profile_probe other("inner", 2, collector); }).join();
+    const auto events = collector.events();
+    assert(events.size() == 3);
+    assert(std::string(events[0].name) == "inner");
+    assert(events[0].outputSize == 5);
+    assert(events[0].allocatedBytes == 64);
+    assert(std::string(events[1].name) == "outer");
+    assert(events[1].inputSize == 10);
+    assert(events[1].allocatedBytes == 64);
+    assert(events[1].startNs <= events[0].startNs);
+    assert(events[1].durationNs >= events[0].durationNs);
+    assert(events[0].thread == events[1].thread);
+    assert(events[2].thread != events[0].thread);
+    assert(events[2].allocatedBytes == 0);
+
+    std::string json = collector.chrome_trace_json();
+    assert(is_prefix_of(std::string("{\"traceEvents\":["), json));
+    assert(is_infix_of(std::string("\"name\":\"outer\""), json));
+    assert(is_infix_of(std::string("\"ph\":\"X\""), json));
+    assert(is_infix_of(std::string("\"allocated_bytes\":64"), json));
+    std::string summary = collector.summary();
+    assert(split_lines(summary, false).size() == 3);
+    assert(is_prefix_of(std::string("function "), summary));
+    assert(is_infix_of(std::string("\ninner "), summary));
+    assert(is_infix_of(std::string("\nouter "), summary));
+    collector.clear();
+    assert(collector.events().empty());
+}
+
+void Test_CopyAudit()
+{
+    using namespace fplus;
+    typedef std::vector<int> IntVector;
+    const auto xs = generate_by_idx<IntVector>(
+        [](std::size_t i) { return static_cast<int>(i % 10); }, 100);
+    auto isZero = [](int x) { return x == 0; };
+    auto isNine = [](int x) { return x == 9; };
+
+    default_copy_audit_log().clear();
+    default_copy_audit_log().set_threshold(50);
+    {
+        copy_budget budget(2);
+        assert(trim_right(isNine, xs).size() == 99);
+        assert(find_last_by(isZero, xs) == just(0));
+        assert(budget.exceeded() == copy_audit_enabled());
+        assert(budget.copies() == (copy_audit_enabled() ? 3u : 0u));
+    }
+    {
+        copy_budget budget(0);
+        assert(sort(IntVector({3,1,2})) == IntVector({1,2,3}));
+        assert(!budget.exceeded());
+    }
+    {
+        // The generic sort_radix copies its input once, into a vector.
+        copy_budget budget(1);
+        const auto sortedDeque = sort_radix(convert_container<std::deque<int>>(xs));
+        assert(sortedDeque.front() == 0 && sortedDeque.back() == 9);
+        assert(!budget.exceeded());
+        assert(budget.copies() == (copy_audit_enabled() ? 1u : 0u));
+    }
+    if (copy_audit_enabled())
+    {
+        const auto entries = default_copy_audit_log().entries();
+        assert(entries.at("trim_right > reverse").copies == 2);
+        assert(entries.at("find_last_by > reverse").copies == 1);
+    }
+    else
+        assert(default_copy_audit_log().entries().empty());
+    default_copy_audit_log().clear();
+    default_copy_audit_log().set_threshold(1024);
+
+    copy_audit_log log;
+    log.set_threshold(10);
+    {
+        copy_budget budget(1, 150);
+        log.record("sort", xs);
+        log.record("sort", IntVector(5));
+        {
+            copy_audit_scope scope("median");
+            log.record("sort", xs);
+            log.record("median", xs);
+        }
+        assert(budget.copies() == 3);
+        assert(budget.elements() == 300);
+        assert(budget.exceeded());
+    }
+    const auto entries = log.entries();
+    assert(entries.size() == 3);
+    assert(entries.at("sort").copies == 1);
+    assert(entries.at("sort").bytes == 100 * sizeof(int));
+    assert(entries.at("median > sort").elements == 100);
+    assert(entries.at("median").copies == 1);
+    std::string report = log.report();
+    assert(is_prefix_of(std::string("function "), report));
+    assert(is_infix_of(std::string("\nmedian > sort "), report));
+    assert(split_lines(report, false).size() == 4);
+    log.clear();
+    assert(log.entries().empty());
+}
+
+void Test_StringPool()
+{
+    using namespace fplus;
+    typedef std::vector<std::string> StringVector;
+    typedef std::vector<string_pool::id_type> Ids;
+
+    string_pool pool;
+    assert(pool.empty());
+    const auto get = pool.intern("GET");
+    const auto post = pool.intern(std::string("POST"));
+    assert(get == 0 && post == 1);
+    assert(pool.intern("GET") == get);
+    assert(pool.intern("") == 2);
+    assert(pool.size() == 3);
+    assert(pool.str(post) == "POST");
+    assert(pool.length(get) == 3);
+    assert(pool.lookup("POST") == post);
+    assert(pool.lookup("PUT") == string_pool::no_id());
+    for (std::size_t i = 0; i < 1000; ++i)
+        assert(pool.intern(show(i)) == i + 3);
+    assert(pool.lookup("999") == 1002);
+    assert(pool.str(get) == "GET");
+    assert(pool.memory_usage() > 0);
+
+    const std::string text = "How are you? How   are they?";
+    string_pool words;
+    const Ids wordIds = split_words_interned(words, text);
+    assert(wordIds == Ids({0,1,2,0,1,3}));
+    assert(unintern(words, wordIds) ==
+        (split_words<std::string, StringVector>(text)));
+    assert(split_words_interned(words, "") == Ids());
+    assert(split_words_interned(words, " are ") == Ids({1}));
+
+    typedef std::map<string_pool::id_type, std::size_t> IdCounts;
+    assert(count_occurrences(wordIds) == IdCounts({{0,2},{1,2},{2,1},{3,1}}));
+    Ids sortedIds = sort(wordIds);
+    assert((group<Ids, std::vector<Ids>>(sortedIds)) ==
+        std::vector<Ids>({{0,0},{1,1},{2},{3}}));
+
+    for (bool allowEmpty : {false, true})
+    {
+        for (const std::string lines : {"a\nb\r\n\nc\rb", "\n", "", "x\r"})
+        {
+            string_pool linePool;
+            assert(unintern(linePool, split_lines_interned(linePool, lines, allowEmpty)) ==
+                (split_lines<std::string, StringVector>(lines, allowEmpty)));
+        }
+        for (const std::string parts : {"a, b, , a", ", a, ", "", "a, , , b"})
+        {
+            string_pool partPool;
+            assert(unintern(partPool, split_by_token_interned(partPool, ", ", allowEmpty, parts)) ==
+                (split_by_token<std::string, StringVector>(", ", allowEmpty, parts)));
+        }
+    }
+    assert((split_by_token<std::string, StringVector>(",", false, "a,,b,")) ==
+        StringVector({"a","b"}));
+    assert((split_by_token<std::string, StringVector>(",", true, "a,,b,")) ==
+        StringVector({"a","","b",""}));
+}
+
+void Test_Serialization()
+{
+    using namespace fplus;
+    typedef std::vector<int> IntVector;
+    typedef std::map<std::string, std::size_t> StringSizeTMap;
+    typedef std::unordered_map<int, std::string> IntStringUnorderedMap;
+    typedef std::pair<std::string, IntVector> StringIntVectorPair;
+    typedef std::vector<std::vector<std::string>> StringVectors;
+
+    IntVector xs = {1,2,2,3,2};
+    assert(deserialize<IntVector>(serialize(xs)) == just(xs));
+    assert(deserialize<IntVector>(serialize(IntVector())) == just(IntVector()));
+    assert(deserialize<std::string>(serialize(std::string("hello")))
+        == just(std::string("hello")));
+    assert(deserialize<double>(serialize(1.5)) == just(1.5));
+
+    auto occurrences = count_occurrences(
+        split_words(std::string("a b c a b a")));
+    assert(deserialize<StringSizeTMap>(serialize(occurrences))
+        == just(occurrences));
+    IntStringUnorderedMap intStringUnorderedMap = {{1, "2"}, {4, "53"}};
+    assert(deserialize<IntStringUnorderedMap>(serialize(intStringUnorderedMap))
+        == just(intStringUnorderedMap));
+    StringIntVectorPair stringIntVectorPair = std::make_pair("xs", xs);
+    assert(deserialize<StringIntVectorPair>(serialize(stringIntVectorPair))
+        == just(stringIntVectorPair));
+    StringVectors stringVectors = {{"a", "bc"}, {}, {""}};
+    assert(deserialize<StringVectors>(serialize(stringVectors))
+        == just(stringVectors));
+    assert(deserialize<maybe<int>>(serialize(just(42))) == just(just(42)));
+    assert(deserialize<maybe<int>>(serialize(nothing<int>()))
+        == just(nothing<int>()));
+    std::vector<bool> bools = {true, false, true};
+    assert(deserialize<std::vector<bool>>(serialize(bools)) == just(bools));
+
+    auto bytes = serialize(xs);
+    auto truncated = bytes;
+    truncated.pop_back();
+    assert(is_nothing(deserialize<IntVector>(truncated)));
+    auto trailing = bytes;
+    trailing.push_back(0);
+    assert(is_nothing(deserialize<IntVector>(trailing)));
+    auto otherVersion = bytes;
+    otherVersion[4] = serialization_format_version + 1;
+    assert(is_nothing(deserialize<IntVector>(otherVersion)));
+    assert(is_nothing(deserialize<IntVector>(serialized_bytes())));
+    auto hugeCount = serialize(IntVector());
+    hugeCount[8] = 0xff;
+    assert(is_nothing(deserialize<IntVector>(hugeCount)));
+}
+
 void Test_StringTools()
 {
     using namespace fplus;
@@ -656,6 +1962,47 @@ void Test_StringTools()
     assert(split_lines(text, false)
             == textAsLinesWithoutEmpty);
     assert(split_words(text) == textAsWords);
+
+    std::wstring wideText = L" Hi,\nyou\r\n";
+    assert(split_words(wideText) == std::list<std::wstring>({L"Hi", L"you"}));
+    assert(trim_whitespace(wideText) == L"Hi,\nyou");
+    assert(to_upper_case(std::string("Hello, World! 1")) == "HELLO, WORLD! 1");
+    assert(to_lower_case(std::string("Hello, World! 1")) == "hello, world! 1");
+    assert(to_upper_case(wideText) == L" HI,\nYOU\r\n");
+
+    // The std::string fast paths must match the generic definitions
+    // for all bytes, including non-ASCII ones, at all block boundaries.
+    typedef std::vector<std::string> StringVector;
+    const std::string alphabet = std::string("aZ09 \t\n\r\v\f_-.,\x7f\x80\xe4\xff") +
+        std::string(1, '\0') + "@[`{/:";
+    std::srand(47);
+    auto isNoLetterOrDigit = [](char c) { return !is_letter_or_digit<std::string>(c); };
+    for (std::size_t size : {0, 1, 15, 16, 17, 63, 64, 65, 130, 1000})
+    {
+        for (std::size_t run = 0; run < 20; ++run)
+        {
+            const std::string str = generate<std::string>([&]() -> char
+                { return alphabet[static_cast<std::size_t>(std::rand()) % alphabet.size()]; }, size);
+            assert((split_words<std::string, StringVector>(str)) ==
+                (split_by<decltype(isNoLetterOrDigit), std::string, StringVector>(
+                    isNoLetterOrDigit, false, str)));
+            for (bool allowEmpty : {false, true})
+                assert((split_lines<std::string, StringVector>(str, allowEmpty)) ==
+                    (split_by<decltype(&is_line_break<std::string>), std::string, StringVector>(
+                        is_line_break<std::string>, allowEmpty, clean_newlines(str))));
+            assert(trim_whitespace_left(str) == trim_left(is_whitespace<std::string>, str));
+            assert(trim_whitespace_right(str) == trim_right(is_whitespace<std::string>, str));
+            assert(trim_whitespace(str) == trim(is_whitespace<std::string>, str));
+            const std::string upper = to_upper_case(str);
+            const std::string lower = to_lower_case(str);
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                const char c = str[i];
+                assert(upper[i] == (c >= 'a' && c <= 'z' ? c - 32 : c));
+                assert(lower[i] == (c >= 'A' && c <= 'Z' ? c + 32 : c));
+            }
+        }
+    }
 }
 
 bool is_odd(int x) { return x % 2 == 1; }
@@ -697,6 +2044,96 @@ void run_n_times(std::function<std::list<int>(std::list<int>)> f,
     std::cout << name << "(check: " << lengthSum << "), elapsed time: " << elapsed_seconds.count() << "s\n";
 }
 
+// Counts the heap allocations of the whole test program,
+// so benchmarks can report them.
+// All replaceable forms of new and delete are replaced,
+// so every allocation is released by the matching deallocation function,
+// also e.g. the nothrow one of std::stable_sort's buffer.
+std::atomic<std::size_t> heap_allocation_count(0);
+
+void* counted_malloc(std::size_t size) noexcept
+{
+    ++heap_allocation_count;
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void* operator new(std::size_t size)
+{
+    if (void* p = counted_malloc(size))
+        return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    if (void* p = counted_malloc(size))
+        return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return counted_malloc(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return counted_malloc(size);
+}
+
+// GCC does not know that the replaced operator new uses malloc.
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept
+{
+    std::free(p);
+}
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic pop
+#endif
+
+template <typename F>
+void run_timed(F f, std::size_t n, const std::string& name)
+{
+    typedef std::chrono::time_point<std::chrono::system_clock> Time;
+    Time startTime = std::chrono::system_clock::now();
+    std::size_t check = 0;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        check += f();
+    }
+    Time endTime = std::chrono::system_clock::now();
+    std::chrono::duration<double> elapsed_seconds = endTime - startTime;
+    std::cout << name << "(check: " << check << "), elapsed time: " << elapsed_seconds.count() << "s\n";
+}
+
 void Test_example_KeepIf_performance()
 {
     using namespace fplus;
@@ -737,6 +2174,834 @@ void Test_example_KeepIf_performance()
 
 
 
+void Test_example_ShowCont_performance()
+{
+    using namespace fplus;
+    typedef std::vector<int> Ints;
+    Ints numbers = generate<Ints>(rand, 100000);
+
+    auto run_stringstream_per_elem = [&]() -> std::size_t
+    {
+        std::vector<std::string> strs;
+        for (int x : numbers)
+        {
+            std::ostringstream ss;
+            ss << x;
+            strs.push_back(ss.str());
+        }
+        return (std::string("[") + join(std::string(", "), strs) + "]").size();
+    };
+    auto run_FunctionalPlus = [&]() -> std::size_t
+        { return show_cont(numbers).size(); };
+    auto run_FunctionalPlus_stream = [&]() -> std::size_t
+    {
+        std::ostringstream ss;
+        write_cont(ss, numbers);
+        return ss.str().size();
+    };
+
+    run_timed(run_stringstream_per_elem, 10, "ostringstream per element + join");
+    run_timed(run_FunctionalPlus, 10, "FunctionalPlus::show_cont");
+    run_timed(run_FunctionalPlus_stream, 10, "FunctionalPlus::write_cont");
+}
+
+void Test_example_Deserialize_performance()
+{
+    using namespace fplus;
+    typedef std::vector<int> Ints;
+    typedef std::map<int, int> IntIntMap;
+    Ints numbers = generate<Ints>(rand, 200000);
+    IntIntMap dict = create_map(numbers, numbers);
+
+    const std::string numbersText = show_cont_with(" ", numbers);
+    const auto numbersBytes = serialize(numbers);
+    std::ostringstream dictTextStream;
+    for (const auto& keyAndVal : dict)
+        dictTextStream << keyAndVal.first << " " << keyAndVal.second << " ";
+    const std::string dictText = dictTextStream.str();
+    const auto dictBytes = serialize(dict);
+
+    auto parse_numbers_text = [&]() -> std::size_t
+    {
+        std::istringstream ss(numbersText.substr(1, numbersText.size() - 2));
+        Ints result;
+        int x;
+        while (ss >> x)
+            result.push_back(x);
+        return result.size();
+    };
+    auto parse_dict_text = [&]() -> std::size_t
+    {
+        std::istringstream ss(dictText);
+        IntIntMap result;
+        int key, val;
+        while (ss >> key >> val)
+            result[key] = val;
+        return result.size();
+    };
+    auto load_numbers = [&]() -> std::size_t
+        { return unsafe_get_just(deserialize<Ints>(numbersBytes)).size(); };
+    auto load_dict = [&]() -> std::size_t
+        { return unsafe_get_just(deserialize<IntIntMap>(dictBytes)).size(); };
+
+    run_timed(parse_numbers_text, 10, "vector<int> text parsing");
+    run_timed(load_numbers, 10, "vector<int> FunctionalPlus::deserialize");
+    run_timed(parse_dict_text, 10, "map<int, int> text parsing");
+    run_timed(load_dict, 10, "map<int, int> FunctionalPlus::deserialize");
+}
+
+std::uint64_t slow_collatz_length(std::uint64_t x)
+{
+    std::uint64_t length = 1;
+    for (int i = 0; i < 20; ++i)
+    {
+        for (std::uint64_t y = x + static_cast<std::uint64_t>(i); y > 1; ++length)
+            y = y % 2 == 0 ? y / 2 : 3 * y + 1;
+    }
+    return length;
+}
+
+void Test_example_Memoize_performance()
+{
+    using namespace fplus;
+    typedef std::vector<std::uint64_t> Ints;
+    const std::size_t threadCount = 4;
+    Ints numbers = transform(
+        [](int x) -> std::uint64_t { return static_cast<std::uint64_t>(x % 1000 + 1); },
+        generate<std::vector<int>>(rand, 50000));
+
+    auto run_on_threads = [&](auto f) -> std::size_t
+    {
+        std::vector<std::thread> threads;
+        std::vector<std::uint64_t> results(threadCount, 0);
+        for (std::size_t t = 0; t < threadCount; ++t)
+        {
+            threads.emplace_back([&, t]()
+            {
+                for (std::uint64_t x : numbers)
+                    results[t] += f(x);
+            });
+        }
+        for (auto& thread : threads)
+            thread.join();
+        return static_cast<std::size_t>(sum(results));
+    };
+
+    auto run_plain = [&]() -> std::size_t
+        { return run_on_threads(slow_collatz_length); };
+    auto memo = memoize(slow_collatz_length);
+    auto run_memoized = [&]() -> std::size_t
+        { return run_on_threads(memo); };
+    auto memoLru = memoize_lru(1024, slow_collatz_length);
+    auto run_memoized_lru = [&]() -> std::size_t
+        { return run_on_threads(memoLru); };
+
+    run_timed(run_plain, 1, "4 threads, not memoized");
+    run_timed(run_memoized, 1, "4 threads, FunctionalPlus::memoize");
+    run_timed(run_memoized_lru, 1, "4 threads, FunctionalPlus::memoize_lru(1024)");
+    std::cout << "memoize hits: " << memo.hits() << ", misses: " << memo.misses() << std::endl;
+}
+
+void Test_example_TransformParallelly_performance()
+{
+    using namespace fplus;
+    typedef std::vector<double> Doubles;
+    typedef std::vector<Doubles> Doubless;
+    const std::size_t threadCount = default_work_stealing_pool().size();
+
+    // Few huge and many tiny inner containers, the huge ones clustered,
+    // so static partitioning leaves most threads idle.
+    auto data = generate_by_idx<Doubless>([](std::size_t i) -> Doubles
+    {
+        return Doubles(i < 8 ? 400000 : 10, static_cast<double>(i % 7) + 1.0);
+    }, 4000);
+    auto process = [](const Doubles& xs)
+    {
+        Doubles result;
+        result.reserve(xs.size());
+        for (double x : xs)
+            result.push_back(std::sqrt(x * 3.0) + std::log(x + 1.0));
+        return result;
+    };
+
+    auto run_static_partitioning = [&]() -> std::size_t
+    {
+        std::vector<Doubles> results(data.size());
+        std::vector<std::thread> threads;
+        const std::size_t chunkSize = (data.size() + threadCount - 1) / threadCount;
+        for (std::size_t t = 0; t < threadCount; ++t)
+        {
+            threads.emplace_back([&, t]()
+            {
+                const std::size_t end = std::min(data.size(), (t + 1) * chunkSize);
+                for (std::size_t i = t * chunkSize; i < end; ++i)
+                    results[i] = process(data[i]);
+            });
+        }
+        for (auto& thread : threads)
+            thread.join();
+        return concat(results).size();
+    };
+    auto run_sequential = [&]() -> std::size_t
+        { return transform_and_concat(process, data).size(); };
+    auto run_work_stealing = [&]() -> std::size_t
+        { return transform_and_concat_parallelly(process, data).size(); };
+
+    run_timed(run_sequential, 3, "FunctionalPlus::transform_and_concat");
+    run_timed(run_static_partitioning, 3, "static partitioning on " + show(threadCount) + " threads");
+    run_timed(run_work_stealing, 3, "FunctionalPlus::transform_and_concat_parallelly");
+}
+
+void Test_example_SortRadix_performance()
+{
+    using namespace fplus;
+    typedef std::vector<std::uint32_t> UInts;
+    std::srand(1);
+    auto randomUInt = []() { return static_cast<std::uint32_t>(std::rand()) * 2654435761u; };
+    const UInts ids = generate<UInts>(randomUInt, 2000000);
+    const auto timestamps = transform([](std::uint32_t x)
+        { return static_cast<std::int64_t>(1500000000000LL + x); }, ids);
+    const auto values = transform([](std::uint32_t x)
+        { return static_cast<double>(x) / 1e3 - 2e6; }, ids);
+    const auto words = transform([](std::uint32_t x)
+        { return "key_" + show(x % 1000000); }, take(300000, ids));
+
+    auto sum_of_firsts = [](const auto& xs) -> std::size_t
+        { return static_cast<std::size_t>(xs[0]) + static_cast<std::size_t>(xs[xs.size() / 2]); };
+    auto std_sorted = [](auto xs)
+    {
+        std::sort(std::begin(xs), std::end(xs));
+        return xs;
+    };
+
+    run_timed([&]() { return sum_of_firsts(std_sorted(ids)); }, 1, "std::sort 2M uint32");
+    run_timed([&]() { return sum_of_firsts(sort_radix(ids)); }, 1, "FunctionalPlus::sort_radix 2M uint32");
+    run_timed([&]() { return sum_of_firsts(std_sorted(timestamps)); }, 1, "std::sort 2M int64 timestamps");
+    run_timed([&]() { return sum_of_firsts(sort_radix(timestamps)); }, 1, "FunctionalPlus::sort_radix 2M int64 timestamps");
+    run_timed([&]() { return sum_of_firsts(std_sorted(values)); }, 1, "std::sort 2M double");
+    run_timed([&]() { return sum_of_firsts(sort_radix(values)); }, 1, "FunctionalPlus::sort_radix 2M double");
+    run_timed([&]() { return std_sorted(words)[0].size(); }, 1, "std::sort 300k strings");
+    run_timed([&]() { return sort_radix(words)[0].size(); }, 1, "FunctionalPlus::sort_radix 300k strings");
+}
+
+void Test_example_SortOn_performance()
+{
+    using namespace fplus;
+    typedef std::vector<std::string> Strings;
+    std::srand(3);
+    auto randomLine = []() { return "id=" + show(std::rand()) + ";value=" + show(std::rand() % 1000); };
+    const Strings lines = generate<Strings>(randomLine, 100000);
+    // deliberately expensive key: parse a field out of the string
+    auto parseValue = [](const std::string& line)
+    {
+        const auto pos = line.find(";value=");
+        return std::stoi(line.substr(pos + 7)) * 1000000 + std::stoi(line.substr(3, pos - 3)) % 1000000;
+    };
+    auto run_sort_by = [&]() -> std::size_t
+    {
+        auto lessByValue = [&](const std::string& a, const std::string& b)
+            { return parseValue(a) < parseValue(b); };
+        return sort_by(lessByValue, lines).front().size();
+    };
+    auto run_sort_on = [&]() -> std::size_t
+        { return sort_on(parseValue, lines).front().size(); };
+
+    run_timed(run_sort_by, 1, "FunctionalPlus::sort_by with parsing comparator");
+    run_timed(run_sort_on, 1, "FunctionalPlus::sort_on with parsing key");
+}
+
+void Test_example_GroupFoldOn_performance()
+{
+    using namespace fplus;
+    typedef std::vector<int> Ints;
+    std::srand(5);
+    const Ints numbers = generate<Ints>(std::rand, 2000000);
+    auto key = [](int x) { return x % 10007; };
+    auto add = [](std::int64_t acc, int x) { return acc + x; };
+
+    auto run_sort_group_fold = [&]() -> std::size_t
+    {
+        auto groups = group_on(key, sort_on(key, numbers));
+        auto sums = transform([&](const Ints& group)
+            { return fold_left(add, std::int64_t(0), group); }, groups);
+        return static_cast<std::size_t>(sum(sums));
+    };
+    auto sum_vals = [](const std::unordered_map<int, std::int64_t>& dict)
+    {
+        std::int64_t result = 0;
+        for (const auto& keyAndVal : dict)
+            result += keyAndVal.second;
+        return static_cast<std::size_t>(result);
+    };
+    auto run_group_fold_on = [&]() -> std::size_t
+        { return sum_vals(group_fold_on(key, add, std::int64_t(0), numbers)); };
+    auto run_group_fold_on_parallelly = [&]() -> std::size_t
+    {
+        auto merge = [](std::int64_t a, std::int64_t b) { return a + b; };
+        return sum_vals(group_fold_on_parallelly(key, add, merge, std::int64_t(0), numbers));
+    };
+
+    run_timed(run_sort_group_fold, 1, "FunctionalPlus::sort_on + group_on + fold_left");
+    run_timed(run_group_fold_on, 1, "FunctionalPlus::group_fold_on");
+    run_timed(run_group_fold_on_parallelly, 1, "FunctionalPlus::group_fold_on_parallelly");
+}
+
+void Test_example_Joins_performance()
+{
+    using namespace fplus;
+    typedef std::pair<int, int> IntPair;
+    typedef std::vector<IntPair> IntPairs;
+    const std::size_t count = 1000000;
+    std::srand(7);
+    auto make_rows = [&](int salt)
+    {
+        return generate_by_idx<IntPairs>([salt](std::size_t i) -> IntPair
+        {
+            const int id = static_cast<int>((i * 2654435761u + static_cast<std::size_t>(salt)) % 1500000);
+            return IntPair(id, static_cast<int>(i));
+        }, count);
+    };
+    const IntPairs as = make_rows(0);
+    const IntPairs bs = make_rows(17);
+    auto key = [](const IntPair& p) { return p.first; };
+    auto sum_snds = [](const IntPair& a, const IntPair& b) { return a.second + b.second; };
+
+    auto run_map_lookup = [&]() -> std::size_t
+    {
+        auto dict = create_map(transform(key, bs), transform([](const IntPair& p) { return p.second; }, bs));
+        std::size_t matches = 0;
+        for (const auto& a : as)
+        {
+            auto b = get_from_map(dict, a.first);
+            if (is_just(b))
+                matches += static_cast<std::size_t>(a.second + unsafe_get_just(b)) % 2;
+        }
+        return matches;
+    };
+    auto run_hash_join = [&]() -> std::size_t
+        { return sum(transform([](int x) { return static_cast<std::size_t>(x) % 2; }, join_on_with(sum_snds, key, key, as, bs))); };
+    const IntPairs asSorted = sort_on(key, as);
+    const IntPairs bsSorted = sort_on(key, bs);
+    auto run_merge_join = [&]() -> std::size_t
+        { return sum(transform([](int x) { return static_cast<std::size_t>(x) % 2; }, join_on_with_sorted(sum_snds, key, key, asSorted, bsSorted))); };
+
+    run_timed(run_map_lookup, 1, "create_map + get_from_map 1M x 1M");
+    run_timed(run_hash_join, 1, "FunctionalPlus::join_on_with 1M x 1M");
+    run_timed(run_merge_join, 1, "FunctionalPlus::join_on_with_sorted 1M x 1M (presorted)");
+}
+
+void Test_example_Sets_performance()
+{
+    using namespace fplus;
+    typedef std::vector<int> Ints;
+    auto evens = generate_by_idx<Ints>([](std::size_t i) { return static_cast<int>(2 * i); }, 2000000);
+    auto threes = generate_by_idx<Ints>([](std::size_t i) { return static_cast<int>(3 * i); }, 1000000);
+    auto fews = generate_by_idx<Ints>([](std::size_t i) { return static_cast<int>(997 * i); }, 1000);
+
+    auto run_keep_if_contains = [&]() -> std::size_t
+    {
+        const Ints someEvens = take(50, evens);
+        return keep_if([&](int x) { return contains(x, threes); }, someEvens).size();
+    };
+    auto run_balanced = [&]() -> std::size_t
+        { return set_intersection(evens, threes).size(); };
+    auto run_skewed_std = [&]() -> std::size_t
+    {
+        Ints result;
+        std::set_intersection(fews.begin(), fews.end(), evens.begin(), evens.end(), std::back_inserter(result));
+        return result.size();
+    };
+    auto run_skewed = [&]() -> std::size_t
+        { return set_intersection(fews, evens).size(); };
+    auto run_skewed_difference = [&]() -> std::size_t
+        { return set_difference(evens, fews).size(); };
+
+    run_timed(run_keep_if_contains, 1, "keep_if(contains) 50 x 1M");
+    run_timed(run_balanced, 10, "FunctionalPlus::set_intersection 2M x 1M");
+    run_timed(run_skewed_std, 10, "std::set_intersection 1k x 2M");
+    run_timed(run_skewed, 10, "FunctionalPlus::set_intersection 1k x 2M (galloping)");
+    run_timed(run_skewed_difference, 10, "FunctionalPlus::set_difference 2M - 1k (galloping)");
+}
+
+void Test_example_SortedLookup_performance()
+{
+    using namespace fplus;
+    typedef std::vector<int> Ints;
+    const Ints table = generate_by_idx<Ints>([](std::size_t i) { return static_cast<int>(3 * i); }, 4000000);
+    std::srand(13);
+    const Ints queries = generate<Ints>([]() { return static_cast<int>(static_cast<std::int64_t>(std::rand()) * 7 % 12000000); }, 1000000);
+    const eytzinger_index<int> index(table);
+
+    auto run_linear = [&]() -> std::size_t
+    {
+        std::size_t found = 0;
+        for (std::size_t i = 0; i < 20; ++i)
+            found += is_just(find_first_idx(queries[i], table)) ? 1 : 0;
+        return found;
+    };
+    auto run_std_lower_bound = [&]() -> std::size_t
+    {
+        std::size_t idxSum = 0;
+        for (int x : queries)
+            idxSum += static_cast<std::size_t>(std::lower_bound(table.begin(), table.end(), x) - table.begin());
+        return idxSum;
+    };
+    auto run_lower_bound_idx = [&]() -> std::size_t
+    {
+        std::size_t idxSum = 0;
+        for (int x : queries)
+            idxSum += lower_bound_idx(x, table);
+        return idxSum;
+    };
+    auto run_eytzinger = [&]() -> std::size_t
+    {
+        std::size_t idxSum = 0;
+        for (int x : queries)
+            idxSum += index.lower_bound_idx(x);
+        return idxSum;
+    };
+
+    run_timed(run_linear, 1, "FunctionalPlus::find_first_idx 20 lookups in 4M");
+    run_timed(run_std_lower_bound, 1, "std::lower_bound 1M lookups in 4M");
+    run_timed(run_lower_bound_idx, 1, "FunctionalPlus::lower_bound_idx 1M lookups in 4M");
+    run_timed(run_eytzinger, 1, "FunctionalPlus::eytzinger_index 1M lookups in 4M");
+}
+
+void Test_example_FlatMap_performance()
+{
+    using namespace fplus;
+    typedef std::vector<int> Ints;
+    const std::size_t n = 1000000;
+    std::srand(17);
+    const Ints keys = generate<Ints>([]() { return std::rand(); }, n);
+    const Ints vals = generate_by_idx<Ints>([](std::size_t i) { return static_cast<int>(i); }, n);
+    const Ints queries = generate<Ints>([&keys]() -> int
+        { return std::rand() % 2 == 0 ? keys[static_cast<std::size_t>(std::rand()) % keys.size()] : std::rand(); },
+        n);
+
+    const auto stdMap = create_map(keys, vals);
+    const auto unorderedMap = create_unordered_map(keys, vals);
+    const auto flatMap = create_flat_map(keys, vals);
+    const auto flatHashMap = create_flat_hash_map(keys, vals);
+
+    auto lookup_all = [&queries](const auto& dict) -> std::size_t
+    {
+        std::size_t sum = 0;
+        for (int q : queries)
+        {
+            auto it = dict.find(q);
+            if (it != dict.end())
+                sum += static_cast<std::size_t>(it->second);
+        }
+        return sum;
+    };
+
+    run_timed([&]() { return create_map(keys, vals).size(); }, 1, "FunctionalPlus::create_map 1M");
+    run_timed([&]() { return create_unordered_map(keys, vals).size(); }, 1, "FunctionalPlus::create_unordered_map 1M");
+    run_timed([&]() { return create_flat_map(keys, vals).size(); }, 1, "FunctionalPlus::create_flat_map 1M");
+    run_timed([&]() { return create_flat_hash_map(keys, vals).size(); }, 1, "FunctionalPlus::create_flat_hash_map 1M");
+    run_timed([&]() { return lookup_all(stdMap); }, 1, "std::map 1M lookups in 1M");
+    run_timed([&]() { return lookup_all(unorderedMap); }, 1, "std::unordered_map 1M lookups in 1M");
+    run_timed([&]() { return lookup_all(flatMap); }, 1, "FunctionalPlus::flat_map 1M lookups in 1M");
+    run_timed([&]() { return lookup_all(flatHashMap); }, 1, "FunctionalPlus::flat_hash_map 1M lookups in 1M");
+}
+
+void Test_example_MapTransforms_performance()
+{
+    using namespace fplus;
+    typedef std::vector<int> Ints;
+    typedef std::map<int, int> IntMap;
+    typedef flat_map<int, int> IntFlatMap;
+    const std::size_t n = 1000000;
+    const Ints keys = generate_by_idx<Ints>([](std::size_t i) { return static_cast<int>(2 * i); }, n);
+    const Ints vals = generate_by_idx<Ints>([](std::size_t i) { return static_cast<int>(i % 1000); }, n);
+    const IntMap dict = create_map(keys, vals);
+    const IntFlatMap flatDict = create_flat_map(keys, vals);
+    const IntMap dictShifted = create_map(transform([](int k) { return k + 1; }, keys), vals);
+    const IntFlatMap flatDictShifted = create_flat_map(transform([](int k) { return k + 1; }, keys), vals);
+
+    auto old_get_map_keys = [&]() -> std::size_t
+    {
+        auto pairs = map_to_pairs(dict);
+        return transform(fst<int, int>, map_to_pairs(dict)).size() + pairs.size();
+    };
+    auto double_val = [](int x) { return 2 * x; };
+    auto via_pairs_transform = [&]() -> std::size_t
+    {
+        auto pairs = transform([&](const std::pair<int, int>& p)
+            { return std::make_pair(p.first, double_val(p.second)); }, map_to_pairs(dict));
+        return pairs_to_map<IntMap>(pairs).size();
+    };
+    auto is_even = [](int k) { return k % 4 == 0; };
+
+    run_timed(old_get_map_keys, 1, "map_to_pairs twice + transform 1M (get_map_keys before)");
+    run_timed([&]() { return get_map_keys(dict).size(); }, 1, "FunctionalPlus::get_map_keys std::map 1M");
+    run_timed([&]() -> std::size_t
+        {
+            std::size_t keySum = 0;
+            for (int k : map_keys_view(dict))
+                keySum += static_cast<std::size_t>(k);
+            return keySum;
+        }, 1, "FunctionalPlus::map_keys_view std::map 1M summed");
+    run_timed([&]() { return get_map_values(flatDict).size(); }, 1, "FunctionalPlus::get_map_values flat_map 1M");
+    run_timed([&]() { return swap_keys_and_values(dict).size(); }, 1, "FunctionalPlus::swap_keys_and_values std::map 1M");
+    run_timed([&]() { return swap_keys_and_values(flatDict).size(); }, 1, "FunctionalPlus::swap_keys_and_values flat_map 1M");
+    run_timed(via_pairs_transform, 1, "map_to_pairs + transform + pairs_to_map std::map 1M");
+    run_timed([&]() { return transform_map_values(double_val, dict).size(); }, 1, "FunctionalPlus::transform_map_values std::map 1M");
+    run_timed([&]() { return transform_map_values(double_val, flatDict).size(); }, 1, "FunctionalPlus::transform_map_values flat_map 1M");
+    run_timed([&]() { return map_keep_if(is_even, dict).size(); }, 1, "FunctionalPlus::map_keep_if std::map 1M");
+    run_timed([&]() { return map_keep_if(is_even, flatDict).size(); }, 1, "FunctionalPlus::map_keep_if flat_map 1M");
+    run_timed([&]() { return map_union_with(std::plus<int>(), dict, dictShifted).size(); }, 1, "FunctionalPlus::map_union_with std::map 1M + 1M");
+    run_timed([&]() { return map_union_with(std::plus<int>(), flatDict, flatDictShifted).size(); }, 1, "FunctionalPlus::map_union_with flat_map 1M + 1M");
+}
+
+void Test_example_StringKeyLookup_performance()
+{
+    using namespace fplus;
+    typedef std::vector<std::string> Strings;
+    typedef std::vector<int> Ints;
+    const std::size_t n = 100000;
+    const Strings keys = generate_by_idx<Strings>([](std::size_t i) -> std::string
+        { return "a_key_longer_than_small_string_" + std::to_string(i * 7919 % n); }, n);
+    const Ints vals = generate_by_idx<Ints>([](std::size_t i) { return static_cast<int>(i); }, n);
+    std::vector<const char*> queries;
+    for (std::size_t i = 0; i < 3 * n; ++i)
+        queries.push_back(keys[i * 31 % n].c_str());
+
+    const auto stdMap = create_map(keys, vals);
+    const auto transparentMap = create_map<Strings, Ints, std::string, int,
+        std::map<std::string, int, std::less<>>>(keys, vals);
+    const auto flatMap = create_flat_map<Strings, Ints, std::string, int,
+        flat_map<std::string, int, std::less<>>>(keys, vals);
+    const auto unorderedMap = create_unordered_map(keys, vals);
+    const auto flatHashMap = create_flat_hash_map<Strings, Ints, std::string, int,
+        flat_hash_map<std::string, int, string_hash, std::equal_to<>>>(keys, vals);
+
+    auto sum_via_get_ptr = [&queries](const auto& dict) -> std::size_t
+    {
+        std::size_t sum = 0;
+        for (const char* q : queries)
+            sum += static_cast<std::size_t>(*get_ptr_from_map(dict, q));
+        return sum;
+    };
+    auto sum_via_contains_and_get = [&queries](const auto& dict) -> std::size_t
+    {
+        std::size_t sum = 0;
+        for (const char* q : queries)
+        {
+            const std::string key(q);
+            if (map_contains(dict, key))
+                sum += static_cast<std::size_t>(unsafe_get_just(get_from_map(dict, key)));
+        }
+        return sum;
+    };
+
+    run_timed([&]() { return sum_via_contains_and_get(stdMap); }, 1, "std::map<std::string> map_contains + get_from_map 300k");
+    run_timed([&]() { return sum_via_get_ptr(stdMap); }, 1, "std::map<std::string> get_ptr_from_map const char* 300k");
+    run_timed([&]() { return sum_via_get_ptr(transparentMap); }, 1, "std::map<std::string, std::less<>> get_ptr_from_map const char* 300k");
+    run_timed([&]() { return sum_via_get_ptr(flatMap); }, 1, "FunctionalPlus::flat_map<std::string, std::less<>> get_ptr_from_map const char* 300k");
+    run_timed([&]() { return sum_via_contains_and_get(unorderedMap); }, 1, "std::unordered_map<std::string> map_contains + get_from_map 300k");
+    run_timed([&]() { return sum_via_get_ptr(unorderedMap); }, 1, "std::unordered_map<std::string> get_ptr_from_map const char* 300k");
+    run_timed([&]() { return sum_via_get_ptr(flatHashMap); }, 1, "FunctionalPlus::flat_hash_map<std::string, string_hash> get_ptr_from_map const char* 300k");
+
+    typedef std::map<int, std::vector<int>> BigValMap;
+    BigValMap bigValMap;
+    for (int i = 0; i < 1000; ++i)
+        get_from_map_or_insert(bigValMap, i, Ints(100, i));
+    auto sum_big_copy = [&]() -> std::size_t
+    {
+        std::size_t sum = 0;
+        for (std::size_t i = 0; i < 100000; ++i)
+            sum += unsafe_get_just(get_from_map(bigValMap, static_cast<int>(i % 1000))).size();
+        return sum;
+    };
+    auto sum_big_ptr = [&]() -> std::size_t
+    {
+        std::size_t sum = 0;
+        for (std::size_t i = 0; i < 100000; ++i)
+            sum += get_ptr_from_map(bigValMap, static_cast<int>(i % 1000))->size();
+        return sum;
+    };
+    run_timed(sum_big_copy, 1, "FunctionalPlus::get_from_map 100-int vector values 100k");
+    run_timed(sum_big_ptr, 1, "FunctionalPlus::get_ptr_from_map 100-int vector values 100k");
+}
+
+void Test_example_SoaVector_performance()
+{
+    using namespace fplus;
+    typedef std::vector<double> Doubles;
+    const std::size_t n = 2000000;
+    const Doubles prices = generate_by_idx<Doubles>([](std::size_t i) { return static_cast<double>(i % 1000) * 0.5; }, n);
+    const Doubles amounts = generate_by_idx<Doubles>([](std::size_t i) { return static_cast<double>(i % 7); }, n);
+    typedef std::pair<double, double> DoublePair;
+    const auto pairs = zip(prices, amounts);
+    const auto soa = zip_to_soa(prices, amounts);
+
+    auto check_sum = [](const Doubles& xs) { return static_cast<std::size_t>(std::accumulate(xs.begin(), xs.end(), 0.0)); };
+
+    run_timed([&]() { return zip(prices, amounts).size(); }, 1, "FunctionalPlus::zip 2M");
+    run_timed([&]() { return zip_to_soa(prices, amounts).size(); }, 1, "FunctionalPlus::zip_to_soa 2M");
+    run_timed([&]() { return unzip(zip(prices, amounts)).first.size(); }, 1, "FunctionalPlus::zip + unzip 2M");
+    run_timed([&]() { return unzip(zip_to_soa(prices, amounts)).first.size(); }, 1, "FunctionalPlus::zip_to_soa + unzip 2M");
+    run_timed([&]() { return check_sum(transform([](const DoublePair& p) { return p.first * p.second; }, pairs)); }, 1, "FunctionalPlus::transform pairs 2M");
+    run_timed([&]() { return check_sum(transform([](double p, double a) { return p * a; }, soa)); }, 1, "FunctionalPlus::transform soa_vector 2M");
+    run_timed([&]() { return check_sum(transform([](double p) { return p * 1.19; }, transform(fst<double, double>, pairs))); }, 1, "FunctionalPlus::transform first of pairs 2M");
+    run_timed([&]() { return check_sum(transform_column<0>([](double p) { return p * 1.19; }, soa).column<0>()); }, 1, "FunctionalPlus::transform_column soa_vector 2M");
+    run_timed([&]() { return keep_if([](const DoublePair& p) { return p.second > 3.0; }, pairs).size(); }, 1, "FunctionalPlus::keep_if pairs 2M");
+    run_timed([&]() { return keep_if([](double, double a) { return a > 3.0; }, soa).size(); }, 1, "FunctionalPlus::keep_if soa_vector 2M");
+    run_timed([&]() { return sort_on([](const DoublePair& p) { return p.first; }, pairs).size(); }, 1, "FunctionalPlus::sort_on pairs 2M");
+    run_timed([&]() { return sort_on([](double p, double) { return p; }, soa).size(); }, 1, "FunctionalPlus::sort_on soa_vector 2M");
+}
+
+void Test_example_Bitvector_performance()
+{
+    using namespace fplus;
+    typedef std::vector<int> Ints;
+    const std::size_t n = 20000000;
+    const Ints xs = generate_by_idx<Ints>([](std::size_t i) { return static_cast<int>(i % 1000003); }, n);
+    auto is_small = [](int x) { return x < 1000004; };
+    auto is_rare = [](int x) { return x % 1000 == 0; };
+    const std::vector<bool> boolMask = transform(is_small, xs);
+    const bitvector bitMask = transform_to_bitvector(is_small, xs);
+    const std::vector<bool> rareBoolMask = transform(is_rare, xs);
+    const bitvector rareBitMask = transform_to_bitvector(is_rare, xs);
+
+    run_timed([&]() { return transform(is_rare, xs).size(); }, 1, "FunctionalPlus::transform to std::vector<bool> 20M");
+    run_timed([&]() { return transform_convert<bitvector>(is_rare, xs).size(); }, 1, "FunctionalPlus::transform_convert<bitvector> 20M");
+    run_timed([&]() { return transform_to_bitvector(is_rare, xs).size(); }, 1, "FunctionalPlus::transform_to_bitvector 20M");
+    run_timed([&]() -> std::size_t { return all(boolMask) ? 1 : 0; }, 1, "FunctionalPlus::all std::vector<bool> 20M");
+    run_timed([&]() -> std::size_t { return all(bitMask) ? 1 : 0; }, 1, "FunctionalPlus::all bitvector 20M");
+    run_timed([&]() { return count(true, rareBoolMask); }, 1, "FunctionalPlus::count std::vector<bool> 20M");
+    run_timed([&]() { return count(true, rareBitMask); }, 1, "FunctionalPlus::count bitvector 20M");
+    run_timed([&]() { return count(true, bitMask & rareBitMask); }, 1, "FunctionalPlus::bitvector & + count 20M");
+    run_timed([&]() { return keep_if(is_rare, xs).size(); }, 1, "FunctionalPlus::keep_if rare 20M");
+    run_timed([&]() { return keep_if_by_mask(rareBitMask, xs).size(); }, 1, "FunctionalPlus::keep_if_by_mask rare 20M");
+}
+
+void Test_example_TopK_performance()
+{
+    using namespace fplus;
+    typedef std::vector<int> Ints;
+    const std::size_t n = 10000000;
+    const std::size_t k = 100;
+    std::srand(29);
+    const Ints xs = generate<Ints>([]() { return std::rand(); }, n);
+    auto check_sum = [](const Ints& ys) { return static_cast<std::size_t>(std::accumulate(ys.begin(), ys.end(), 0ll) % 1000000007); };
+
+    run_timed([&]() { return check_sum(take(k, sort_by(std::greater<int>(), xs))); }, 1, "FunctionalPlus::take + sort_by k=100 of 10M");
+    run_timed([&]() { return check_sum(top_k(k, xs)); }, 1, "FunctionalPlus::top_k k=100 of 10M");
+    run_timed([&]() { return check_sum(top_k(n / 4, xs)); }, 1, "FunctionalPlus::top_k k=2.5M of 10M");
+    run_timed([&]() { return check_sum(top_k_on([](int x) { return x % 1000; }, k, xs)); }, 1, "FunctionalPlus::top_k_on k=100 of 10M");
+    run_timed([&]() { return check_sum(take(k, partial_sort(k, xs))); }, 1, "FunctionalPlus::partial_sort k=100 of 10M");
+
+    // unbounded stream, nothing but the accumulator is kept in memory
+    auto stream_top_k = [&]() -> std::size_t
+    {
+        top_k_accumulator<std::uint32_t> acc(k);
+        std::uint32_t state = 2463534242u;
+        for (std::size_t i = 0; i < 100000000; ++i)
+        {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            acc.push(state);
+        }
+        return static_cast<std::size_t>(std::move(acc).result().back());
+    };
+    run_timed(stream_top_k, 1, "FunctionalPlus::top_k_accumulator k=100 of 100M streamed");
+}
+
+void Test_example_Rolling_performance()
+{
+    using namespace fplus;
+    typedef std::vector<int> Ints;
+    typedef std::vector<Ints> Intss;
+    std::srand(37);
+    const Ints small = generate<Ints>([]() { return std::rand() % 1000; }, 100000);
+    const Ints xs = generate<Ints>([]() { return std::rand() % 1000; }, 10000000);
+    auto check_sum = [](const Ints& ys) { return static_cast<std::size_t>(std::accumulate(ys.begin(), ys.end(), 0ll)); };
+
+    for (std::size_t w : {std::size_t(10), std::size_t(100)})
+    {
+        const std::string wStr = " window " + show(w) + " of 100k";
+        run_timed([&]() { return check_sum(transform(sum<Ints>, infixes<Intss>(w, small))); }, 1, "FunctionalPlus::infixes + sum" + wStr);
+        run_timed([&]() { return check_sum(transform(minimum<Ints>, infixes<Intss>(w, small))); }, 1, "FunctionalPlus::infixes + minimum" + wStr);
+    }
+    for (std::size_t w : {std::size_t(10), std::size_t(1000), std::size_t(100000)})
+    {
+        const std::string wStr = " window " + show(w) + " of 10M";
+        run_timed([&]() { return check_sum(rolling_sum(w, xs)); }, 1, "FunctionalPlus::rolling_sum" + wStr);
+        run_timed([&]() { return check_sum(rolling_min(w, xs)); }, 1, "FunctionalPlus::rolling_min" + wStr);
+        run_timed([&]() { return check_sum(rolling_max(w, xs)); }, 1, "FunctionalPlus::rolling_max" + wStr);
+    }
+}
+
+void Test_example_ScanLeft_performance()
+{
+    using namespace fplus;
+    typedef std::vector<int> Ints;
+    const Ints xs = generate_by_idx<Ints>(
+        [](std::size_t i) { return static_cast<int>(i % 7); }, 20000000);
+    auto add = [](int acc, int x) { return acc + x; };
+    auto last_value = [](const Ints& ys) { return static_cast<std::size_t>(ys.back()); };
+
+    run_timed([&]() { return last_value(scan_left(add, 0, xs)); }, 1, "FunctionalPlus::scan_left 20M ints");
+    run_timed([&]() { return last_value(scan_left_parallelly(add, 0, xs)); }, 1, "FunctionalPlus::scan_left_parallelly 20M ints");
+    run_timed([&]() { return last_value(scan_left_parallelly(std::plus<int>(), 0, xs)); }, 1, "FunctionalPlus::scan_left_parallelly std::plus 20M ints");
+    for (std::size_t threadCount : {1, 2, 4})
+    {
+        work_stealing_pool pool(threadCount);
+        Ints ys(xs.size());
+        run_timed([&]()
+        {
+            return static_cast<std::size_t>(scan_left_blocks_parallelly(
+                pool, add, 0, xs.begin(), xs.size(), ys.begin(), true));
+        }, 1, "FunctionalPlus::scan_left_blocks_parallelly 20M ints " + show(threadCount) + " threads");
+        run_timed([&]()
+        {
+            return static_cast<std::size_t>(scan_left_blocks_parallelly(
+                pool, std::plus<int>(), 0, xs.begin(), xs.size(), ys.begin(), true));
+        }, 1, "FunctionalPlus::scan_left_blocks_parallelly std::plus 20M ints " + show(threadCount) + " threads");
+    }
+}
+
+void Test_example_SmallVector_performance()
+{
+    using namespace fplus;
+    typedef std::vector<int> Ints;
+    std::srand(41);
+    const Ints xs = generate<Ints>([]() { return std::rand() % 6; }, 5000000);
+    auto isZero = [](int x) { return x == 0; };
+    const std::string text = concat(generate<std::vector<std::string>>([]() -> std::string
+        { return std::string(static_cast<std::size_t>(std::rand() % 12 + 1), 'x') + " "; }, 1000000));
+
+    auto run_counting_allocations = [](auto f, const std::string& name)
+    {
+        const std::size_t allocationsBefore = heap_allocation_count;
+        run_timed(f, 1, name);
+        std::cout << name << " heap allocations: "
+            << heap_allocation_count - allocationsBefore << "\n";
+    };
+    run_counting_allocations([&]() { return size_of_cont(
+        split_by<decltype(isZero), Ints, std::vector<Ints>>(isZero, false, xs)); },
+        "FunctionalPlus::split_by 5M ints into std::vector");
+    run_counting_allocations([&]() { return size_of_cont(
+        split_by<decltype(isZero), Ints, std::vector<small_vector<int, 8>>>(isZero, false, xs)); },
+        "FunctionalPlus::split_by 5M ints into small_vector<int, 8>");
+    run_counting_allocations([&]() { return size_of_cont(
+        group_on<decltype(isZero), Ints, std::vector<Ints>>(isZero, xs)); },
+        "FunctionalPlus::group_on 5M ints into std::vector");
+    run_counting_allocations([&]() { return size_of_cont(
+        group_on<decltype(isZero), Ints, std::vector<small_vector<int, 8>>>(isZero, xs)); },
+        "FunctionalPlus::group_on 5M ints into small_vector<int, 8>");
+    auto isSpace = [](char c) { return c == ' '; };
+    run_counting_allocations([&]() { return size_of_cont(
+        split_by<decltype(isSpace), std::string, std::vector<std::string>>(isSpace, false, text)); },
+        "FunctionalPlus::split_by 1M words into std::string");
+    run_counting_allocations([&]() { return size_of_cont(
+        split_by<decltype(isSpace), std::string, std::vector<std::vector<char>>>(isSpace, false, text)); },
+        "FunctionalPlus::split_by 1M words into std::vector<char>");
+    run_counting_allocations([&]() { return size_of_cont(
+        split_by<decltype(isSpace), std::string, std::vector<small_vector<char, 16>>>(isSpace, false, text)); },
+        "FunctionalPlus::split_by 1M words into small_vector<char, 16>");
+}
+
+void Test_example_StringPool_performance()
+{
+    using namespace fplus;
+    typedef std::vector<std::string> Strings;
+    std::srand(43);
+    const Strings hosts = generate_by_idx<Strings>([](std::size_t i) { return "host" + show(i); }, 50);
+    const Strings verbs = {"GET", "POST", "PUT", "DELETE"};
+    const Strings levels = {"DEBUG", "INFO", "WARNING", "ERROR"};
+    const Strings paths = {"api users", "api orders", "static main js", "healthcheck"};
+    auto pick = [](const Strings& xs) -> const std::string& { return xs[static_cast<std::size_t>(std::rand()) % xs.size()]; };
+    const std::string corpus = concat(generate<Strings>([&]() -> std::string
+        { return pick(hosts) + " " + pick(verbs) + " " + pick(levels) + " " + pick(paths) + "\n"; }, 200000));
+
+    std::size_t wordsMemory = 0;
+    run_timed([&]()
+    {
+        const auto words = split_words<std::string, Strings>(corpus);
+        wordsMemory = words.capacity() * sizeof(std::string);
+        for (const auto& word : words)
+            wordsMemory += word.capacity() > 15 ? word.capacity() + 1 : 0;
+        return count_occurrences(words).size();
+    }, 1, "FunctionalPlus::split_words + count_occurrences 1.2M words");
+    std::cout << "std::string words memory: " << wordsMemory << " bytes\n";
+
+    std::size_t idsMemory = 0;
+    run_timed([&]()
+    {
+        string_pool pool;
+        const auto ids = split_words_interned(pool, corpus);
+        idsMemory = ids.capacity() * sizeof(string_pool::id_type) + pool.memory_usage();
+        return count_occurrences(ids).size();
+    }, 1, "FunctionalPlus::split_words_interned + count_occurrences 1.2M words");
+    std::cout << "interned words memory: " << idsMemory << " bytes\n";
+
+    run_timed([&]()
+    {
+        string_pool pool;
+        return size_of_cont(split_lines_interned(pool, corpus, false)) + pool.size();
+    }, 1, "FunctionalPlus::split_lines_interned 200k lines");
+    run_timed([&]()
+    {
+        return size_of_cont(split_lines<std::string, Strings>(corpus, false));
+    }, 1, "FunctionalPlus::split_lines 200k lines");
+}
+
+void Test_example_StringTools_performance()
+{
+    using namespace fplus;
+    typedef std::vector<std::string> Strings;
+    std::srand(44);
+    const Strings words = {"  lorem", "ipsum,", "Dolor", "sit", "AMET", "-", "42\t", "consectetur\n", "elit.\r\n"};
+    const std::string text = concat(generate<Strings>([&]()
+        { return words[static_cast<std::size_t>(std::rand()) % words.size()] + " "; }, 4000000));
+    // bytes is the number of input bytes f reads in total.
+    auto run_throughput = [](auto f, std::size_t bytes, const std::string& name)
+    {
+        const auto startTime = std::chrono::steady_clock::now();
+        const std::size_t check = f();
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - startTime;
+        std::cout << name << " (check: " << check << "), "
+            << static_cast<double>(bytes) / elapsed.count() / 1e9 << " GB/s\n";
+    };
+
+    auto isNoLetterOrDigit = [](char c) { return !is_letter_or_digit<std::string>(c); };
+    run_throughput([&]()
+    {
+        return size_of_cont(split_by<decltype(isNoLetterOrDigit), std::string, Strings>(isNoLetterOrDigit, false, text));
+    }, text.size(), "FunctionalPlus::split_by(!is_letter_or_digit) " + show(text.size() / 1000000) + " MB");
+    run_throughput([&]()
+    {
+        return size_of_cont(split_words<std::string, Strings>(text));
+    }, text.size(), "FunctionalPlus::split_words " + show(text.size() / 1000000) + " MB");
+    run_throughput([&]()
+    {
+        return size_of_cont(split_by<decltype(&is_line_break<std::string>), std::string, Strings>(
+            is_line_break<std::string>, false, clean_newlines(text)));
+    }, text.size(), "FunctionalPlus::split_by(is_line_break) + clean_newlines");
+    run_throughput([&]()
+    {
+        return size_of_cont(split_lines<std::string, Strings>(text, false));
+    }, text.size(), "FunctionalPlus::split_lines");
+    const std::string padded = std::string(1000000, ' ') + text + std::string(1000000, '\n');
+    run_throughput([&]()
+    {
+        return size_of_cont(trim(is_whitespace<std::string>, padded));
+    }, padded.size(), "FunctionalPlus::trim(is_whitespace)");
+    run_throughput([&]()
+    {
+        return size_of_cont(trim_whitespace(padded));
+    }, padded.size(), "FunctionalPlus::trim_whitespace");
+    run_throughput([&]()
+    {
+        return size_of_cont(to_upper_case(text)) + size_of_cont(to_lower_case(text));
+    }, 2 * text.size(), "FunctionalPlus::to_upper_case + to_lower_case");
+}
+
 void Test_example_SameOldSameOld()
 {
     std::list<std::string> things = {"same old", "same old"};
@@ -842,6 +3107,74 @@ int main()
     Test_ContainerTools();
     std::cout << "ContainerTools OK." << std::endl;
 
+    std::cout << "Testing FixedSizeContainers." << std::endl;
+    Test_FixedSizeContainers();
+    std::cout << "FixedSizeContainers OK." << std::endl;
+
+    std::cout << "Testing RadixSort." << std::endl;
+    Test_RadixSort();
+    std::cout << "RadixSort OK." << std::endl;
+
+    std::cout << "Testing Memoize." << std::endl;
+    Test_Memoize();
+    std::cout << "Memoize OK." << std::endl;
+
+    std::cout << "Testing Pipeline." << std::endl;
+    Test_Pipeline();
+    std::cout << "Pipeline OK." << std::endl;
+
+    std::cout << "Testing Parallel." << std::endl;
+    Test_Parallel();
+    std::cout << "Parallel OK." << std::endl;
+
+    std::cout << "Testing Aggregate." << std::endl;
+    Test_Aggregate();
+    std::cout << "Aggregate OK." << std::endl;
+
+    std::cout << "Testing Joins." << std::endl;
+    Test_Joins();
+    std::cout << "Joins OK." << std::endl;
+
+    std::cout << "Testing Sets." << std::endl;
+    Test_Sets();
+    std::cout << "Sets OK." << std::endl;
+
+    std::cout << "Testing FlatMaps." << std::endl;
+    Test_FlatMaps();
+    std::cout << "FlatMaps OK." << std::endl;
+
+    std::cout << "Testing SoaVector." << std::endl;
+    Test_SoaVector();
+    std::cout << "SoaVector OK." << std::endl;
+
+    std::cout << "Testing Bitvector." << std::endl;
+    Test_Bitvector();
+    std::cout << "Bitvector OK." << std::endl;
+
+    std::cout << "Testing TopK." << std::endl;
+    Test_TopK();
+    std::cout << "TopK OK." << std::endl;
+
+    std::cout << "Testing Rolling." << std::endl;
+    Test_Rolling();
+    std::cout << "Rolling OK." << std::endl;
+
+    std::cout << "Testing Profiling." << std::endl;
+    Test_Profiling();
+    std::cout << "Profiling OK." << std::endl;
+
+    std::cout << "Testing CopyAudit." << std::endl;
+    Test_CopyAudit();
+    std::cout << "CopyAudit OK." << std::endl;
+
+    std::cout << "Testing StringPool." << std::endl;
+    Test_StringPool();
+    std::cout << "StringPool OK." << std::endl;
+
+    std::cout << "Testing Serialization." << std::endl;
+    Test_Serialization();
+    std::cout << "Serialization OK." << std::endl;
+
     std::cout << "Testing StringTools." << std::endl;
     Test_StringTools();
     std::cout << "StringTools OK." << std::endl;
@@ -849,6 +3182,27 @@ int main()
     std::cout << "Testing Applications." << std::endl;
     Test_example_KeepIf();
     Test_example_KeepIf_performance();
+    Test_example_ShowCont_performance();
+    Test_example_Deserialize_performance();
+    Test_example_Memoize_performance();
+    Test_example_TransformParallelly_performance();
+    Test_example_SortRadix_performance();
+    Test_example_SortOn_performance();
+    Test_example_GroupFoldOn_performance();
+    Test_example_Joins_performance();
+    Test_example_Sets_performance();
+    Test_example_SortedLookup_performance();
+    Test_example_FlatMap_performance();
+    Test_example_MapTransforms_performance();
+    Test_example_StringKeyLookup_performance();
+    Test_example_SoaVector_performance();
+    Test_example_Bitvector_performance();
+    Test_example_TopK_performance();
+    Test_example_Rolling_performance();
+    Test_example_ScanLeft_performance();
+    Test_example_SmallVector_performance();
+    Test_example_StringPool_performance();
+    Test_example_StringTools_performance();
     Test_example_SameOldSameOld();
     Test_example_IInTeam();
     Test_example_AllIsCalmAndBright();